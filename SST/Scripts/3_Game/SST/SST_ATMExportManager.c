@@ -15,6 +15,7 @@
 // Represents a single inventory item (recursive attachments/cargo).
 class SST_InventoryItemData
 {
+	string itemId;             // Stable id: persistent ID "b1-b2-b3-b4", or "n<low>-<high>" network ID if not yet persisted
 	string className;          // Item type/class name (e.g., "AKM", "Apple")
 	string displayName;        // Human-readable name
 	float health;              // Current health (0-100%)
@@ -54,13 +55,15 @@ class SST_InventoryEventType
 	static const string REMOVED = "REMOVED";           // Item removed from player (given, stored, etc.)
 	static const string PICKED_UP = "PICKED_UP";       // Item picked up from ground
 	static const string ADDED = "ADDED";               // Item added to player inventory
+	static const string SUPPRESSED = "SUPPRESSED";     // Events dropped by the rate cap (count = how many)
 }
 
 // Single inventory event entry
 class SST_InventoryEventData
 {
 	string timestamp;
-	string eventType;          // DROPPED, REMOVED, PICKED_UP, ADDED
+	int timestampUnix;         // Same time as epoch seconds (SST_Clock.NowUnix)
+	string eventType;          // DROPPED, REMOVED, PICKED_UP, ADDED, SUPPRESSED
 	string playerName;
 	string playerId;           // Steam64
 	string itemClassName;
@@ -68,6 +71,7 @@ class SST_InventoryEventData
 	float itemHealth;
 	float itemQuantity;
 	vector position;           // World position where event occurred
+	int count = 1;             // Events merged into this one by SST_InventoryEventFilter
 }
 
 // Log file structure for a player's events
@@ -94,6 +98,7 @@ class SST_PlayerLifeEventType
 class SST_PlayerLifeEventData
 {
 	string timestamp;
+	int timestampUnix;         // Same time as epoch seconds (SST_Clock.NowUnix)
 	string eventType;
 	string playerName;
 	string playerId;
@@ -130,6 +135,40 @@ class SST_ItemGrantQueue
 	ref array<ref SST_ItemGrantRequest> requests = new array<ref SST_ItemGrantRequest>();
 }
 
+// One item of a kit; attachments and cargo are created on/in it
+class SST_KitItem
+{
+	string itemClassName;
+	int quantity;              // Quantity (for stackable items) or 1
+	float health = -1;         // Health percentage (0-100), -1 for default
+	ref array<ref SST_KitItem> attachments;
+	ref array<ref SST_KitItem> cargo;
+}
+
+// Outcome of a kit grant for one player
+class SST_KitGrantPlayerResult
+{
+	string playerId;
+	string playerName;
+	string result;             // "SUCCESS", "PARTIAL", "PLAYER_NOT_FOUND"
+	int granted;               // Items created (attachments and cargo included)
+	int dropped;               // Top-level items spawned at the player's feet (inventory full)
+	ref array<string> failed = new array<string>();  // "ClassName:ERROR" per item not created
+}
+
+// Kit/loadout grant: several items, several players, one request
+class SST_KitGrantRequest
+{
+	string requestId;          // Unique request ID
+	string kitName;            // Shown in the player notification
+	ref array<string> playerIds;       // Steam64 IDs, or ["all"] for every online player
+	ref array<ref SST_KitItem> items;
+	bool processed;            // Set to true after processing
+	string result;             // "SUCCESS", "PARTIAL", "FAILED" or an error code
+	ref array<string> invalidClasses = new array<string>();   // Kit classes missing from config (skipped)
+	ref array<ref SST_KitGrantPlayerResult> players = new array<ref SST_KitGrantPlayerResult>();
+}
+
 // ============================================================================
 // Item Delete API Data Classes
 // ============================================================================
@@ -140,7 +179,8 @@ class SST_ItemDeleteRequest
 	string requestId;          // Unique request ID
 	string playerId;           // Steam64 ID of player
 	string itemClassName;      // Item class name to delete
-	string itemPath;           // Path to item (e.g., "0.cargo.2" = first slot, cargo, index 2)
+	string itemPath;           // Path to item (e.g., "0.cargo.2" = first slot, cargo, index 2), fallback when itemId is stale
+	string itemId;             // Stable item id from the inventory export (preferred)
 	int deleteCount;           // How many to delete (for stackables, 0 = all)
 	string requestedAt;        // When the request was made
 	bool processed;            // Set to true after processing
@@ -177,6 +217,40 @@ class SST_ServerItemList
 	ref array<ref SST_ServerItemEntry> items = new array<ref SST_ServerItemEntry>();
 }
 
+// One category shard of the item list (api/items/<shard>.json)
+class SST_ServerItemShard
+{
+	string generatedAt;
+	string category;
+	int itemCount;
+	ref array<ref SST_ServerItemEntry> items = new array<ref SST_ServerItemEntry>();
+}
+
+// Entry in api/items/index.json
+class SST_ServerItemIndexEntry
+{
+	string category;           // Category as used in SST_ServerItemEntry.category
+	string shard;              // Shard name (file is <shard>.json)
+	int itemCount;
+	string hash;               // Content hash of the shard, changes when the shard changes
+}
+
+// Small index of all category shards
+class SST_ServerItemIndex
+{
+	string generatedAt;
+	int itemCount;
+	ref array<ref SST_ServerItemIndexEntry> categories = new array<ref SST_ServerItemIndexEntry>();
+}
+
+// Written next to server_items.json; lets the exporter skip rebuilding an unchanged catalog
+class SST_ServerItemCatalogMeta
+{
+	string signature;          // Mod set signature the catalog was built for
+	int itemCount;
+	string generatedAt;
+}
+
 // ============================================================================
 // Online Player Tracking Data Classes
 // ============================================================================
@@ -199,12 +273,21 @@ class SST_OnlinePlayerData
 	float energy;              // Current food/energy level
 	bool isAlive;              // Is character alive
 	bool isUnconscious;        // Is character unconscious
+	bool inVehicle;            // In a vehicle (sampled more often)
 }
 
-// List of all tracked players (online and recently disconnected)
+// Players currently online (online_players.json)
 class SST_OnlinePlayersData
 {
 	string generatedAt;
 	int onlineCount;
 	ref array<ref SST_OnlinePlayerData> players = new array<ref SST_OnlinePlayerData>();
 }
+
+// Last known state of disconnected players (player_registry.json), bounded, oldest disconnect first
+class SST_PlayerRegistryData
+{
+	string generatedAt;
+	int playerCount;
+	ref array<ref SST_OnlinePlayerData> players = new array<ref SST_OnlinePlayerData>();
+}
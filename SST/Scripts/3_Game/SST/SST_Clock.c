@@ -0,0 +1,98 @@
+/**
+ * @file SST_Clock.c
+ * @brief Shared UTC clock for export and log timestamps.
+ *
+ * Every exporter and logger stamps its records with the current UTC time. The
+ * clock reads the date once per server frame and builds the ISO string once per
+ * second. Everything else in the frame gets the cached values.
+ *
+ * Two representations are exposed:
+ *
+ *   SST_Clock.Now()      "2025-01-15T14:03:27Z"  (ISO 8601, what the DTOs always had)
+ *   SST_Clock.NowUnix()  1736949807              (epoch seconds)
+ *
+ * DTOs carry the epoch value next to the string (timestamp + timestampUnix) so
+ * the API can sort and filter without parsing dates. Script ints are 32-bit, so
+ * the numeric value is in seconds; epoch milliseconds would overflow.
+ */
+
+class SST_Clock
+{
+	// GetGame().GetTime() of the frame the cache belongs to
+	protected static int s_FrameTime = -1;
+
+	// Time of day and GetTime() of the last full date read
+	protected static int s_Hour = -1;
+	protected static int s_Minute = -1;
+	protected static int s_Second = -1;
+	protected static int s_DateReadAt;
+
+	protected static string s_Iso;
+	protected static int s_Unix;
+
+	// ISO 8601 UTC timestamp, second resolution
+	static string Now()
+	{
+		Refresh();
+		return s_Iso;
+	}
+
+	// Seconds since 1970-01-01T00:00:00Z
+	static int NowUnix()
+	{
+		Refresh();
+		return s_Unix;
+	}
+
+	protected static void Refresh()
+	{
+		int frameTime = -1;
+		if (GetGame())
+			frameTime = GetGame().GetTime();
+
+		// Same frame: nothing can have changed that we want to report
+		if (frameTime != -1 && frameTime == s_FrameTime && s_Iso != "")
+			return;
+
+		s_FrameTime = frameTime;
+
+		int hour, minute, second;
+		GetHourMinuteSecondUTC(hour, minute, second);
+
+		// Same second as the last read (and less than a minute ago, so not the same time on another day)
+		if (s_Iso != "" && hour == s_Hour && minute == s_Minute && second == s_Second && frameTime - s_DateReadAt < 60000)
+			return;
+
+		int year, month, day;
+		GetYearMonthDayUTC(year, month, day);
+
+		s_Hour = hour;
+		s_Minute = minute;
+		s_Second = second;
+		s_DateReadAt = frameTime;
+
+		s_Iso = string.Format("%1-%2-%3T%4:%5:%6Z",
+			year.ToStringLen(4),
+			month.ToStringLen(2),
+			day.ToStringLen(2),
+			hour.ToStringLen(2),
+			minute.ToStringLen(2),
+			second.ToStringLen(2));
+
+		s_Unix = DaysFromCivil(year, month, day) * 86400 + hour * 3600 + minute * 60 + second;
+	}
+
+	// Days since 1970-01-01 for a proleptic Gregorian date (year >= 0)
+	static int DaysFromCivil(int year, int month, int day)
+	{
+		if (month <= 2)
+			year -= 1;
+
+		int era = year / 400;
+		int yearOfEra = year - era * 400;
+		int shiftedMonth = (month + 9) % 12; // March = 0
+		int dayOfYear = (153 * shiftedMonth + 2) / 5 + day - 1;
+		int dayOfEra = yearOfEra * 365 + yearOfEra / 4 - yearOfEra / 100 + dayOfYear;
+		return era * 146097 + dayOfEra - 719468;
+	}
+}
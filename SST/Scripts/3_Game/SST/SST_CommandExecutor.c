@@ -0,0 +1,275 @@
+/**
+ * @file SST_CommandExecutor.c
+ * @brief Per-tick budget for executing spooled API commands, with backlog metrics.
+ *
+ * The processors used to execute everything they claimed in their poll
+ * callback. A dashboard batch of 50 grants meant 50 spawns and 50
+ * notifications in one frame. Now a poll only claims files and hands them
+ * to the executor with Pull(). MissionServer.OnUpdate() then runs at most
+ * MAX_COMMANDS_PER_TICK commands or MAX_MS_PER_TICK ms of them per frame and
+ * carries the rest over to the next frame.
+ *
+ * Pull() only claims as many files as fit under MAX_BACKLOG_PER_QUEUE. The
+ * rest stay in the spool's incoming/ folder, where the API can still see them
+ * as pending.
+ *
+ * Every METRICS_INTERVAL ms, if anything changed, the backlog and wait times
+ * per queue are written to $profile:SST/api/command_metrics.json:
+ *
+ * - backlog:          claimed, waiting for a tick
+ * - incoming:         still in incoming/ at the last poll
+ * - avgQueueWaitSec:  API queued -> execution start (from the file name; includes poll delay)
+ * - avgBacklogWaitMs: claim -> execution start (the executor's own delay)
+ * - avgExecMs:        time spent executing one command
+ *
+ * On a clean shutdown, ReleaseBacklog() moves claimed files that never ran
+ * back to incoming/, so they are not reported as INTERRUPTED after the restart.
+ */
+
+// A processor that executes claimed spool files. ExecuteSpooled() must write
+// the result and call spool.Complete(fileName).
+class SST_CommandHandler : Managed
+{
+	void ExecuteSpooled(SST_CommandSpool spool, string fileName)
+	{
+	}
+}
+
+// One claimed request waiting for a tick
+class SST_CommandJob
+{
+	SST_CommandSpool spool;            // Weak: owned by its processor
+	SST_CommandHandler handler;        // Weak: processors are singletons
+	string queue;                      // Metrics key; kept here because the spool may be gone
+	string fileName;
+	int claimedAt;                     // GetGame().GetTime()
+	int queuedAtUnix;                  // From the file name, 0 if unknown
+}
+
+// Per-queue entry of command_metrics.json
+class SST_CommandQueueMetrics
+{
+	string queue;
+	int backlog;
+	int incoming;
+	int executed;                      // Since server start
+	float avgQueueWaitSec;             // Moving average
+	float maxQueueWaitSec;             // Since the previous export
+	float avgBacklogWaitMs;
+	float maxBacklogWaitMs;
+	float avgExecMs;
+	float maxExecMs;
+}
+
+class SST_CommandMetricsExport
+{
+	string generatedAt;
+	int backlog;
+	int maxCommandsPerTick;
+	float maxMsPerTick;
+	int ticksOverBudget;               // Ticks that carried work over, since the previous export
+	ref array<ref SST_CommandQueueMetrics> queues = new array<ref SST_CommandQueueMetrics>();
+}
+
+class SST_CommandExecutor
+{
+	protected static ref SST_CommandExecutor s_Instance;
+
+	static const string METRICS_FILE = "$profile:SST/api/command_metrics.json";
+	static const int MAX_COMMANDS_PER_TICK = 4;
+	static const float MAX_MS_PER_TICK = 3.0;
+	static const int MAX_BACKLOG_PER_QUEUE = 50;    // Claimed but not executed, per queue
+	static const int METRICS_INTERVAL = 10000;      // ms between metrics exports (only when changed)
+	static const float AVERAGE_WEIGHT = 0.1;        // Weight of a new sample in the moving averages
+
+	protected ref array<ref SST_CommandJob> m_Backlog;
+	protected ref map<string, ref SST_CommandQueueMetrics> m_Metrics;
+
+	protected int m_TicksOverBudget;
+	protected int m_LastExportAt;
+	protected bool m_MetricsDirty;
+
+	void SST_CommandExecutor()
+	{
+		m_Backlog = new array<ref SST_CommandJob>();
+		m_Metrics = new map<string, ref SST_CommandQueueMetrics>();
+	}
+
+	static SST_CommandExecutor GetInstance()
+	{
+		if (!s_Instance)
+			s_Instance = new SST_CommandExecutor();
+		return s_Instance;
+	}
+
+	// Claim what fits in the queue's backlog; returns the number of files claimed
+	int Pull(SST_CommandSpool spool, SST_CommandHandler handler)
+	{
+		SST_CommandQueueMetrics metrics = GetQueueMetrics(spool.GetQueue());
+		int room = MAX_BACKLOG_PER_QUEUE - metrics.backlog;
+
+		array<string> claimed = new array<string>();
+		if (room > 0)
+			spool.Claim(claimed, room);
+
+		int incoming = spool.GetIncomingCount();
+		if (metrics.incoming != incoming)
+		{
+			metrics.incoming = incoming;
+			m_MetricsDirty = true;
+		}
+
+		int now = GetGame().GetTime();
+		foreach (string fileName : claimed)
+		{
+			SST_CommandJob job = new SST_CommandJob();
+			job.spool = spool;
+			job.handler = handler;
+			job.queue = spool.GetQueue();
+			job.fileName = fileName;
+			job.claimedAt = now;
+			job.queuedAtUnix = SST_CommandSpool.GetQueuedAtUnix(fileName);
+			m_Backlog.Insert(job);
+			metrics.backlog++;
+		}
+
+		if (claimed.Count() > 0)
+			m_MetricsDirty = true;
+
+		return claimed.Count();
+	}
+
+	int GetBacklog()
+	{
+		return m_Backlog.Count();
+	}
+
+	// Called once per server frame from MissionServer.OnUpdate
+	void OnUpdate(float timeslice)
+	{
+		if (m_Backlog.Count() > 0)
+			RunBudget();
+
+		if (m_MetricsDirty && GetGame().GetTime() - m_LastExportAt >= METRICS_INTERVAL)
+			ExportMetrics();
+	}
+
+	// Shutdown: hand claimed files that never ran back to incoming/
+	void ReleaseBacklog()
+	{
+		foreach (SST_CommandJob job : m_Backlog)
+		{
+			if (job.spool)
+				job.spool.Unclaim(job.fileName);
+		}
+
+		m_Backlog.Clear();
+		for (int i = 0; i < m_Metrics.Count(); i++)
+			m_Metrics.GetElement(i).backlog = 0;
+	}
+
+	protected void RunBudget()
+	{
+		int startTicks = TickCount(0);
+		int ran = 0;
+
+		while (ran < m_Backlog.Count())
+		{
+			if (ran > 0 && (ran >= MAX_COMMANDS_PER_TICK || TickCount(startTicks) / SST_FrameScheduler.TICKS_PER_MS >= MAX_MS_PER_TICK))
+				break;
+
+			Execute(m_Backlog[ran]);
+			ran++;
+		}
+
+		// One block removal instead of RemoveOrdered(0) per command
+		if (ran >= m_Backlog.Count())
+		{
+			m_Backlog.Clear();
+			return;
+		}
+
+		m_TicksOverBudget++;
+		ref array<ref SST_CommandJob> remaining = new array<ref SST_CommandJob>();
+		for (int i = ran; i < m_Backlog.Count(); i++)
+			remaining.Insert(m_Backlog[i]);
+		m_Backlog = remaining;
+	}
+
+	protected void Execute(SST_CommandJob job)
+	{
+		SST_CommandQueueMetrics metrics = GetQueueMetrics(job.queue);
+		metrics.backlog--;
+		m_MetricsDirty = true;
+
+		// Left in processing/ if its processor is gone; reported as INTERRUPTED after the next restart
+		if (!job.spool || !job.handler)
+			return;
+
+		float backlogWaitMs = GetGame().GetTime() - job.claimedAt;
+		float queueWaitSec = 0;
+		if (job.queuedAtUnix > 0)
+			queueWaitSec = Math.Max(0, SST_Clock.NowUnix() - job.queuedAtUnix);
+
+		int startTicks = TickCount(0);
+		job.handler.ExecuteSpooled(job.spool, job.fileName);
+		float execMs = TickCount(startTicks) / SST_FrameScheduler.TICKS_PER_MS;
+
+		metrics.avgQueueWaitSec = Average(metrics.avgQueueWaitSec, queueWaitSec, metrics.executed);
+		metrics.avgBacklogWaitMs = Average(metrics.avgBacklogWaitMs, backlogWaitMs, metrics.executed);
+		metrics.avgExecMs = Average(metrics.avgExecMs, execMs, metrics.executed);
+		metrics.maxQueueWaitSec = Math.Max(metrics.maxQueueWaitSec, queueWaitSec);
+		metrics.maxBacklogWaitMs = Math.Max(metrics.maxBacklogWaitMs, backlogWaitMs);
+		metrics.maxExecMs = Math.Max(metrics.maxExecMs, execMs);
+		metrics.executed++;
+	}
+
+	protected static float Average(float average, float sample, int samples)
+	{
+		if (samples == 0)
+			return sample;
+		return average + (sample - average) * AVERAGE_WEIGHT;
+	}
+
+	protected SST_CommandQueueMetrics GetQueueMetrics(string queue)
+	{
+		SST_CommandQueueMetrics metrics = m_Metrics.Get(queue);
+		if (!metrics)
+		{
+			metrics = new SST_CommandQueueMetrics();
+			metrics.queue = queue;
+			m_Metrics.Set(queue, metrics);
+		}
+		return metrics;
+	}
+
+	protected void ExportMetrics()
+	{
+		m_LastExportAt = GetGame().GetTime();
+		m_MetricsDirty = false;
+
+		SST_CommandMetricsExport export = new SST_CommandMetricsExport();
+		export.generatedAt = SST_Clock.Now();
+		export.backlog = m_Backlog.Count();
+		export.maxCommandsPerTick = MAX_COMMANDS_PER_TICK;
+		export.maxMsPerTick = MAX_MS_PER_TICK;
+		export.ticksOverBudget = m_TicksOverBudget;
+
+		for (int i = 0; i < m_Metrics.Count(); i++)
+			export.queues.Insert(m_Metrics.GetElement(i));
+
+		string errorMsg;
+		if (!JsonFileLoader<SST_CommandMetricsExport>.SaveFile(METRICS_FILE, export, errorMsg))
+			Print("[SST] ERROR: Failed to save command metrics: " + errorMsg);
+
+		// Maxima cover one export interval
+		m_TicksOverBudget = 0;
+		for (int j = 0; j < m_Metrics.Count(); j++)
+		{
+			SST_CommandQueueMetrics metrics = m_Metrics.GetElement(j);
+			metrics.maxQueueWaitSec = 0;
+			metrics.maxBacklogWaitMs = 0;
+			metrics.maxExecMs = 0;
+		}
+	}
+}
@@ -0,0 +1,273 @@
+/**
+ * @file SST_CommandSpool.c
+ * @brief Spool-directory transport for API -> server command queues.
+ *
+ * The original queues were one JSON array file per feature. The API
+ * read-modified-wrote it (over FTP/SFTP), and the mod reparsed it on every
+ * poll and then overwrote it with an empty queue. A request the API appended
+ * between those two steps was lost.
+ *
+ * A spool is a folder per queue:
+ *
+ *   $profile:SST/api/spool/<queue>/incoming/     <- API drops one file per request
+ *   $profile:SST/api/spool/<queue>/processing/   <- claimed by the mod
+ *
+ * The API writes "<name>.json.tmp" and renames it to "<name>.json", so the mod
+ * never sees a partial file. File names start with the API's millisecond
+ * timestamp, and sorting them gives arrival order.
+ *
+ * Claim() moves every incoming file to processing/. Script has no rename, so
+ * the move is a copy followed by a delete. The processor executes the request
+ * and passes its result to Complete(), which appends it to the queue's
+ * SST_ResultsJournal and deletes the claimed file. An empty poll costs one
+ * directory listing.
+ *
+ * Files still in processing/ at startup were claimed by a session that did not
+ * finish them. Claim() returns them first and IsRecovered() flags them, so
+ * the processor can report them instead of executing them twice.
+ *
+ * Result files left in the old results/ folder are moved into the journal
+ * when the spool is created.
+ */
+
+class SST_CommandSpool
+{
+	static const string SPOOL_ROOT = "$profile:SST/api/spool/";
+	static const int MAX_CLAIM = 50;               // Requests claimed per poll; the rest wait for the next one
+
+	protected string m_Queue;
+	protected string m_Folder;
+
+	// Names files queued from script; see NewIncomingPath()
+	protected static int s_LocalCount;
+
+	// Files found in processing/ at startup
+	protected ref map<string, bool> m_Recovered;
+
+	protected ref SST_ResultsJournal m_Results;
+
+	// Files left in incoming/ by the last Claim()
+	protected int m_IncomingCount;
+
+	void SST_CommandSpool(string queue)
+	{
+		m_Queue = queue;
+		m_Folder = SPOOL_ROOT + queue + "/";
+		m_Recovered = new map<string, bool>();
+
+		if (!FileExist("$profile:SST"))
+			MakeDirectory("$profile:SST");
+		if (!FileExist("$profile:SST/api"))
+			MakeDirectory("$profile:SST/api");
+		if (!FileExist(SPOOL_ROOT))
+			MakeDirectory(SPOOL_ROOT);
+		if (!FileExist(m_Folder))
+			MakeDirectory(m_Folder);
+		if (!FileExist(GetIncomingFolder()))
+			MakeDirectory(GetIncomingFolder());
+		if (!FileExist(GetProcessingFolder()))
+			MakeDirectory(GetProcessingFolder());
+
+		m_Results = new SST_ResultsJournal(queue);
+		ImportResultFiles();
+
+		array<string> leftovers = new array<string>();
+		ListJsonFiles(GetProcessingFolder(), leftovers);
+		foreach (string leftover : leftovers)
+			m_Recovered.Set(leftover, true);
+
+		if (leftovers.Count() > 0)
+			Print("[SST] Spool " + m_Queue + ": " + leftovers.Count().ToString() + " requests were interrupted by a restart");
+	}
+
+	string GetQueue()
+	{
+		return m_Queue;
+	}
+
+	string GetIncomingFolder()
+	{
+		return m_Folder + "incoming/";
+	}
+
+	string GetProcessingFolder()
+	{
+		return m_Folder + "processing/";
+	}
+
+	// Results of this queue; legacy queue files append to it directly
+	SST_ResultsJournal GetResults()
+	{
+		return m_Results;
+	}
+
+	// Move up to maxCount waiting requests to processing/ and return their file names, oldest first
+	int Claim(notnull array<string> claimed, int maxCount = MAX_CLAIM)
+	{
+		claimed.Clear();
+
+		// Interrupted requests from the previous session first; each is returned once
+		for (int i = 0; i < m_Recovered.Count() && claimed.Count() < maxCount; i++)
+		{
+			if (!m_Recovered.GetElement(i))
+				continue;
+
+			claimed.Insert(m_Recovered.GetKey(i));
+			m_Recovered.Set(m_Recovered.GetKey(i), false);
+		}
+
+		array<string> incoming = new array<string>();
+		ListJsonFiles(GetIncomingFolder(), incoming);
+		incoming.Sort();
+		m_IncomingCount = incoming.Count();
+
+		foreach (string fileName : incoming)
+		{
+			if (claimed.Count() >= maxCount)
+				break;
+
+			string source = GetIncomingFolder() + fileName;
+			string target = GetProcessingFolder() + fileName;
+			if (!CopyFile(source, target))
+			{
+				Print("[SST] WARNING: Spool " + m_Queue + ": could not claim " + fileName);
+				continue;
+			}
+
+			if (!DeleteFile(source))
+			{
+				// Leave it for the next poll rather than running it twice
+				DeleteFile(target);
+				continue;
+			}
+
+			claimed.Insert(fileName);
+			m_IncomingCount--;
+		}
+
+		return claimed.Count();
+	}
+
+	// Put a claimed request that was never executed back into incoming/
+	void Unclaim(string fileName)
+	{
+		// Recovered requests may have run already: they stay recovered
+		if (m_Recovered.Contains(fileName))
+			return;
+
+		string source = GetProcessingFolder() + fileName;
+		if (CopyFile(source, GetIncomingFolder() + fileName))
+			DeleteFile(source);
+	}
+
+	// Files waiting in incoming/ after the last Claim()
+	int GetIncomingCount()
+	{
+		return m_IncomingCount;
+	}
+
+	// Unix seconds from the "<unix ms>-..." file name prefix, 0 if there is none
+	static int GetQueuedAtUnix(string fileName)
+	{
+		if (fileName.Length() < 14 || fileName.Get(13) != "-")
+			return 0;
+
+		return fileName.Substring(0, 10).ToInt();
+	}
+
+	// requestId part of a "<unix ms>-<requestId>.json" file name
+	static string GetRequestId(string fileName)
+	{
+		string name = fileName;
+		if (name.Length() > 5 && name.Substring(name.Length() - 5, 5) == ".json")
+			name = name.Substring(0, name.Length() - 5);
+
+		if (name.Length() < 14 || name.Get(13) != "-")
+			return name;
+
+		return name.Substring(14, name.Length() - 14);
+	}
+
+	// Path for a request queued from script (debug tools), named to sort with the API's
+	// "<unix ms>-<requestId>.json" files. requestId must be usable in a file name.
+	string NewIncomingPath(string requestId)
+	{
+		s_LocalCount = (s_LocalCount + 1) % 1000;
+		return GetIncomingFolder() + SST_Clock.NowUnix().ToString() + s_LocalCount.ToStringLen(3) + "-" + requestId + ".json";
+	}
+
+	bool IsRecovered(string fileName)
+	{
+		return m_Recovered.Contains(fileName);
+	}
+
+	string GetProcessingPath(string fileName)
+	{
+		return GetProcessingFolder() + fileName;
+	}
+
+	// Journal the result (SST_ResultJson<T>.Write of the annotated request) and drop the claimed file
+	void Complete(string fileName, string resultJson)
+	{
+		m_Results.Append(GetRequestId(fileName), fileName, resultJson);
+
+		DeleteFile(GetProcessingFolder() + fileName);
+		m_Recovered.Remove(fileName);
+	}
+
+	// Result files written before the journal: append them oldest first, then delete them
+	protected void ImportResultFiles()
+	{
+		string folder = m_Folder + "results/";
+		if (!FileExist(folder))
+			return;
+
+		array<string> results = new array<string>();
+		ListJsonFiles(folder, results);
+		results.Sort();
+
+		foreach (string fileName : results)
+		{
+			string json = ReadCompact(folder + fileName);
+			if (json == "" || m_Results.Append(GetRequestId(fileName), fileName, json))
+				DeleteFile(folder + fileName);
+		}
+
+		if (results.Count() > 0)
+			Print("[SST] Spool " + m_Queue + ": moved " + results.Count().ToString() + " result files into the results journal");
+	}
+
+	// A pretty-printed JSON file as one line
+	protected static string ReadCompact(string path)
+	{
+		FileHandle file = OpenFile(path, FileMode.READ);
+		if (!file)
+			return "";
+
+		string json = "";
+		string line;
+		while (FGets(file, line) >= 0)
+			json += line.Trim();
+		CloseFile(file);
+		return json;
+	}
+
+	protected static void ListJsonFiles(string folder, notnull array<string> files)
+	{
+		string fileName;
+		FileAttr fileAttr;
+		FindFileHandle handle = FindFile(folder + "*.json", fileName, fileAttr, 0);
+		if (!handle)
+			return;
+
+		bool found = true;
+		while (found)
+		{
+			if (!(fileAttr & FileAttr.DIRECTORY))
+				files.Insert(fileName);
+
+			found = FindNextFile(handle, fileName, fileAttr);
+		}
+		CloseFindFile(handle);
+	}
+}
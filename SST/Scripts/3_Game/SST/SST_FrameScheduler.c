@@ -0,0 +1,127 @@
+/**
+ * @file SST_FrameScheduler.c
+ * @brief Frame-budgeted work queue for per-player export work.
+ *
+ * Producers (the inventory exporter, the online player tracker) enqueue one
+ * small task per player instead of doing the whole batch in a single CallLater
+ * callback. MissionServer.OnUpdate drains the queue a few tasks at a time, bounded
+ * by a per-frame task count and a per-frame time budget, so a full server never
+ * takes the whole export hit in one frame.
+ */
+
+// One unit of deferred work. Keep Run() small: the scheduler only checks the
+// time budget between tasks, never inside one.
+class SST_SchedulerTask : Managed
+{
+	void Run()
+	{
+	}
+}
+
+class SST_FrameScheduler
+{
+	protected static ref SST_FrameScheduler s_Instance;
+
+	static const int DEFAULT_MAX_TASKS_PER_FRAME = 4;
+	static const float DEFAULT_MAX_MS_PER_FRAME = 2.0;
+
+	// TickCount() resolution: 10000 ticks per millisecond
+	static const float TICKS_PER_MS = 10000.0;
+
+	// Compact the queue once this many finished tasks sit in front of the head
+	protected static const int COMPACT_THRESHOLD = 64;
+
+	protected ref array<ref SST_SchedulerTask> m_Queue;
+	protected int m_Head;
+
+	protected int m_MaxTasksPerFrame;
+	protected float m_MaxMsPerFrame;
+
+	void SST_FrameScheduler()
+	{
+		m_Queue = new array<ref SST_SchedulerTask>();
+		m_Head = 0;
+		m_MaxTasksPerFrame = DEFAULT_MAX_TASKS_PER_FRAME;
+		m_MaxMsPerFrame = DEFAULT_MAX_MS_PER_FRAME;
+	}
+
+	static SST_FrameScheduler GetInstance()
+	{
+		if (!s_Instance)
+			s_Instance = new SST_FrameScheduler();
+		return s_Instance;
+	}
+
+	// Shortcut for producers
+	static void Enqueue(SST_SchedulerTask task)
+	{
+		if (!task)
+			return;
+
+		GetInstance().m_Queue.Insert(task);
+	}
+
+	// maxTasks <= 0 or maxMs <= 0 disables that limit; at least one task always runs per frame
+	void SetBudget(int maxTasksPerFrame, float maxMsPerFrame)
+	{
+		m_MaxTasksPerFrame = maxTasksPerFrame;
+		m_MaxMsPerFrame = maxMsPerFrame;
+	}
+
+	int GetPendingCount()
+	{
+		return m_Queue.Count() - m_Head;
+	}
+
+	// Called once per server frame from MissionServer.OnUpdate
+	void OnUpdate(float timeslice)
+	{
+		if (m_Head >= m_Queue.Count())
+			return;
+
+		int startTicks = TickCount(0);
+		int ran = 0;
+
+		while (m_Head < m_Queue.Count())
+		{
+			if (ran > 0)
+			{
+				if (m_MaxTasksPerFrame > 0 && ran >= m_MaxTasksPerFrame)
+					break;
+				if (m_MaxMsPerFrame > 0 && (TickCount(startTicks) / TICKS_PER_MS) >= m_MaxMsPerFrame)
+					break;
+			}
+
+			// Release our reference before running so a task may safely enqueue follow-ups
+			SST_SchedulerTask task = m_Queue[m_Head];
+			m_Queue[m_Head] = null;
+			m_Head++;
+			ran++;
+
+			if (task)
+				task.Run();
+		}
+
+		Compact();
+	}
+
+	protected void Compact()
+	{
+		if (m_Head >= m_Queue.Count())
+		{
+			m_Queue.Clear();
+			m_Head = 0;
+			return;
+		}
+
+		if (m_Head < COMPACT_THRESHOLD)
+			return;
+
+		ref array<ref SST_SchedulerTask> remaining = new array<ref SST_SchedulerTask>();
+		for (int i = m_Head; i < m_Queue.Count(); i++)
+			remaining.Insert(m_Queue[i]);
+
+		m_Queue = remaining;
+		m_Head = 0;
+	}
+}
@@ -0,0 +1,287 @@
+/**
+ * @file SST_JsonExport.c
+ * @brief SST_JsonWriter serializers for the shared export DTOs.
+ *
+ * One static writer per DTO in SST_ATMExportManager.c that is written as a
+ * snapshot or an NDJSON history record. Field names and order mirror the DTO declarations so the output is
+ * interchangeable with JsonFileLoader's; keep both in sync when adding fields.
+ *
+ * Exporters get the writer from SST_SnapshotPublisher.Begin() and hand it back
+ * to Publish() once the DTO has been written.
+ */
+
+class SST_JsonExport
+{
+	// ------------------------------------------------------------------------
+	// Inventory export
+	// ------------------------------------------------------------------------
+
+	static void WriteInventoryItem(SST_JsonWriter writer, SST_InventoryItemData item)
+	{
+		if (!item)
+		{
+			writer.NullValue();
+			return;
+		}
+
+		writer.BeginObject();
+		writer.WriteString("itemId", item.itemId);
+		writer.WriteString("className", item.className);
+		writer.WriteString("displayName", item.displayName);
+		writer.WriteFloat("health", item.health);
+		writer.WriteFloat("quantity", item.quantity);
+		writer.WriteFloat("quantityMax", item.quantityMax);
+		writer.WriteInt("slot", item.slot);
+		writer.WriteString("slotName", item.slotName);
+
+		writer.Key("attachments");
+		writer.BeginArray();
+		if (item.attachments)
+		{
+			foreach (SST_InventoryItemData attachment : item.attachments)
+				WriteInventoryItem(writer, attachment);
+		}
+		writer.EndArray();
+
+		writer.Key("cargo");
+		writer.BeginArray();
+		if (item.cargo)
+		{
+			foreach (SST_InventoryItemData cargoItem : item.cargo)
+				WriteInventoryItem(writer, cargoItem);
+		}
+		writer.EndArray();
+
+		writer.EndObject();
+	}
+
+	static void WritePlayerInventory(SST_JsonWriter writer, SST_PlayerInventoryData player)
+	{
+		if (!player)
+		{
+			writer.NullValue();
+			return;
+		}
+
+		writer.BeginObject();
+		writer.WriteString("playerName", player.playerName);
+		writer.WriteString("playerId", player.playerId);
+		writer.WriteString("biId", player.biId);
+
+		writer.Key("inventory");
+		writer.BeginArray();
+		if (player.inventory)
+		{
+			foreach (SST_InventoryItemData item : player.inventory)
+				WriteInventoryItem(writer, item);
+		}
+		writer.EndArray();
+
+		writer.EndObject();
+	}
+
+	static void WriteInventoryExport(SST_JsonWriter writer, SST_InventoryExportData data)
+	{
+		writer.BeginObject();
+		writer.WriteUnhashedString("generatedAt", data.generatedAt);
+		writer.WriteInt("playerCount", data.playerCount);
+
+		writer.Key("players");
+		writer.BeginArray();
+		if (data.players)
+		{
+			foreach (SST_PlayerInventoryData player : data.players)
+				WritePlayerInventory(writer, player);
+		}
+		writer.EndArray();
+
+		writer.EndObject();
+	}
+
+	// ------------------------------------------------------------------------
+	// Event history (NDJSON records, one per line)
+	// ------------------------------------------------------------------------
+
+	static void WriteInventoryEvent(SST_JsonWriter writer, SST_InventoryEventData eventData)
+	{
+		writer.BeginObject();
+		writer.WriteString("timestamp", eventData.timestamp);
+		writer.WriteInt("timestampUnix", eventData.timestampUnix);
+		writer.WriteString("eventType", eventData.eventType);
+		writer.WriteString("playerName", eventData.playerName);
+		writer.WriteString("playerId", eventData.playerId);
+		writer.WriteString("itemClassName", eventData.itemClassName);
+		writer.WriteString("itemDisplayName", eventData.itemDisplayName);
+		writer.WriteFloat("itemHealth", eventData.itemHealth);
+		writer.WriteFloat("itemQuantity", eventData.itemQuantity);
+		writer.WriteVector("position", eventData.position);
+		writer.WriteInt("count", eventData.count);
+		writer.EndObject();
+	}
+
+	static void WriteLifeEvent(SST_JsonWriter writer, SST_PlayerLifeEventData eventData)
+	{
+		writer.BeginObject();
+		writer.WriteString("timestamp", eventData.timestamp);
+		writer.WriteInt("timestampUnix", eventData.timestampUnix);
+		writer.WriteString("eventType", eventData.eventType);
+		writer.WriteString("playerName", eventData.playerName);
+		writer.WriteString("playerId", eventData.playerId);
+		writer.WriteVector("position", eventData.position);
+		writer.WriteString("causeOfDeath", eventData.causeOfDeath);
+		writer.WriteFloat("healthAtDeath", eventData.healthAtDeath);
+		writer.EndObject();
+	}
+
+	// ------------------------------------------------------------------------
+	// Online players
+	// ------------------------------------------------------------------------
+
+	static void WriteOnlinePlayer(SST_JsonWriter writer, SST_OnlinePlayerData player)
+	{
+		if (!player)
+		{
+			writer.NullValue();
+			return;
+		}
+
+		writer.BeginObject();
+		writer.WriteString("playerId", player.playerId);
+		writer.WriteString("playerName", player.playerName);
+		writer.WriteString("biId", player.biId);
+		writer.WriteBool("isOnline", player.isOnline);
+		writer.WriteString("connectedAt", player.connectedAt);
+		writer.WriteString("lastUpdate", player.lastUpdate);
+		writer.WriteFloat("posX", player.posX);
+		writer.WriteFloat("posY", player.posY);
+		writer.WriteFloat("posZ", player.posZ);
+		writer.WriteFloat("health", player.health);
+		writer.WriteFloat("blood", player.blood);
+		writer.WriteFloat("water", player.water);
+		writer.WriteFloat("energy", player.energy);
+		writer.WriteBool("isAlive", player.isAlive);
+		writer.WriteBool("isUnconscious", player.isUnconscious);
+		writer.WriteBool("inVehicle", player.inVehicle);
+		writer.EndObject();
+	}
+
+	static void WriteOnlinePlayers(SST_JsonWriter writer, SST_OnlinePlayersData data)
+	{
+		writer.BeginObject();
+		writer.WriteUnhashedString("generatedAt", data.generatedAt);
+		writer.WriteInt("onlineCount", data.onlineCount);
+
+		writer.Key("players");
+		writer.BeginArray();
+		if (data.players)
+		{
+			foreach (SST_OnlinePlayerData player : data.players)
+				WriteOnlinePlayer(writer, player);
+		}
+		writer.EndArray();
+
+		writer.EndObject();
+	}
+
+	static void WritePlayerRegistry(SST_JsonWriter writer, SST_PlayerRegistryData data)
+	{
+		writer.BeginObject();
+		writer.WriteUnhashedString("generatedAt", data.generatedAt);
+		writer.WriteInt("playerCount", data.playerCount);
+
+		writer.Key("players");
+		writer.BeginArray();
+		if (data.players)
+		{
+			foreach (SST_OnlinePlayerData player : data.players)
+				WriteOnlinePlayer(writer, player);
+		}
+		writer.EndArray();
+
+		writer.EndObject();
+	}
+
+	// ------------------------------------------------------------------------
+	// Server item list
+	// ------------------------------------------------------------------------
+
+	static void WriteServerItemEntry(SST_JsonWriter writer, SST_ServerItemEntry entry)
+	{
+		if (!entry)
+		{
+			writer.NullValue();
+			return;
+		}
+
+		writer.BeginObject();
+		writer.WriteString("className", entry.className);
+		writer.WriteString("displayName", entry.displayName);
+		writer.WriteString("category", entry.category);
+		writer.WriteString("parentClass", entry.parentClass);
+		writer.WriteBool("canBeStacked", entry.canBeStacked);
+		writer.WriteInt("maxQuantity", entry.maxQuantity);
+		writer.EndObject();
+	}
+
+	static void WriteServerItemList(SST_JsonWriter writer, SST_ServerItemList data)
+	{
+		writer.BeginObject();
+		writer.WriteUnhashedString("generatedAt", data.generatedAt);
+		writer.WriteInt("itemCount", data.itemCount);
+
+		writer.Key("items");
+		writer.BeginArray();
+		if (data.items)
+		{
+			foreach (SST_ServerItemEntry entry : data.items)
+				WriteServerItemEntry(writer, entry);
+		}
+		writer.EndArray();
+
+		writer.EndObject();
+	}
+
+	static void WriteServerItemShard(SST_JsonWriter writer, SST_ServerItemShard shard)
+	{
+		writer.BeginObject();
+		writer.WriteUnhashedString("generatedAt", shard.generatedAt);
+		writer.WriteString("category", shard.category);
+		writer.WriteInt("itemCount", shard.itemCount);
+
+		writer.Key("items");
+		writer.BeginArray();
+		if (shard.items)
+		{
+			foreach (SST_ServerItemEntry entry : shard.items)
+				WriteServerItemEntry(writer, entry);
+		}
+		writer.EndArray();
+
+		writer.EndObject();
+	}
+
+	static void WriteServerItemIndex(SST_JsonWriter writer, SST_ServerItemIndex index)
+	{
+		writer.BeginObject();
+		writer.WriteUnhashedString("generatedAt", index.generatedAt);
+		writer.WriteInt("itemCount", index.itemCount);
+
+		writer.Key("categories");
+		writer.BeginArray();
+		if (index.categories)
+		{
+			foreach (SST_ServerItemIndexEntry entry : index.categories)
+			{
+				writer.BeginObject();
+				writer.WriteString("category", entry.category);
+				writer.WriteString("shard", entry.shard);
+				writer.WriteInt("itemCount", entry.itemCount);
+				writer.WriteString("hash", entry.hash);
+				writer.EndObject();
+			}
+		}
+		writer.EndArray();
+
+		writer.EndObject();
+	}
+}
@@ -0,0 +1,375 @@
+/**
+ * @file SST_JsonWriter.c
+ * @brief Streaming compact JSON writer for SST exports.
+ *
+ * JsonFileLoader<T>.SaveFile builds the whole document in memory and writes it
+ * pretty-printed. Exporters that write large snapshots (inventories, online
+ * players, item list, tracked vehicles) use this writer instead: values are
+ * appended to a small buffer and flushed to the FileHandle as the DTOs are
+ * walked, with no whitespace between tokens.
+ *
+ * The output layout matches JsonFileLoader (field names, bools as 1/0,
+ * vectors as [x,y,z]), so API readers don't care which one produced a file.
+ *
+ * The writer also counts the bytes written and keeps a running hash of the
+ * content, which SST_SnapshotPublisher records in its manifest. Fields written
+ * with WriteUnhashedString (export timestamps) are left out of the hash, so a
+ * snapshot whose payload did not change hashes the same.
+ *
+ * Opened with append = true and with NewLine() after each top-level value, it
+ * writes NDJSON records (SST_NdjsonLog).
+ *
+ * Usage:
+ *   SST_JsonWriter writer = new SST_JsonWriter();
+ *   if (!writer.Open(path))
+ *       return false;
+ *   writer.BeginObject();
+ *   writer.WriteString("generatedAt", timestamp);
+ *   writer.EndObject();
+ *   return writer.Close();
+ */
+
+class SST_JsonWriter
+{
+	// Flush the pending buffer to disk once it grows past this many characters
+	static const int FLUSH_THRESHOLD = 4096;
+	static const string HEX_DIGITS = "0123456789abcdef";     // For \u00XX escapes
+
+	// Characters 0x01-0x1F as one-character strings, for NeedsEscape (a script string cannot hold 0x00)
+	protected static ref array<string> s_ControlChars;
+
+	protected FileHandle m_File;
+	protected string m_Path;
+	protected string m_Buffer;
+	protected int m_BytesWritten;
+	protected int m_Hash;
+	protected int m_HashedBytes;       // Bytes that went into m_Hash (m_BytesWritten without unhashed fields)
+	protected bool m_HashPaused;
+
+	// One entry per open object/array: true once it has at least one value
+	protected ref array<bool> m_HasValue;
+	protected bool m_AfterKey;
+
+	void SST_JsonWriter()
+	{
+		m_HasValue = new array<bool>();
+	}
+
+	void ~SST_JsonWriter()
+	{
+		if (m_File)
+			CloseFile(m_File);
+	}
+
+	// append: add to the end of an existing file instead of truncating it
+	bool Open(string path, bool append = false)
+	{
+		m_Path = path;
+		m_Buffer = "";
+		m_BytesWritten = 0;
+		m_Hash = 0;
+		m_HashedBytes = 0;
+		m_HashPaused = false;
+		m_HasValue.Clear();
+		m_AfterKey = false;
+
+		if (append)
+			m_File = OpenFile(path, FileMode.APPEND);
+		else
+			m_File = OpenFile(path, FileMode.WRITE);
+		if (!m_File)
+		{
+			Print("[SST] ERROR: JsonWriter could not open " + path);
+			return false;
+		}
+
+		return true;
+	}
+
+	// Flush and close; false if the document was left unbalanced
+	bool Close()
+	{
+		if (!m_File)
+			return false;
+
+		Flush();
+		CloseFile(m_File);
+		m_File = null;
+
+		if (m_HasValue.Count() != 0 || m_AfterKey)
+		{
+			Print("[SST] ERROR: JsonWriter closed unbalanced document " + m_Path);
+			return false;
+		}
+
+		return true;
+	}
+
+	int GetBytesWritten()
+	{
+		return m_BytesWritten;
+	}
+
+	// Hash of everything written so far except unhashed fields, with the byte length it covers
+	// ("<hash>-<bytes>"), so two contents only compare equal if the 32-bit hash and the length match
+	string GetContentHash()
+	{
+		return m_Hash.ToString() + "-" + m_HashedBytes.ToString();
+	}
+
+	string GetPath()
+	{
+		return m_Path;
+	}
+
+	// ------------------------------------------------------------------------
+	// Structure
+	// ------------------------------------------------------------------------
+
+	void BeginObject()
+	{
+		BeforeValue();
+		Append("{");
+		m_HasValue.Insert(false);
+	}
+
+	void EndObject()
+	{
+		m_HasValue.Remove(m_HasValue.Count() - 1);
+		Append("}");
+	}
+
+	void BeginArray()
+	{
+		BeforeValue();
+		Append("[");
+		m_HasValue.Insert(false);
+	}
+
+	void EndArray()
+	{
+		m_HasValue.Remove(m_HasValue.Count() - 1);
+		Append("]");
+	}
+
+	// Line break between top-level values (NDJSON); ignored inside objects/arrays
+	void NewLine()
+	{
+		if (m_HasValue.Count() == 0 && !m_AfterKey)
+			Append("\n");
+	}
+
+	// Object member name; must be followed by exactly one value
+	void Key(string name)
+	{
+		BeforeValue();
+		Append("\"" + Escape(name) + "\":");
+		m_AfterKey = true;
+	}
+
+	// ------------------------------------------------------------------------
+	// Values (inside arrays, or after Key)
+	// ------------------------------------------------------------------------
+
+	void StringValue(string value)
+	{
+		BeforeValue();
+		Append("\"" + Escape(value) + "\"");
+	}
+
+	void IntValue(int value)
+	{
+		BeforeValue();
+		Append(value.ToString());
+	}
+
+	void FloatValue(float value)
+	{
+		BeforeValue();
+		Append(FormatFloat(value));
+	}
+
+	// Written as 1/0 like JsonFileLoader; API readers compare against 1
+	void BoolValue(bool value)
+	{
+		BeforeValue();
+		if (value)
+			Append("1");
+		else
+			Append("0");
+	}
+
+	void VectorValue(vector value)
+	{
+		BeforeValue();
+		Append("[" + FormatFloat(value[0]) + "," + FormatFloat(value[1]) + "," + FormatFloat(value[2]) + "]");
+	}
+
+	void NullValue()
+	{
+		BeforeValue();
+		Append("null");
+	}
+
+	// Already serialized JSON (e.g. JsonSerializer output); must be one complete value without line breaks
+	void RawValue(string json)
+	{
+		if (json == "")
+		{
+			NullValue();
+			return;
+		}
+
+		BeforeValue();
+		Append(json);
+	}
+
+	// ------------------------------------------------------------------------
+	// Key + value shortcuts for object members
+	// ------------------------------------------------------------------------
+
+	void WriteString(string name, string value)
+	{
+		Key(name);
+		StringValue(value);
+	}
+
+	void WriteInt(string name, int value)
+	{
+		Key(name);
+		IntValue(value);
+	}
+
+	void WriteFloat(string name, float value)
+	{
+		Key(name);
+		FloatValue(value);
+	}
+
+	void WriteBool(string name, bool value)
+	{
+		Key(name);
+		BoolValue(value);
+	}
+
+	void WriteVector(string name, vector value)
+	{
+		Key(name);
+		VectorValue(value);
+	}
+
+	// Member left out of GetContentHash(), e.g. generatedAt, which changes on every export
+	void WriteUnhashedString(string name, string value)
+	{
+		Flush();
+		m_HashPaused = true;
+		WriteString(name, value);
+		Flush();
+		m_HashPaused = false;
+	}
+
+	// ------------------------------------------------------------------------
+	// Internals
+	// ------------------------------------------------------------------------
+
+	protected void BeforeValue()
+	{
+		if (m_AfterKey)
+		{
+			m_AfterKey = false;
+			return;
+		}
+
+		int depth = m_HasValue.Count();
+		if (depth == 0)
+			return;
+
+		if (m_HasValue[depth - 1])
+			Append(",");
+		else
+			m_HasValue[depth - 1] = true;
+	}
+
+	protected void Append(string text)
+	{
+		m_Buffer += text;
+		if (m_Buffer.Length() >= FLUSH_THRESHOLD)
+			Flush();
+	}
+
+	protected void Flush()
+	{
+		if (!m_File || m_Buffer == "")
+			return;
+
+		FPrint(m_File, m_Buffer);
+		m_BytesWritten += m_Buffer.Length();
+		if (!m_HashPaused)
+		{
+			m_Hash = m_Hash * 31 + m_Buffer.Hash();
+			m_HashedBytes += m_Buffer.Length();
+		}
+		m_Buffer = "";
+	}
+
+	// JSON has no NaN/Infinity; write 0 rather than produce an unparsable file
+	static string FormatFloat(float value)
+	{
+		if (value != value || value > float.MAX || value < -float.MAX)
+			return "0";
+
+		return value.ToString();
+	}
+
+	static string Escape(string value)
+	{
+		// Fast path: most names and class names need no escaping
+		if (!NeedsEscape(value))
+			return value;
+
+		string escaped = "";
+		for (int i = 0; i < value.Length(); i++)
+		{
+			string c = value.Get(i);
+			int code = c.ToAscii();
+			if (c == "\\")
+				escaped += "\\\\";
+			else if (c == "\"")
+				escaped += "\\\"";
+			else if (code == 10)
+				escaped += "\\n";
+			else if (code == 13)
+				escaped += "\\r";
+			else if (code == 9)
+				escaped += "\\t";
+			else if (code >= 0 && code < 32)
+				escaped += "\\u00" + HEX_DIGITS.Get(code / 16) + HEX_DIGITS.Get(code % 16);
+			else
+				escaped += c;
+		}
+		return escaped;
+	}
+
+	// Quotes, backslashes and control characters (below 0x20) must be escaped in JSON strings.
+	// One native IndexOf per character that needs escaping instead of a scripted loop over the
+	// value; Escape() only walks the value character by character when one of them is found.
+	protected static bool NeedsEscape(string value)
+	{
+		if (value.IndexOf("\"") >= 0 || value.IndexOf("\\") >= 0)
+			return true;
+
+		if (!s_ControlChars)
+		{
+			s_ControlChars = new array<string>();
+			for (int code = 1; code < 32; code++)
+				s_ControlChars.Insert(code.AsciiToString());
+		}
+
+		foreach (string control : s_ControlChars)
+		{
+			if (value.IndexOf(control) >= 0)
+				return true;
+		}
+		return false;
+	}
+}
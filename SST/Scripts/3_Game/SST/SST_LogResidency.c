@@ -0,0 +1,144 @@
+/**
+ * @file SST_LogResidency.c
+ * @brief Decides which players' event logs are held in memory.
+ *
+ * Without this, a player's events, life and trade JSON were read from disk by
+ * the first event after connecting (inside the gameplay callback) and then kept
+ * until restart.
+ *
+ * Now:
+ *
+ * - PlayerConnected(steam64) queues one SST_LogPreloadTask per registered
+ *   logger on SST_FrameScheduler, so the files are read a few per frame
+ *   outside any gameplay hook. An event logged before its preload ran starts
+ *   an empty in-memory log; the preload merges the file underneath it.
+ * - PlayerDisconnected(steam64) moves the key to an LRU list of offline
+ *   players. Once more than MAX_OFFLINE_LOGS are listed, the oldest is flushed
+ *   through SST_LogSink and evicted from every logger.
+ *
+ * Loggers (SST_LogSinkClient) register themselves in their constructor.
+ */
+
+class SST_LogResidency
+{
+	protected static ref SST_LogResidency s_Instance;
+
+	static const int MAX_OFFLINE_LOGS = 32;        // Disconnected players whose logs stay in memory
+
+	// Weak: loggers are singletons
+	protected ref array<SST_LogSinkClient> m_Clients;
+
+	// Steam64 -> true while connected
+	protected ref map<string, bool> m_Online;
+
+	// Disconnected players still in memory, least recently disconnected first
+	protected ref array<string> m_Offline;
+
+	void SST_LogResidency()
+	{
+		m_Clients = new array<SST_LogSinkClient>();
+		m_Online = new map<string, bool>();
+		m_Offline = new array<string>();
+	}
+
+	static SST_LogResidency GetInstance()
+	{
+		if (!s_Instance)
+			s_Instance = new SST_LogResidency();
+		return s_Instance;
+	}
+
+	void Register(SST_LogSinkClient client)
+	{
+		if (client && m_Clients.Find(client) == -1)
+			m_Clients.Insert(client);
+	}
+
+	// Queue the player's logs for loading
+	void PlayerConnected(string key)
+	{
+		m_Online.Set(key, true);
+
+		int offlineIndex = m_Offline.Find(key);
+		if (offlineIndex != -1)
+			m_Offline.RemoveOrdered(offlineIndex);
+
+		foreach (SST_LogSinkClient client : m_Clients)
+		{
+			if (client && !client.IsLogLoaded(key))
+				SST_FrameScheduler.Enqueue(new SST_LogPreloadTask(client, key));
+		}
+	}
+
+	// Call after the player's logs were flushed; evicts the oldest offline players past the cap
+	void PlayerDisconnected(string key)
+	{
+		m_Online.Remove(key);
+
+		int offlineIndex = m_Offline.Find(key);
+		if (offlineIndex != -1)
+			m_Offline.RemoveOrdered(offlineIndex);
+		m_Offline.Insert(key);
+
+		while (m_Offline.Count() > MAX_OFFLINE_LOGS)
+		{
+			string oldest = m_Offline[0];
+			m_Offline.RemoveOrdered(0);
+
+			if (!Evict(oldest))
+			{
+				// Could not be written; keep it in memory and try again on the next disconnect
+				m_Offline.Insert(oldest);
+				break;
+			}
+		}
+	}
+
+	bool IsResident(string key)
+	{
+		return m_Online.Contains(key) || m_Offline.Find(key) != -1;
+	}
+
+	int GetOfflineCount()
+	{
+		return m_Offline.Count();
+	}
+
+	// Flush and drop key from every logger; false if something is still unwritten
+	protected bool Evict(string key)
+	{
+		SST_LogSink sink = SST_LogSink.GetInstance();
+		sink.FlushKey(key);
+		if (sink.IsKeyDirty(key))
+			return false;
+
+		foreach (SST_LogSinkClient client : m_Clients)
+		{
+			if (client)
+				client.EvictLog(key);
+		}
+		return true;
+	}
+}
+
+// Frame scheduler task: read one player's log of one logger
+class SST_LogPreloadTask : SST_SchedulerTask
+{
+	protected SST_LogSinkClient m_Client;  // Weak
+	protected string m_Key;
+
+	void SST_LogPreloadTask(SST_LogSinkClient client, string key)
+	{
+		m_Client = client;
+		m_Key = key;
+	}
+
+	override void Run()
+	{
+		// Evicted again before the task ran (very short session): nothing to load
+		if (!m_Client || !SST_LogResidency.GetInstance().IsResident(m_Key))
+			return;
+
+		m_Client.PreloadLog(m_Key);
+	}
+}
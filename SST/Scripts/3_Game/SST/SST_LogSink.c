@@ -0,0 +1,352 @@
+/**
+ * @file SST_LogSink.c
+ * @brief Write-behind buffering for the per-player event logs.
+ *
+ * The event loggers (inventory, life events, trades) keep each player's log in
+ * memory. Before this sink they rewrote the whole JSON file on every event, and
+ * looting a house could rewrite the same file dozens of times a second.
+ *
+ * Now a logger appends to its in-memory log and calls Append(). The sink writes
+ * a dirty log back through the logger's FlushLog():
+ *
+ * - on the periodic flush, at most every FLUSH_INTERVAL, spread over frames by
+ *   SST_FrameScheduler
+ * - on the next frames once FLUSH_EVENT_THRESHOLD events are pending for that
+ *   log (one SST_LogFlushTask per log; Append() itself never touches disk)
+ * - synchronously in FlushKey(steam64) on disconnect and FlushAll() on mission
+ *   finish, so nothing buffered is lost on a clean shutdown
+ *
+ * A log whose FlushLog() failed stays dirty. Scheduled flushes then skip it
+ * until its backoff (RETRY_DELAY per failure in a row, up to MAX_RETRY_DELAY)
+ * has passed; FlushKey/FlushAll still try it.
+ *
+ * Which logs are in memory at all is decided by SST_LogResidency.
+ */
+
+// Implemented by loggers that buffer a log per key (usually a Steam64 ID)
+class SST_LogSinkClient : Managed
+{
+	// Keys whose file has been read into memory since they were last evicted
+	protected ref map<string, bool> m_LoadedKeys = new map<string, bool>();
+
+	// Unique per logger; combined with the key to identify one buffered log
+	string GetLogSinkName()
+	{
+		return "";
+	}
+
+	// Write the buffered log for key to disk; return false to retry on the next flush
+	bool FlushLog(string key)
+	{
+		return true;
+	}
+
+	// Read key's file once and merge it under whatever was logged in memory meanwhile.
+	// Gameplay hooks never call this; SST_LogResidency and FlushLog do.
+	void PreloadLog(string key)
+	{
+		if (m_LoadedKeys.Contains(key))
+			return;
+
+		LoadLog(key);
+		m_LoadedKeys.Set(key, true);
+	}
+
+	bool IsLogLoaded(string key)
+	{
+		return m_LoadedKeys.Contains(key);
+	}
+
+	// Forget key's in-memory state; the caller has flushed it
+	void EvictLog(string key)
+	{
+		UnloadLog(key);
+		m_LoadedKeys.Remove(key);
+	}
+
+	// Override (called through PreloadLog): load key's file and merge it with the in-memory log
+	void LoadLog(string key)
+	{
+	}
+
+	// Override (called through EvictLog): drop every map entry held for key
+	void UnloadLog(string key)
+	{
+	}
+}
+
+// Client whose keys also have a full NDJSON history (SST_NdjsonLog) under
+// GetHistoryFolder() + key next to their capped JSON file. Subclasses queue each
+// event with QueueHistory(), write one record in WriteHistoryRecord() and save
+// the JSON file in SaveRecentLog(); FlushLog() does both.
+class SST_HistoryLogSinkClient : SST_LogSinkClient
+{
+	// Records not yet appended to the key's history, and the history logs
+	protected ref map<string, ref array<ref Class>> m_PendingHistory = new map<string, ref array<ref Class>>();
+	protected ref map<string, ref SST_NdjsonLog> m_Histories = new map<string, ref SST_NdjsonLog>();
+
+	// Override: folder holding one history log per key, e.g. "$profile:SST/history/events/"
+	string GetHistoryFolder()
+	{
+		return "";
+	}
+
+	// Override: write one queued record as a JSON object (the line break is added by the caller)
+	void WriteHistoryRecord(SST_JsonWriter writer, Class record)
+	{
+	}
+
+	// Override: save key's capped JSON file; true if there is nothing to save
+	bool SaveRecentLog(string key)
+	{
+		return true;
+	}
+
+	override bool FlushLog(string key)
+	{
+		// Never write a log that has not been merged with its file yet
+		PreloadLog(key);
+
+		bool historySaved = AppendHistory(key);
+		return SaveRecentLog(key) && historySaved;
+	}
+
+	override void EvictLog(string key)
+	{
+		super.EvictLog(key);
+		m_PendingHistory.Remove(key);
+		m_Histories.Remove(key);
+	}
+
+	// Queue a record for key's history; the next FlushLog appends it
+	protected void QueueHistory(string key, Class record)
+	{
+		array<ref Class> pending = m_PendingHistory.Get(key);
+		if (!pending)
+		{
+			pending = new array<ref Class>();
+			m_PendingHistory.Set(key, pending);
+		}
+		pending.Insert(record);
+	}
+
+	// Append key's pending records to its NDJSON history
+	protected bool AppendHistory(string key)
+	{
+		array<ref Class> pending = m_PendingHistory.Get(key);
+		if (!pending || pending.Count() == 0)
+			return true;
+
+		SST_NdjsonLog history = m_Histories.Get(key);
+		if (!history)
+		{
+			if (!FileExist(SST_NdjsonLog.HISTORY_ROOT))
+				MakeDirectory(SST_NdjsonLog.HISTORY_ROOT);
+			if (!FileExist(GetHistoryFolder()))
+				MakeDirectory(GetHistoryFolder());
+
+			history = new SST_NdjsonLog(GetHistoryFolder() + key);
+			m_Histories.Set(key, history);
+		}
+
+		SST_JsonWriter writer = history.BeginAppend();
+		if (!writer)
+			return false;
+
+		foreach (Class record : pending)
+		{
+			WriteHistoryRecord(writer, record);
+			writer.NewLine();
+		}
+
+		bool appended = history.EndAppend(writer, pending.Count());
+		m_PendingHistory.Remove(key);
+		return appended;
+	}
+}
+
+// One dirty log waiting for a flush
+class SST_LogSinkEntry
+{
+	SST_LogSinkClient client;  // Weak: loggers are singletons
+	string key;
+	int pendingEvents;
+	bool flushQueued;          // An SST_LogFlushTask for this entry is waiting in the frame scheduler
+	int failures;              // FlushLog() failures in a row
+	int retryAt;               // GetGame().GetTime() before which scheduled flushes skip it
+}
+
+class SST_LogSink
+{
+	protected static ref SST_LogSink s_Instance;
+
+	static const int FLUSH_INTERVAL = 5000;        // ms between periodic flushes
+	static const int FLUSH_EVENT_THRESHOLD = 25;   // pending events that force a flush of one log
+	static const int RETRY_DELAY = 5000;           // ms before a failed log is flushed again by the scheduler
+	static const int MAX_RETRY_DELAY = 60000;
+
+	// "<sink name>:<key>" -> dirty entry
+	protected ref map<string, ref SST_LogSinkEntry> m_Dirty;
+
+	void SST_LogSink()
+	{
+		m_Dirty = new map<string, ref SST_LogSinkEntry>();
+
+		if (GetGame())
+			GetGame().GetCallQueue(CALL_CATEGORY_SYSTEM).CallLater(FlushAndScheduleNext, FLUSH_INTERVAL, false);
+	}
+
+	static SST_LogSink GetInstance()
+	{
+		if (!s_Instance)
+			s_Instance = new SST_LogSink();
+		return s_Instance;
+	}
+
+	// Record that client buffered one more event for key
+	void Append(SST_LogSinkClient client, string key)
+	{
+		if (!client)
+			return;
+
+		string entryKey = client.GetLogSinkName() + ":" + key;
+		SST_LogSinkEntry entry = m_Dirty.Get(entryKey);
+		if (!entry)
+		{
+			entry = new SST_LogSinkEntry();
+			entry.client = client;
+			entry.key = key;
+			m_Dirty.Set(entryKey, entry);
+		}
+
+		entry.pendingEvents++;
+		if (entry.pendingEvents >= FLUSH_EVENT_THRESHOLD)
+			QueueFlush(entryKey, entry);
+	}
+
+	// Write every dirty log of key now (all loggers), e.g. when the player disconnects
+	void FlushKey(string key)
+	{
+		array<string> entryKeys = new array<string>();
+		for (int i = 0; i < m_Dirty.Count(); i++)
+		{
+			if (m_Dirty.GetElement(i).key == key)
+				entryKeys.Insert(m_Dirty.GetKey(i));
+		}
+
+		foreach (string entryKey : entryKeys)
+			FlushEntry(entryKey);
+	}
+
+	// Write everything now, e.g. on mission finish
+	void FlushAll()
+	{
+		int flushed = m_Dirty.Count();
+
+		array<string> entryKeys = new array<string>();
+		for (int i = 0; i < m_Dirty.Count(); i++)
+			entryKeys.Insert(m_Dirty.GetKey(i));
+
+		foreach (string entryKey : entryKeys)
+			FlushEntry(entryKey);
+
+		if (flushed > 0)
+			Print("[SST] LogSink: flushed " + flushed.ToString() + " buffered logs");
+	}
+
+	int GetDirtyCount()
+	{
+		return m_Dirty.Count();
+	}
+
+	// True if any logger still has unwritten events for key
+	bool IsKeyDirty(string key)
+	{
+		for (int i = 0; i < m_Dirty.Count(); i++)
+		{
+			if (m_Dirty.GetElement(i).key == key)
+				return true;
+		}
+		return false;
+	}
+
+	// Flush entry on a later frame; at most one task per entry is queued
+	protected void QueueFlush(string entryKey, SST_LogSinkEntry entry)
+	{
+		if (entry.flushQueued || IsBackingOff(entry))
+			return;
+
+		entry.flushQueued = true;
+		SST_FrameScheduler.Enqueue(new SST_LogFlushTask(entryKey));
+	}
+
+	protected static bool IsBackingOff(SST_LogSinkEntry entry)
+	{
+		return entry.failures > 0 && GetGame().GetTime() < entry.retryAt;
+	}
+
+	// Run directly or by SST_LogFlushTask; a no-op if the entry was flushed meanwhile
+	void FlushEntry(string entryKey)
+	{
+		SST_LogSinkEntry entry = m_Dirty.Get(entryKey);
+		if (!entry)
+			return;
+
+		entry.flushQueued = false;
+		m_Dirty.Remove(entryKey);
+
+		if (!entry.client)
+			return;
+
+		if (!entry.client.FlushLog(entry.key))
+		{
+			// Keep it, and leave it alone for a while: the disk problem is unlikely to clear within a frame
+			entry.failures++;
+			int delay = RETRY_DELAY * entry.failures;
+			if (delay > MAX_RETRY_DELAY)
+				delay = MAX_RETRY_DELAY;
+			entry.retryAt = GetGame().GetTime() + delay;
+			m_Dirty.Set(entryKey, entry);
+		}
+	}
+
+	// Scheduled flush task; skips entries that are backing off after a failure
+	void RunScheduledFlush(string entryKey)
+	{
+		SST_LogSinkEntry entry = m_Dirty.Get(entryKey);
+		if (!entry)
+			return;
+
+		if (IsBackingOff(entry))
+		{
+			entry.flushQueued = false;
+			return;
+		}
+
+		FlushEntry(entryKey);
+	}
+
+	protected void FlushAndScheduleNext()
+	{
+		for (int i = 0; i < m_Dirty.Count(); i++)
+			QueueFlush(m_Dirty.GetKey(i), m_Dirty.GetElement(i));
+
+		GetGame().GetCallQueue(CALL_CATEGORY_SYSTEM).CallLater(FlushAndScheduleNext, FLUSH_INTERVAL, false);
+	}
+}
+
+// Frame scheduler task: write one buffered log
+class SST_LogFlushTask : SST_SchedulerTask
+{
+	protected string m_EntryKey;
+
+	void SST_LogFlushTask(string entryKey)
+	{
+		m_EntryKey = entryKey;
+	}
+
+	override void Run()
+	{
+		SST_LogSink.GetInstance().RunScheduledFlush(m_EntryKey);
+	}
+}
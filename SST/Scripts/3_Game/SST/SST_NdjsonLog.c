@@ -0,0 +1,454 @@
+/**
+ * @file SST_NdjsonLog.c
+ * @brief Append-only NDJSON event history split into rotating segments.
+ *
+ * One log is a folder:
+ *
+ *   <folder>/index.0.json
+ *   <folder>/index.1.json
+ *   <folder>/00000001.ndjson
+ *   <folder>/00000002.ndjson   <- current segment, appended to
+ *
+ * Each record is one JSON object per line. Appending never rewrites earlier
+ * records, so the cost of an event does not grow with the history.
+ *
+ * A new segment is started once the current one reaches MAX_SEGMENT_BYTES or
+ * is older than MAX_SEGMENT_AGE. The index lists the segments with their byte
+ * size, line count and first/last record time, so readers can tail by
+ * (segment, byte offset) without listing the folder. Segments past
+ * MAX_SEGMENTS or RETENTION_SECONDS are deleted on rotation.
+ *
+ * Index saves alternate between index.0.json and index.1.json, each carrying a
+ * revision; readers take the highest revision that parses, so a save cut short
+ * never loses the index. If neither slot can be read, the index is rebuilt by
+ * scanning the *.ndjson segments in the folder.
+ *
+ * Logs whose records carry a sequence number (SST_EventStream) pass the last
+ * one to EndAppend; segments then also record their first/last sequence so a
+ * reader can find the segment holding "everything after seq N".
+ *
+ * Usage (one Begin/End per batch of records):
+ *   SST_JsonWriter writer = log.BeginAppend();
+ *   if (!writer)
+ *       return false;
+ *   foreach (...) { SST_JsonExport.WriteX(writer, record); writer.NewLine(); }
+ *   return log.EndAppend(writer, recordCount);
+ */
+
+// One segment file in the index
+class SST_NdjsonSegment
+{
+	string file;               // Relative to the log folder, e.g. "00000002.ndjson"
+	int size;                  // Bytes; a reader that has read this many is caught up
+	int lines;                 // Records in the segment
+	int firstAt;               // Epoch seconds of the first record
+	int lastAt;                // Epoch seconds of the last record
+	int firstSeq;              // Sequence number of the first record, 0 in unsequenced logs
+	int lastSeq;               // Sequence number of the last record, 0 in unsequenced logs
+}
+
+// index.<slot>.json of one log folder
+class SST_NdjsonIndex
+{
+	int revision;              // Incremented on every save; readers take the highest one
+	int nextSegment = 1;
+	ref array<ref SST_NdjsonSegment> segments = new array<ref SST_NdjsonSegment>();
+}
+
+class SST_NdjsonLog
+{
+	static const string INDEX_PREFIX = "index.";           // index.0.json / index.1.json
+	static const string LEGACY_INDEX_NAME = "index.json";  // Rewritten in place before the slots; read once, then deleted
+	static const int INDEX_SLOTS = 2;
+	static const string HISTORY_ROOT = "$profile:SST/history/"; // Parent of the per-stream history folders
+	static const string SEQ_PREFIX = "{\"seq\":";              // Start of a record line in sequenced logs
+
+	static const int MAX_SEGMENT_BYTES = 262144;            // 256 KB
+	static const int MAX_SEGMENT_AGE = 86400;               // Seconds; one segment per day at most
+	static const int MAX_SEGMENTS = 30;
+	static const int RETENTION_SECONDS = 2592000;           // 30 days; delete segments whose last record is older
+
+	protected string m_Folder;
+	protected ref SST_NdjsonIndex m_Index;
+	protected bool m_RotatePending;
+	protected bool m_DeferIndexSave;   // EndAppend only marks the index dirty; the owner calls SaveIndexIfDirty
+	protected bool m_IndexDirty;
+
+	void SST_NdjsonLog(string folder)
+	{
+		m_Folder = folder;
+		if (m_Folder.Length() > 0 && m_Folder.Substring(m_Folder.Length() - 1, 1) != "/")
+			m_Folder += "/";
+
+		if (!FileExist(m_Folder))
+			MakeDirectory(m_Folder);
+
+		LoadIndex();
+	}
+
+	string GetFolder()
+	{
+		return m_Folder;
+	}
+
+	// Open the current segment for appending; rotates first if it is full or too old
+	SST_JsonWriter BeginAppend()
+	{
+		SST_NdjsonSegment segment = GetWritableSegment();
+
+		SST_JsonWriter writer = new SST_JsonWriter();
+		if (!writer.Open(m_Folder + segment.file, true))
+			return null;
+
+		return writer;
+	}
+
+	// Close the writer and record the appended records in the index.
+	// lastSeq is the sequence number of the last record, for sequenced logs.
+	bool EndAppend(SST_JsonWriter writer, int records, int lastSeq = 0)
+	{
+		if (!writer)
+			return false;
+
+		bool closed = writer.Close();
+
+		// Whatever reached the file counts towards the segment, even on an unbalanced close
+		SST_NdjsonSegment segment = m_Index.segments[m_Index.segments.Count() - 1];
+		int now = SST_Clock.NowUnix();
+		if (segment.lines == 0)
+			segment.firstAt = now;
+		segment.size += writer.GetBytesWritten();
+		segment.lines += records;
+		segment.lastAt = now;
+		if (lastSeq > 0)
+		{
+			if (segment.firstSeq == 0)
+				segment.firstSeq = lastSeq - records + 1;
+			segment.lastSeq = lastSeq;
+		}
+
+		if (m_DeferIndexSave)
+			m_IndexDirty = true;
+		else
+			SaveIndex();
+		return closed;
+	}
+
+	// Batch index saves for logs with many small appends: after this, EndAppend no longer
+	// saves the index and the owner calls SaveIndexIfDirty() once per batch. Appended bytes
+	// the index has not caught up with yet are picked up by RecoverCurrentSegment() on load.
+	void DeferIndexSave()
+	{
+		m_DeferIndexSave = true;
+	}
+
+	void SaveIndexIfDirty()
+	{
+		if (m_IndexDirty)
+			SaveIndex();
+	}
+
+	// Start a new segment on the next append. The index is saved after the file is written,
+	// so a crash in between leaves the current segment's indexed size short of the file;
+	// logs that hand out byte offsets (SST_ResultsJournal) call this once when loaded.
+	void Rotate()
+	{
+		m_RotatePending = true;
+	}
+
+	// Segment being appended to; after BeginAppend() its size is the offset of the next record
+	SST_NdjsonSegment GetCurrentSegment()
+	{
+		int count = m_Index.segments.Count();
+		if (count == 0)
+			return null;
+		return m_Index.segments[count - 1];
+	}
+
+	// Oldest segment still kept, "" if there is none; changes when retention drops one
+	string GetOldestSegment()
+	{
+		if (m_Index.segments.Count() == 0)
+			return "";
+		return m_Index.segments[0].file;
+	}
+
+	// Highest sequence number recorded in the index, 0 if there is none
+	int GetLastSeq()
+	{
+		for (int i = m_Index.segments.Count() - 1; i >= 0; i--)
+		{
+			if (m_Index.segments[i].lastSeq > 0)
+				return m_Index.segments[i].lastSeq;
+		}
+		return 0;
+	}
+
+	// Re-read the current segment file and correct its index entry if the file holds more than
+	// the index says (a crash between the append and SaveIndex). Returns the highest sequence
+	// number afterwards. Sequenced logs call this once when loaded, before the first append.
+	int RecoverCurrentSegment()
+	{
+		SST_NdjsonSegment current = GetCurrentSegment();
+		if (!current || !FileExist(m_Folder + current.file))
+			return GetLastSeq();
+
+		SST_NdjsonSegment scanned = ScanSegment(current.file);
+		if (!scanned || scanned.size <= current.size)
+			return GetLastSeq();
+
+		Print("[SST] NDJSON log " + m_Folder + ": " + current.file + " has " + (scanned.lines - current.lines).ToString() + " records missing from the index, recovered");
+
+		int now = SST_Clock.NowUnix();
+		if (current.lines == 0)
+			current.firstAt = now;
+		current.size = scanned.size;
+		current.lines = scanned.lines;
+		current.lastAt = now;
+		if (scanned.lastSeq > 0)
+		{
+			if (current.firstSeq == 0)
+				current.firstSeq = scanned.firstSeq;
+			current.lastSeq = scanned.lastSeq;
+		}
+
+		SaveIndex();
+		return GetLastSeq();
+	}
+
+	// Size, line count and first/last sequence number of a segment as found on disk, null if unreadable
+	protected SST_NdjsonSegment ScanSegment(string file)
+	{
+		FileHandle handle = OpenFile(m_Folder + file, FileMode.READ);
+		if (!handle)
+			return null;
+
+		SST_NdjsonSegment segment = new SST_NdjsonSegment();
+		segment.file = file;
+
+		string line;
+		int length = FGets(handle, line);
+		while (length >= 0)
+		{
+			segment.size += length + 1;
+			if (length > 0)
+			{
+				segment.lines++;
+				int seq = ParseSeq(line);
+				if (seq > 0)
+				{
+					if (segment.firstSeq == 0)
+						segment.firstSeq = seq;
+					segment.lastSeq = seq;
+				}
+			}
+			length = FGets(handle, line);
+		}
+		CloseFile(handle);
+
+		return segment;
+	}
+
+	// Sequence number at the start of a record line, 0 if the line does not start with one
+	protected static int ParseSeq(string line)
+	{
+		if (line.IndexOf(SEQ_PREFIX) != 0)
+			return 0;
+
+		string digits = "";
+		for (int i = SEQ_PREFIX.Length(); i < line.Length(); i++)
+		{
+			string ch = line.Get(i);
+			if ("0123456789".IndexOf(ch) < 0)
+				break;
+			digits += ch;
+		}
+
+		if (digits == "")
+			return 0;
+		return digits.ToInt();
+	}
+
+	protected SST_NdjsonSegment GetWritableSegment()
+	{
+		int count = m_Index.segments.Count();
+		if (count > 0)
+		{
+			SST_NdjsonSegment current = m_Index.segments[count - 1];
+			bool full = current.size >= MAX_SEGMENT_BYTES;
+			bool old = current.lines > 0 && SST_Clock.NowUnix() - current.firstAt >= MAX_SEGMENT_AGE;
+			bool rotate = m_RotatePending && (current.size > 0 || FileExist(m_Folder + current.file));
+			m_RotatePending = false;
+			if (!full && !old && !rotate)
+				return current;
+		}
+
+		m_RotatePending = false;
+
+		SST_NdjsonSegment segment = new SST_NdjsonSegment();
+		segment.file = m_Index.nextSegment.ToStringLen(8) + ".ndjson";
+		m_Index.nextSegment++;
+		m_Index.segments.Insert(segment);
+
+		ApplyRetention();
+		SaveIndex();
+		return segment;
+	}
+
+	// Drop the oldest segments past MAX_SEGMENTS or RETENTION_SECONDS (never the current one)
+	protected void ApplyRetention()
+	{
+		int now = SST_Clock.NowUnix();
+		while (m_Index.segments.Count() > 1)
+		{
+			SST_NdjsonSegment oldest = m_Index.segments[0];
+			bool tooMany = m_Index.segments.Count() > MAX_SEGMENTS;
+			bool expired = oldest.lines > 0 && now - oldest.lastAt > RETENTION_SECONDS;
+			if (!tooMany && !expired)
+				break;
+
+			DeleteFile(m_Folder + oldest.file);
+			m_Index.segments.RemoveOrdered(0);
+		}
+	}
+
+	protected void LoadIndex()
+	{
+		m_Index = null;
+		for (int slot = 0; slot < INDEX_SLOTS; slot++)
+		{
+			SST_NdjsonIndex index = ReadIndex(m_Folder + INDEX_PREFIX + slot.ToString() + ".json");
+			if (index && (!m_Index || index.revision > m_Index.revision))
+				m_Index = index;
+		}
+
+		// Index from before the slots: adopt it, then stop leaving it on the read path
+		string legacyPath = m_Folder + LEGACY_INDEX_NAME;
+		bool adopt = false;
+		if (!m_Index && FileExist(legacyPath))
+		{
+			m_Index = ReadIndex(legacyPath);
+			adopt = m_Index != null;
+		}
+
+		if (!m_Index)
+		{
+			m_Index = new SST_NdjsonIndex();
+			RebuildIndex();
+		}
+		else if (adopt)
+		{
+			SaveIndex();
+		}
+
+		// Only once a slot holds the index
+		if (m_Index.revision > 0 && FileExist(legacyPath))
+			DeleteFile(legacyPath);
+	}
+
+	protected static SST_NdjsonIndex ReadIndex(string path)
+	{
+		if (!FileExist(path))
+			return null;
+
+		SST_NdjsonIndex index = new SST_NdjsonIndex();
+		string errorMsg;
+		if (!JsonFileLoader<SST_NdjsonIndex>.LoadFile(path, index, errorMsg))
+		{
+			// Also the slot a crash interrupted; the other slot is used instead
+			Print("[SST] WARNING: Could not read NDJSON index " + path + ": " + errorMsg);
+			return null;
+		}
+
+		if (!index.segments)
+			index.segments = new array<ref SST_NdjsonSegment>();
+		return index;
+	}
+
+	// No readable index: list the segments from the files on disk so they are neither
+	// orphaned nor overwritten. Record times are unknown and count from now for retention.
+	protected void RebuildIndex()
+	{
+		array<string> files = new array<string>();
+		string fileName;
+		FileAttr fileAttr;
+		FindFileHandle handle = FindFile(m_Folder + "*.ndjson", fileName, fileAttr, 0);
+		if (handle)
+		{
+			bool found = true;
+			while (found)
+			{
+				if (!(fileAttr & FileAttr.DIRECTORY))
+					files.Insert(fileName);
+
+				found = FindNextFile(handle, fileName, fileAttr);
+			}
+			CloseFindFile(handle);
+		}
+
+		if (files.Count() == 0)
+			return;
+
+		files.Sort();
+		int now = SST_Clock.NowUnix();
+		foreach (string file : files)
+		{
+			int number = file.Substring(0, file.Length() - 7).ToInt(); // Strip ".ndjson"
+			if (number >= m_Index.nextSegment)
+				m_Index.nextSegment = number + 1;
+
+			SST_NdjsonSegment segment = ScanSegment(file);
+			if (!segment)
+				continue;
+
+			segment.firstAt = now;
+			segment.lastAt = now;
+			m_Index.segments.Insert(segment);
+		}
+
+		Print("[SST] WARNING: Rebuilt NDJSON index in " + m_Folder + " from " + m_Index.segments.Count().ToString() + " segments");
+
+		// Sizes come from a line scan; append to a fresh segment rather than behind them
+		m_RotatePending = true;
+		SaveIndex();
+	}
+
+	// Write the next index slot; the other slot keeps the previous revision until this one is complete
+	protected void SaveIndex()
+	{
+		m_IndexDirty = false;
+
+		int revision = m_Index.revision + 1;
+		SST_JsonWriter writer = new SST_JsonWriter();
+		if (!writer.Open(m_Folder + INDEX_PREFIX + (revision % INDEX_SLOTS).ToString() + ".json"))
+			return;
+
+		writer.BeginObject();
+		writer.WriteInt("revision", revision);
+		writer.WriteInt("nextSegment", m_Index.nextSegment);
+		writer.Key("segments");
+		writer.BeginArray();
+		foreach (SST_NdjsonSegment segment : m_Index.segments)
+		{
+			writer.BeginObject();
+			writer.WriteString("file", segment.file);
+			writer.WriteInt("size", segment.size);
+			writer.WriteInt("lines", segment.lines);
+			writer.WriteInt("firstAt", segment.firstAt);
+			writer.WriteInt("lastAt", segment.lastAt);
+			writer.WriteInt("firstSeq", segment.firstSeq);
+			writer.WriteInt("lastSeq", segment.lastSeq);
+			writer.EndObject();
+		}
+		writer.EndArray();
+		writer.EndObject();
+
+		if (!writer.Close())
+		{
+			Print("[SST] ERROR: Failed to write NDJSON index in " + m_Folder);
+			return;
+		}
+
+		m_Index.revision = revision;
+	}
+}
@@ -0,0 +1,270 @@
+/**
+ * @file SST_ResultsJournal.c
+ * @brief Append-only results journal per command queue, indexed by requestId.
+ *
+ * Results used to be kept in one JSON array per feature. Each batch loaded the
+ * whole file, appended to it, trimmed it to 100 entries with Remove(0) and
+ * rewrote it, and the item grant API simply overwrote it. The API had to
+ * download and parse that whole file to answer "what happened to request X?".
+ * The spool's one-file-per-result folder was pruned to 200 files.
+ *
+ * A journal is an SST_NdjsonLog with one record per completed request:
+ *
+ *   $profile:SST/api/results/<queue>/index.<0|1>.json
+ *   $profile:SST/api/results/<queue>/00000001.ndjson
+ *
+ *   {"file":"<spool file>","requestId":"...","completedAt":1718000000,"result":{...request DTO...}}
+ *
+ * Each append also adds a line to one of ID_BUCKETS small lookup files,
+ * chosen by a hash of the requestId:
+ *
+ *   $profile:SST/api/results/<queue>/ids/07.ndjson
+ *
+ *   {"requestId":"...","segment":"00000001.ndjson","offset":1234,"length":310}
+ *
+ * To look up one request, the API reads that bucket and then does one ranged
+ * read of the journal. Records are only ever appended. Besides the small
+ * segment index, the lookup buckets are the only files rewritten. They are
+ * compacted only when retention drops a journal segment, so they cover the
+ * same history as the journal (30 segments / 30 days).
+ *
+ * The segment index is not saved per result: Append marks it dirty and one
+ * SST_ResultsIndexTask saves it on the next scheduler frame, however many
+ * results completed in between.
+ *
+ * Offsets come from the in-memory segment size, so they are exact even while
+ * the index lags behind. On load the journal first re-reads the current
+ * segment to bring an index the previous session did not save up to date
+ * (RecoverCurrentSegment), then starts a new segment, so a size the previous
+ * session did not save never shifts a later offset.
+ *
+ * The requestId is reduced to [A-Za-z0-9_-] (other characters become "_"),
+ * as in spool file names. The API hashes the same reduced form (BucketOf).
+ */
+
+// JsonSerializer with the DTO's own type, like JsonFileLoader<T>
+class SST_ResultJson<Class T>
+{
+	// Compact single-line JSON of the result, "" if it could not be serialized
+	static string Write(T result)
+	{
+		string json;
+		JsonSerializer serializer = new JsonSerializer();
+		if (!serializer.WriteToString(result, false, json))
+		{
+			Print("[SST] ERROR: Could not serialize a command result");
+			return "";
+		}
+		return json;
+	}
+}
+
+class SST_ResultsJournal : Managed
+{
+	static const string RESULTS_ROOT = "$profile:SST/api/results/";
+	static const int ID_BUCKETS = 64;
+
+	protected string m_Queue;
+	protected ref SST_NdjsonLog m_Log;
+	protected string m_IdsFolder;
+
+	// Oldest journal segment the lookup buckets were compacted for
+	protected string m_OldestSegment;
+
+	// An SST_ResultsIndexTask is queued to save the segment index
+	protected bool m_IndexSaveQueued;
+
+	void SST_ResultsJournal(string queue)
+	{
+		m_Queue = queue;
+
+		if (!FileExist("$profile:SST"))
+			MakeDirectory("$profile:SST");
+		if (!FileExist("$profile:SST/api"))
+			MakeDirectory("$profile:SST/api");
+		if (!FileExist(RESULTS_ROOT))
+			MakeDirectory(RESULTS_ROOT);
+
+		m_Log = new SST_NdjsonLog(RESULTS_ROOT + queue);
+		m_IdsFolder = m_Log.GetFolder() + "ids/";
+		if (!FileExist(m_IdsFolder))
+			MakeDirectory(m_IdsFolder);
+
+		m_OldestSegment = m_Log.GetOldestSegment();
+
+		// Index saves are batched per frame (SaveIndex)
+		m_Log.DeferIndexSave();
+		m_Log.RecoverCurrentSegment();
+
+		// Lookup offsets must match the file: never append after a size the last session may not have saved
+		m_Log.Rotate();
+	}
+
+	string GetQueue()
+	{
+		return m_Queue;
+	}
+
+	// Append one result. file is the spool file it came from ("" for legacy queue files);
+	// resultJson is one JSON value (SST_ResultJson<T>.Write).
+	bool Append(string requestId, string file, string resultJson)
+	{
+		string safeId = SafeId(requestId);
+
+		SST_JsonWriter writer = m_Log.BeginAppend();
+		if (!writer)
+			return false;
+
+		SST_NdjsonSegment segment = m_Log.GetCurrentSegment();
+		string segmentFile = segment.file;
+		int offset = segment.size;
+
+		writer.BeginObject();
+		writer.WriteString("file", file);
+		writer.WriteString("requestId", safeId);
+		writer.WriteInt("completedAt", SST_Clock.NowUnix());
+		writer.Key("result");
+		writer.RawValue(resultJson);
+		writer.EndObject();
+		writer.NewLine();
+
+		bool ok = m_Log.EndAppend(writer, 1);
+		if (!ok)
+			Print("[SST] ERROR: Failed to append result " + safeId + " to journal " + m_Queue);
+		else if (safeId != "")
+			AppendLookup(safeId, segmentFile, offset, writer.GetBytesWritten());
+
+		// Retention dropped a segment: drop its lookup lines too
+		if (m_Log.GetOldestSegment() != m_OldestSegment)
+			CompactLookups();
+
+		if (!m_IndexSaveQueued)
+		{
+			m_IndexSaveQueued = true;
+			SST_FrameScheduler.Enqueue(new SST_ResultsIndexTask(this));
+		}
+
+		return ok;
+	}
+
+	// Save the segment index once for every result appended since the last save
+	void SaveIndex()
+	{
+		m_IndexSaveQueued = false;
+		m_Log.SaveIndexIfDirty();
+	}
+
+	// Characters outside [A-Za-z0-9_-] become "_"
+	static string SafeId(string requestId)
+	{
+		string safe = "";
+		for (int i = 0; i < requestId.Length(); i++)
+		{
+			string c = requestId.Get(i);
+			int code = c.ToAscii();
+			bool digit = code >= 48 && code <= 57;
+			bool upper = code >= 65 && code <= 90;
+			bool lower = code >= 97 && code <= 122;
+			if (digit || upper || lower || c == "_" || c == "-")
+				safe += c;
+			else
+				safe += "_";
+		}
+		return safe;
+	}
+
+	// 31-based string hash on 32-bit ints; spool.js computes the same
+	static int BucketOf(string safeId)
+	{
+		int hash = 0;
+		for (int i = 0; i < safeId.Length(); i++)
+			hash = hash * 31 + safeId.Get(i).ToAscii();
+
+		return (hash & 0x7FFFFFFF) % ID_BUCKETS;
+	}
+
+	protected string GetBucketPath(int bucket)
+	{
+		return m_IdsFolder + bucket.ToStringLen(2) + ".ndjson";
+	}
+
+	protected void AppendLookup(string safeId, string segmentFile, int offset, int length)
+	{
+		SST_JsonWriter writer = new SST_JsonWriter();
+		if (!writer.Open(GetBucketPath(BucketOf(safeId)), true))
+			return;
+
+		writer.BeginObject();
+		writer.WriteString("requestId", safeId);
+		writer.WriteString("segment", segmentFile);
+		writer.WriteInt("offset", offset);
+		writer.WriteInt("length", length);
+		writer.EndObject();
+		writer.NewLine();
+
+		if (!writer.Close())
+			Print("[SST] ERROR: Failed to index result " + safeId + " in journal " + m_Queue);
+	}
+
+	// Rewrite every bucket without the lines of segments retention has deleted
+	protected void CompactLookups()
+	{
+		m_OldestSegment = m_Log.GetOldestSegment();
+		int oldest = m_OldestSegment.Substring(0, 8).ToInt();
+
+		for (int bucket = 0; bucket < ID_BUCKETS; bucket++)
+		{
+			string path = GetBucketPath(bucket);
+			if (!FileExist(path))
+				continue;
+
+			array<string> kept = new array<string>();
+			int dropped = 0;
+
+			FileHandle input = OpenFile(path, FileMode.READ);
+			if (!input)
+				continue;
+
+			string line;
+			while (FGets(input, line) >= 0)
+			{
+				int at = line.IndexOf("\"segment\":\"");
+				if (at == -1)
+					continue;
+
+				if (line.Substring(at + 11, 8).ToInt() >= oldest)
+					kept.Insert(line);
+				else
+					dropped++;
+			}
+			CloseFile(input);
+
+			if (dropped == 0)
+				continue;
+
+			FileHandle output = OpenFile(path, FileMode.WRITE);
+			if (!output)
+				continue;
+
+			foreach (string keptLine : kept)
+				FPrintln(output, keptLine);
+			CloseFile(output);
+		}
+	}
+}
+
+class SST_ResultsIndexTask : SST_SchedulerTask
+{
+	protected SST_ResultsJournal m_Journal;  // Weak
+
+	void SST_ResultsIndexTask(SST_ResultsJournal journal)
+	{
+		m_Journal = journal;
+	}
+
+	override void Run()
+	{
+		if (m_Journal)
+			m_Journal.SaveIndex();
+	}
+}
@@ -0,0 +1,420 @@
+/**
+ * @file SST_SnapshotPublisher.c
+ * @brief Double-buffered snapshot generations published through a manifest.
+ *
+ * Exporters never rewrite a file the API might be reading. Each export goes
+ * into a new generation file:
+ *
+ *   $profile:SST/snapshots/<channel>/<name>.<generation>.json
+ *
+ * and is only published once it is fully written, by updating the channel's
+ * small manifest (file name, generation, size, content hash).
+ *
+ * The manifest itself is never rewritten in place. Commits alternate between
+ * manifest.0.json and manifest.1.json, and each carries a revision number.
+ * Readers take the highest revision that parses, so a slot caught mid-write
+ * simply loses to the other one.
+ *
+ * A replaced generation (or the file of a removed entry) is retired, not
+ * deleted: it stays on disk for RETIRE_SECONDS, well past the time an API
+ * caches a manifest, so a reader holding an older manifest can still open
+ * every file it names.
+ *
+ * For older API versions and tools that read the original paths, the finished
+ * file is also copied to its legacy location (LEGACY_COPY).
+ */
+
+// One published snapshot in a channel manifest
+class SST_SnapshotEntry
+{
+	string name;               // Logical name, e.g. "online_players" or a Steam64 ID
+	string file;               // Current generation file, relative to the channel folder
+	int generation;            // Generation number of 'file'
+	int size;                  // Bytes in 'file'
+	string hash;               // Content hash of 'file' (SST_JsonWriter.GetContentHash)
+	string previousFile;       // Generation before 'file' (retired, kept for RETIRE_SECONDS)
+	int publishedAt;           // Epoch seconds 'file' was published
+}
+
+// A generation file no manifest entry points to any more, deleted after RETIRE_SECONDS
+class SST_SnapshotRetired
+{
+	string file;
+	int retiredAt;             // Epoch seconds
+}
+
+// manifest.<slot>.json of a snapshot channel
+class SST_SnapshotManifest
+{
+	int revision;              // Incremented on every commit; readers take the highest one
+	int generation;            // Last generation number handed out in this channel
+	ref array<ref SST_SnapshotEntry> entries = new array<ref SST_SnapshotEntry>();
+	ref array<ref SST_SnapshotRetired> retired = new array<ref SST_SnapshotRetired>();
+}
+
+class SST_SnapshotPublisher
+{
+	static const string SNAPSHOT_ROOT = "$profile:SST/snapshots/";
+	static const string MANIFEST_PREFIX = "manifest.";         // manifest.0.json / manifest.1.json
+	static const string LEGACY_MANIFEST_NAME = "manifest.json";  // Rewritten in place before the slots; read once, then deleted
+	static const int MANIFEST_SLOTS = 2;
+	static const int RETIRE_SECONDS = 60;                       // API manifest cache (2 s by default) plus a wide margin
+
+	// Also copy each published snapshot to the pre-manifest file path
+	static const bool LEGACY_COPY = true;
+
+	protected static ref map<string, ref SST_SnapshotPublisher> s_Publishers;
+
+	protected string m_Channel;
+	protected string m_Folder;
+	protected int m_Generation;
+	protected int m_Revision;
+	protected ref map<string, ref SST_SnapshotEntry> m_Entries;
+	protected ref array<ref SST_SnapshotRetired> m_Retired;
+	protected bool m_ManifestDirty;
+
+	// name -> generation file opened by Begin() and not yet published
+	protected ref map<string, string> m_PendingFiles;
+
+	void SST_SnapshotPublisher(string channel)
+	{
+		m_Channel = channel;
+		m_Folder = SNAPSHOT_ROOT + channel + "/";
+		m_Entries = new map<string, ref SST_SnapshotEntry>();
+		m_Retired = new array<ref SST_SnapshotRetired>();
+		m_PendingFiles = new map<string, string>();
+
+		if (!FileExist("$profile:SST"))
+			MakeDirectory("$profile:SST");
+		if (!FileExist(SNAPSHOT_ROOT))
+			MakeDirectory(SNAPSHOT_ROOT);
+		if (!FileExist(m_Folder))
+			MakeDirectory(m_Folder);
+
+		LoadManifest();
+		PurgeUnreferencedFiles();
+	}
+
+	// One publisher (and manifest) per channel folder
+	static SST_SnapshotPublisher Get(string channel)
+	{
+		if (!s_Publishers)
+			s_Publishers = new map<string, ref SST_SnapshotPublisher>();
+
+		SST_SnapshotPublisher publisher = s_Publishers.Get(channel);
+		if (!publisher)
+		{
+			publisher = new SST_SnapshotPublisher(channel);
+			s_Publishers.Set(channel, publisher);
+		}
+		return publisher;
+	}
+
+	// Open the next generation file for name; null if it could not be created
+	SST_JsonWriter Begin(string name)
+	{
+		m_Generation++;
+		string fileName = name + "." + m_Generation.ToString() + ".json";
+
+		SST_JsonWriter writer = new SST_JsonWriter();
+		if (!writer.Open(m_Folder + fileName))
+			return null;
+
+		m_PendingFiles.Set(name, fileName);
+		return writer;
+	}
+
+	// Close the writer and make its file the current generation of name.
+	// Set commit to false when publishing a batch and call Commit() once at the end.
+	bool Publish(string name, SST_JsonWriter writer, string legacyPath = "", bool commit = true)
+	{
+		string fileName;
+		if (!writer || !m_PendingFiles.Find(name, fileName))
+			return false;
+
+		m_PendingFiles.Remove(name);
+
+		if (!writer.Close())
+		{
+			DeleteFile(m_Folder + fileName);
+			Print("[SST] ERROR: Snapshot " + m_Channel + "/" + name + " was not published");
+			return false;
+		}
+
+		SST_SnapshotEntry entry = m_Entries.Get(name);
+		if (!entry)
+		{
+			entry = new SST_SnapshotEntry();
+			entry.name = name;
+			m_Entries.Set(name, entry);
+		}
+		else if (entry.hash == writer.GetContentHash() && entry.size == writer.GetBytesWritten())
+		{
+			// Identical content: keep the published generation so readers can skip it
+			DeleteFile(m_Folder + fileName);
+			return true;
+		}
+
+		// Readers still on an older manifest may open the replaced generation
+		Retire(entry.file);
+
+		entry.previousFile = entry.file;
+		entry.file = fileName;
+		entry.generation = m_Generation;
+		entry.size = writer.GetBytesWritten();
+		entry.hash = writer.GetContentHash();
+		entry.publishedAt = SST_Clock.NowUnix();
+		m_ManifestDirty = true;
+
+		if (LEGACY_COPY && legacyPath != "")
+		{
+			DeleteFile(legacyPath);
+			if (!CopyFile(m_Folder + fileName, legacyPath))
+				Print("[SST] WARNING: Snapshot legacy copy failed: " + legacyPath);
+		}
+
+		if (commit)
+			Commit();
+
+		return true;
+	}
+
+	// Drop name from the manifest; its files are retired like replaced generations.
+	// Set commit to false when removing several names and call Commit() once at the end.
+	void Remove(string name, bool commit = true)
+	{
+		SST_SnapshotEntry entry = m_Entries.Get(name);
+		if (!entry)
+			return;
+
+		// previousFile was retired when it was replaced
+		Retire(entry.file);
+		m_Entries.Remove(name);
+		m_ManifestDirty = true;
+
+		if (commit)
+			Commit();
+	}
+
+	// Names whose current generation was published more than maxAgeSeconds ago
+	void GetNamesPublishedBefore(int maxAgeSeconds, notnull array<string> names)
+	{
+		names.Clear();
+		int cutoff = SST_Clock.NowUnix() - maxAgeSeconds;
+		for (int i = 0; i < m_Entries.Count(); i++)
+		{
+			if (m_Entries.GetElement(i).publishedAt < cutoff)
+				names.Insert(m_Entries.GetKey(i));
+		}
+	}
+
+	// True if name has a published generation that is still on disk
+	bool HasSnapshot(string name)
+	{
+		SST_SnapshotEntry entry = m_Entries.Get(name);
+		return entry && entry.file != "" && FileExist(m_Folder + entry.file);
+	}
+
+	// Generation number of the current snapshot of name, 0 if none was published
+	int GetGeneration(string name)
+	{
+		SST_SnapshotEntry entry = m_Entries.Get(name);
+		if (!entry)
+			return 0;
+
+		return entry.generation;
+	}
+
+	// Full path of the current generation of name, "" if there is none
+	string GetSnapshotPath(string name)
+	{
+		if (!HasSnapshot(name))
+			return "";
+
+		return m_Folder + m_Entries.Get(name).file;
+	}
+
+	// Write the next manifest slot if anything changed since the last commit
+	bool Commit()
+	{
+		DeleteExpiredFiles();
+		if (!m_ManifestDirty)
+			return true;
+
+		int revision = m_Revision + 1;
+		SST_JsonWriter writer = new SST_JsonWriter();
+		if (!writer.Open(GetManifestPath(revision)))
+			return false;
+
+		writer.BeginObject();
+		writer.WriteInt("revision", revision);
+		writer.WriteInt("generation", m_Generation);
+		writer.Key("entries");
+		writer.BeginArray();
+		for (int i = 0; i < m_Entries.Count(); i++)
+		{
+			SST_SnapshotEntry entry = m_Entries.GetElement(i);
+			writer.BeginObject();
+			writer.WriteString("name", entry.name);
+			writer.WriteString("file", entry.file);
+			writer.WriteInt("generation", entry.generation);
+			writer.WriteInt("size", entry.size);
+			writer.WriteString("hash", entry.hash);
+			writer.WriteString("previousFile", entry.previousFile);
+			writer.WriteInt("publishedAt", entry.publishedAt);
+			writer.EndObject();
+		}
+		writer.EndArray();
+		writer.Key("retired");
+		writer.BeginArray();
+		foreach (SST_SnapshotRetired retired : m_Retired)
+		{
+			writer.BeginObject();
+			writer.WriteString("file", retired.file);
+			writer.WriteInt("retiredAt", retired.retiredAt);
+			writer.EndObject();
+		}
+		writer.EndArray();
+		writer.EndObject();
+
+		if (!writer.Close())
+		{
+			// The other slot still holds the last good revision
+			Print("[SST] ERROR: Failed to write snapshot manifest for " + m_Channel);
+			return false;
+		}
+
+		m_Revision = revision;
+		m_ManifestDirty = false;
+		return true;
+	}
+
+	protected string GetManifestPath(int revision)
+	{
+		return m_Folder + MANIFEST_PREFIX + (revision % MANIFEST_SLOTS).ToString() + ".json";
+	}
+
+	protected void Retire(string fileName)
+	{
+		if (fileName == "")
+			return;
+
+		SST_SnapshotRetired retired = new SST_SnapshotRetired();
+		retired.file = fileName;
+		retired.retiredAt = SST_Clock.NowUnix();
+		m_Retired.Insert(retired);
+		m_ManifestDirty = true;
+	}
+
+	// Delete retired files no current manifest reader can still be looking for
+	protected void DeleteExpiredFiles()
+	{
+		int cutoff = SST_Clock.NowUnix() - RETIRE_SECONDS;
+		for (int i = m_Retired.Count() - 1; i >= 0; i--)
+		{
+			if (m_Retired[i].retiredAt > cutoff)
+				continue;
+
+			DeleteFile(m_Folder + m_Retired[i].file);
+			m_Retired.Remove(i);
+			m_ManifestDirty = true;
+		}
+	}
+
+	// Continue generation numbering from the newest manifest so files never collide across restarts
+	protected void LoadManifest()
+	{
+		SST_SnapshotManifest newest;
+		for (int slot = 0; slot < MANIFEST_SLOTS; slot++)
+		{
+			SST_SnapshotManifest manifest = ReadManifest(m_Folder + MANIFEST_PREFIX + slot.ToString() + ".json");
+			if (manifest && (!newest || manifest.revision > newest.revision))
+				newest = manifest;
+		}
+
+		// Manifest from before the slots: adopt it, then stop leaving it on the read path
+		string legacyPath = m_Folder + LEGACY_MANIFEST_NAME;
+		if (!newest)
+		{
+			newest = ReadManifest(legacyPath);
+			if (newest)
+				m_ManifestDirty = true;
+		}
+		DeleteFile(legacyPath);
+
+		if (!newest)
+			return;
+
+		m_Revision = newest.revision;
+		m_Generation = newest.generation;
+		foreach (SST_SnapshotEntry entry : newest.entries)
+		{
+			if (entry && entry.name != "")
+				m_Entries.Set(entry.name, entry);
+		}
+		foreach (SST_SnapshotRetired retired : newest.retired)
+		{
+			if (retired && retired.file != "")
+				m_Retired.Insert(retired);
+		}
+
+		if (m_ManifestDirty)
+			Commit();
+	}
+
+	protected static SST_SnapshotManifest ReadManifest(string path)
+	{
+		if (!FileExist(path))
+			return null;
+
+		SST_SnapshotManifest manifest = new SST_SnapshotManifest();
+		string errorMsg;
+		if (!JsonFileLoader<SST_SnapshotManifest>.LoadFile(path, manifest, errorMsg))
+		{
+			Print("[SST] WARNING: Could not read snapshot manifest " + path + ": " + errorMsg);
+			return null;
+		}
+
+		return manifest;
+	}
+
+	// Delete generation files left behind by a crash or an unclean shutdown
+	protected void PurgeUnreferencedFiles()
+	{
+		map<string, bool> referenced = new map<string, bool>();
+		for (int slot = 0; slot < MANIFEST_SLOTS; slot++)
+			referenced.Set(MANIFEST_PREFIX + slot.ToString() + ".json", true);
+		for (int i = 0; i < m_Entries.Count(); i++)
+		{
+			SST_SnapshotEntry entry = m_Entries.GetElement(i);
+			referenced.Set(entry.file, true);
+			if (entry.previousFile != "")
+				referenced.Set(entry.previousFile, true);
+		}
+		foreach (SST_SnapshotRetired retired : m_Retired)
+			referenced.Set(retired.file, true);
+
+		array<string> stale = new array<string>();
+		string fileName;
+		FileAttr fileAttr;
+		FindFileHandle handle = FindFile(m_Folder + "*.json", fileName, fileAttr, 0);
+		if (!handle)
+			return;
+
+		bool found = true;
+		while (found)
+		{
+			if (!(fileAttr & FileAttr.DIRECTORY) && !referenced.Contains(fileName))
+				stale.Insert(fileName);
+
+			found = FindNextFile(handle, fileName, fileAttr);
+		}
+		CloseFindFile(handle);
+
+		foreach (string staleFile : stale)
+			DeleteFile(m_Folder + staleFile);
+
+		if (stale.Count() > 0)
+			Print("[SST] Snapshot channel " + m_Channel + ": removed " + stale.Count().ToString() + " stale files");
+	}
+}
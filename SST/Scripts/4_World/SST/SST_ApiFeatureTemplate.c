@@ -1,12 +1,13 @@
 /**
  * @file SST_ApiFeatureTemplate.c
- * @brief Template for extending SST with a new API-backed feature (JSON queue + results + optional export).
+ * @brief Template for extending SST with a new API-backed feature (command spool + results + optional export).
  *
  * SST uses a simple file-based bridge between the DayZ server runtime and the external API:
  *
  *   1) API -> Server (commands)
- *      - The API writes a JSON "queue" file under: $profile:SST/api/
- *      - The server periodically reads the queue, executes requests, then writes a results file.
+ *      - The API drops one JSON file per request into a spool: $profile:SST/api/spool/<queue>/incoming/
+ *      - The server periodically claims the files, executes them, then appends each result to the
+ *        queue's results journal: $profile:SST/api/results/<queue>/ (see SST_CommandSpool, SST_ResultsJournal).
  *
  *   2) Server -> API (exports)
  *      - The server writes JSON snapshots/logs under: $profile:SST/
@@ -19,12 +20,13 @@
  * --------------------------------------------------------------------------------------------
  * 1) Copy this file and rename it to your feature, e.g. `SST_MyFeature.c`.
  * 2) Rename the DTO classes and the service class (search/replace `SST_Template*`).
- * 3) Choose unique filenames for your queue/results/export.
+ * 3) Choose a unique SPOOL_QUEUE name and export filename.
  * 4) Call `SST_TemplateService.Start()` from your init entrypoint (usually 5_Mission init)
  *    or wherever your mod currently starts services.
  * 5) Update the Node API:
- *    - Create an endpoint that WRITES queue JSON to QUEUE_FILE.
- *    - Create an endpoint that READS RESULT_FILE (and/or EXPORT_FILE).
+ *    - Create an endpoint that queues requests with enqueueSpool(SPOOL_QUEUE, request) (utils/spool.js).
+ *    - Create an endpoint that reads them back with readSpoolResults(SPOOL_QUEUE) (and/or EXPORT_FILE),
+ *      and one for a single request with readSpoolResult(SPOOL_QUEUE, requestId).
  *
  * Notes:
  * - Do not put secrets in JSON files.
@@ -66,14 +68,10 @@ class SST_TemplateRequest
 }
 
 /**
- * @brief Root queue file structure (array wrapper).
+ * @brief Array wrapper, for fixtures written with SST_TemplateApi.GenerateJSONFile().
  *
- * Queue JSON should look like:
- * {
- *   "requests": [
- *     { "requestId":"...", "playerId":"...", "action":"...", "payloadText":"...", "processed":false }
- *   ]
- * }
+ * Spool files hold a single SST_TemplateRequest:
+ * { "requestId":"...", "playerId":"...", "action":"...", "payloadText":"...", "processed":false }
  */
 class SST_TemplateQueue
 {
@@ -104,7 +102,7 @@ class SST_TemplateExport
  * @brief Convenience helpers to create/enqueue requests and write JSON.
  *
  * Important:
- * - In production, the external Node API is typically responsible for writing queue files.
+ * - In production, the external Node API is typically responsible for writing spool files.
  * - These helpers exist so contributors can quickly test features from in-game scripts,
  *   admin tools, or debug commands without re-implementing JSON plumbing.
  */
@@ -113,7 +111,7 @@ class SST_TemplateApi
 	// Uses the same paths as SST_TemplateService.
 	static const string PROFILE_ROOT = "$profile:SST";
 	static const string API_FOLDER = "$profile:SST/api";
-	static const string QUEUE_FILE = "$profile:SST/api/template_queue.json";
+	static const string SPOOL_QUEUE = "template";
 
 	static void EnsureFolders()
 	{
@@ -139,38 +137,23 @@ class SST_TemplateApi
 		req.processed = false;
 		req.status = "pending";
 		req.result = "";
-		req.requestId = SST_TemplateService.GetUTCTimestamp();
+		req.requestId = "tpl_" + SST_Clock.NowUnix().ToString() + "_" + Math.RandomInt(0, 100000).ToString();
 		return req;
 	}
 
 	/**
-	 * @brief Append a request to the queue JSON file.
-	 *
-	 * Queue file schema:
-	 * { "requests": [ { ... }, { ... } ] }
+	 * @brief Drop a request into the spool, as the API would.
 	 */
 	static bool EnqueueRequest(SST_TemplateRequest req)
 	{
 		EnsureFolders();
 
-		ref SST_TemplateQueue queue;
+		SST_CommandSpool spool = new SST_CommandSpool(SPOOL_QUEUE);
 		string errorMsg;
 
-		if (FileExist(QUEUE_FILE))
-		{
-			JsonFileLoader<SST_TemplateQueue>.LoadFile(QUEUE_FILE, queue, errorMsg);
-		}
-
-		if (!queue)
-			queue = new SST_TemplateQueue();
-		if (!queue.requests)
-			queue.requests = new array<ref SST_TemplateRequest>();
-
-		queue.requests.Insert(req);
-
-		if (!JsonFileLoader<SST_TemplateQueue>.SaveFile(QUEUE_FILE, queue, errorMsg))
+		if (!JsonFileLoader<SST_TemplateRequest>.SaveFile(spool.NewIncomingPath(req.requestId), req, errorMsg))
 		{
-			Print("[SST] TemplateApi: failed to write queue: " + errorMsg);
+			Print("[SST] TemplateApi: failed to write request: " + errorMsg);
 			return false;
 		}
 
@@ -213,7 +196,7 @@ class SST_TemplateApi
  *
  * This class does nothing unless `Start()` is called.
  */
-class SST_TemplateService
+class SST_TemplateService : SST_CommandHandler
 {
 	protected static ref SST_TemplateService s_Instance;
 
@@ -221,8 +204,8 @@ class SST_TemplateService
 	static const string PROFILE_ROOT = "$profile:SST";
 	static const string API_FOLDER = "$profile:SST/api";
 
-	static const string QUEUE_FILE = "$profile:SST/api/template_queue.json";
-	static const string RESULT_FILE = "$profile:SST/api/template_results.json";
+	// Spool folder name under $profile:SST/api/spool/
+	static const string SPOOL_QUEUE = "template";
 
 	// Optional export (Server -> API)
 	static const string EXPORT_FILE = "$profile:SST/template_export.json";
@@ -232,6 +215,7 @@ class SST_TemplateService
 	static const float EXPORT_INTERVAL_MS = 15000.0;
 
 	protected bool m_Initialized;
+	protected ref SST_CommandSpool m_Spool;
 
 	void SST_TemplateService() {}
 
@@ -263,6 +247,8 @@ class SST_TemplateService
 		if (!GetGame().IsServer())
 			return;
 
+		m_Spool = new SST_CommandSpool(SPOOL_QUEUE);
+
 		Print("[SST] TemplateService started (queue poll=" + QUEUE_POLL_INTERVAL_MS.ToString() + "ms)");
 
 		// Start loops
@@ -285,44 +271,37 @@ class SST_TemplateService
 		if (!GetGame().IsServer())
 			return;
 
-		if (!FileExist(QUEUE_FILE))
-			return;
+		// Move waiting request files to processing/; an empty poll is one directory listing.
+		// SST_CommandExecutor calls ExecuteSpooled() for each of them within its per-frame budget.
+		SST_CommandExecutor.GetInstance().Pull(m_Spool, this);
+	}
 
-		ref SST_TemplateQueue queue;
+	override void ExecuteSpooled(SST_CommandSpool spool, string fileName)
+	{
+		ref SST_TemplateRequest req;
 		string errorMsg;
 
-		if (!JsonFileLoader<SST_TemplateQueue>.LoadFile(QUEUE_FILE, queue, errorMsg))
+		if (!JsonFileLoader<SST_TemplateRequest>.LoadFile(m_Spool.GetProcessingPath(fileName), req, errorMsg) || !req)
 		{
-			Print("[SST] TemplateService: failed to load queue: " + errorMsg);
-			return;
+			Print("[SST] TemplateService: failed to load request " + fileName + ": " + errorMsg);
+			req = new SST_TemplateRequest();
+			req.processed = true;
+			req.status = "failed";
+			req.result = "INVALID_REQUEST";
 		}
-
-		if (!queue || !queue.requests || queue.requests.Count() == 0)
-			return;
-
-		bool didWork;
-
-		foreach (SST_TemplateRequest req : queue.requests)
+		else if (m_Spool.IsRecovered(fileName))
 		{
-			if (!req || req.processed)
-				continue;
-
-			didWork = true;
-			HandleRequest(req);
+			// Claimed before a restart; don't run it twice
+			req.processed = true;
+			req.status = "failed";
+			req.result = "INTERRUPTED";
 		}
-
-		if (!didWork)
-			return;
-
-		// Write results (same structure; requests are now annotated with status/result)
-		if (!JsonFileLoader<SST_TemplateQueue>.SaveFile(RESULT_FILE, queue, errorMsg))
+		else
 		{
-			Print("[SST] TemplateService: failed to save results: " + errorMsg);
+			HandleRequest(req);
 		}
 
-		// Clear queue (so API can write new commands cleanly)
-		ref SST_TemplateQueue emptyQueue = new SST_TemplateQueue();
-		JsonFileLoader<SST_TemplateQueue>.SaveFile(QUEUE_FILE, emptyQueue, errorMsg);
+		m_Spool.Complete(fileName, SST_ResultJson<SST_TemplateRequest>.Write(req));
 	}
 
 	/**
@@ -336,7 +315,7 @@ class SST_TemplateService
 	protected void HandleRequest(SST_TemplateRequest req)
 	{
 		req.processed = true;
-		req.processedAt = GetUTCTimestamp();
+		req.processedAt = SST_Clock.Now();
 
 		// Example: validate required fields
 		if (!req.action || req.action == "")
@@ -349,7 +328,8 @@ class SST_TemplateService
 		// Example: player-targeted action
 		if (req.playerId && req.playerId != "")
 		{
-			PlayerBase player = FindPlayerBySteamId(req.playerId);
+			// Online players are indexed by Steam64 (plain id); no scan of GetPlayers() per request
+			PlayerBase player = SST_PlayerIndex.FindBySteamId(req.playerId);
 			if (!player)
 			{
 				req.status = "failed";
@@ -382,7 +362,7 @@ class SST_TemplateService
 			return;
 
 		ref SST_TemplateExport snapshot = new SST_TemplateExport();
-		snapshot.generatedAt = GetUTCTimestamp();
+		snapshot.generatedAt = SST_Clock.Now();
 
 		// Example: write a heartbeat entry
 		ref SST_TemplateExportEntry entry = new SST_TemplateExportEntry();
@@ -397,46 +377,4 @@ class SST_TemplateService
 			Print("[SST] TemplateService: failed to save export: " + errorMsg);
 		}
 	}
-
-	// --------------------------------------------------------------------------------------------
-	// Helpers
-	// --------------------------------------------------------------------------------------------
-
-	static string GetUTCTimestamp()
-	{
-		int year, month, day, hour, minute, second;
-		GetYearMonthDayUTC(year, month, day);
-		GetHourMinuteSecondUTC(hour, minute, second);
-		return string.Format("%1-%2-%3T%4:%5:%6Z",
-			year.ToStringLen(4),
-			month.ToStringLen(2),
-			day.ToStringLen(2),
-			hour.ToStringLen(2),
-			minute.ToStringLen(2),
-			second.ToStringLen(2));
-	}
-
-	/**
-	 * @brief Utility: find a PlayerBase by identity plain id (Steam64).
-	 *
-	 * This is a common pattern used in SST command handlers.
-	 */
-	static PlayerBase FindPlayerBySteamId(string steamId)
-	{
-		array<Man> players = new array<Man>();
-		GetGame().GetPlayers(players);
-
-		foreach (Man man : players)
-		{
-			PlayerBase pb = PlayerBase.Cast(man);
-			if (!pb)
-				continue;
-
-			PlayerIdentity ident = pb.GetIdentity();
-			if (ident && ident.GetPlainId() == steamId)
-				return pb;
-		}
-
-		return null;
-	}
 }
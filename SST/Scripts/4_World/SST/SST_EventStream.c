@@ -0,0 +1,148 @@
+/**
+ * @file SST_EventStream.c
+ * @brief Server-wide event stream with a global sequence number.
+ *
+ * The per-player logs answer "what did this player do". For a server-wide
+ * activity feed the API would otherwise have to read and merge every player's
+ * events, life and trade files. Every event those loggers record is also
+ * appended here, in the order it was recorded, as one NDJSON line:
+ *
+ *   {"seq":1042,"stream":"life","event":{...same fields as in the player log...}}
+ *
+ * seq increases by one per record across all streams and restarts. It is
+ * stored in the segment index (SST_NdjsonLog, firstSeq/lastSeq), so the API can
+ * jump to the segment holding "everything after seq N" and tail from there.
+ *
+ * Folder: $profile:SST/history/stream/ (index slots + segments, same retention as
+ * the per-player history). Records are buffered and written through SST_LogSink.
+ */
+
+class SST_EventStreamType
+{
+	static const string INVENTORY = "inventory";   // SST_InventoryEventData
+	static const string LIFE = "life";             // SST_PlayerLifeEventData
+	static const string TRADE = "trade";           // SST_TradeEventData
+}
+
+// One buffered record; exactly one of the event refs is set
+class SST_EventStreamRecord
+{
+	int seq;
+	string stream;
+	ref SST_InventoryEventData inventoryEvent;
+	ref SST_PlayerLifeEventData lifeEvent;
+	ref SST_TradeEventData trade;
+}
+
+class SST_EventStream : SST_LogSinkClient
+{
+	protected static ref SST_EventStream s_Instance;
+	static const string STREAM_FOLDER = "$profile:SST/history/stream/";
+	static const string SINK_KEY = "server";
+
+	protected ref SST_NdjsonLog m_Log;
+	protected int m_LastSeq;
+
+	// Records not written yet, in sequence order
+	protected ref array<ref SST_EventStreamRecord> m_Pending;
+
+	void SST_EventStream()
+	{
+		m_Pending = new array<ref SST_EventStreamRecord>();
+
+		if (!FileExist("$profile:SST"))
+			MakeDirectory("$profile:SST");
+		if (!FileExist(SST_NdjsonLog.HISTORY_ROOT))
+			MakeDirectory(SST_NdjsonLog.HISTORY_ROOT);
+
+		// Continue the sequence where the last session stopped. The index is saved after each
+		// append, so take the last seq from the newest segment itself, and start a new segment
+		// so nothing is appended behind bytes the index may not account for.
+		m_Log = new SST_NdjsonLog(STREAM_FOLDER);
+		m_LastSeq = m_Log.RecoverCurrentSegment();
+		m_Log.Rotate();
+	}
+
+	static SST_EventStream GetInstance()
+	{
+		if (!s_Instance)
+			s_Instance = new SST_EventStream();
+		return s_Instance;
+	}
+
+	int GetLastSeq()
+	{
+		return m_LastSeq;
+	}
+
+	void AppendInventoryEvent(SST_InventoryEventData eventData)
+	{
+		SST_EventStreamRecord record = new SST_EventStreamRecord();
+		record.stream = SST_EventStreamType.INVENTORY;
+		record.inventoryEvent = eventData;
+		Append(record);
+	}
+
+	void AppendLifeEvent(SST_PlayerLifeEventData eventData)
+	{
+		SST_EventStreamRecord record = new SST_EventStreamRecord();
+		record.stream = SST_EventStreamType.LIFE;
+		record.lifeEvent = eventData;
+		Append(record);
+	}
+
+	void AppendTrade(SST_TradeEventData tradeData)
+	{
+		SST_EventStreamRecord record = new SST_EventStreamRecord();
+		record.stream = SST_EventStreamType.TRADE;
+		record.trade = tradeData;
+		Append(record);
+	}
+
+	protected void Append(SST_EventStreamRecord record)
+	{
+		m_LastSeq++;
+		record.seq = m_LastSeq;
+		m_Pending.Insert(record);
+
+		SST_LogSink.GetInstance().Append(this, SINK_KEY);
+	}
+
+	override string GetLogSinkName()
+	{
+		return "event_stream";
+	}
+
+	override bool FlushLog(string key)
+	{
+		if (m_Pending.Count() == 0)
+			return true;
+
+		SST_JsonWriter writer = m_Log.BeginAppend();
+		if (!writer)
+			return false; // Keep the records for the next flush
+
+		foreach (SST_EventStreamRecord record : m_Pending)
+		{
+			writer.BeginObject();
+			writer.WriteInt("seq", record.seq);
+			writer.WriteString("stream", record.stream);
+			writer.Key("event");
+			if (record.inventoryEvent)
+				SST_JsonExport.WriteInventoryEvent(writer, record.inventoryEvent);
+			else if (record.lifeEvent)
+				SST_JsonExport.WriteLifeEvent(writer, record.lifeEvent);
+			else if (record.trade)
+				SST_TradeLogger.WriteTradeEvent(writer, record.trade);
+			else
+				writer.NullValue();
+			writer.EndObject();
+			writer.NewLine();
+		}
+
+		int lastSeq = m_Pending[m_Pending.Count() - 1].seq;
+		bool appended = m_Log.EndAppend(writer, m_Pending.Count(), lastSeq);
+		m_Pending.Clear();
+		return appended;
+	}
+}
@@ -3,7 +3,8 @@
  * @brief Expansion Vehicles hook to detect trader purchases and log them.
  *
  * Hooks ExpansionCarKey.PairToVehicle() to record vehicle purchases when keys are
- * paired during an Expansion trader transaction.
+ * paired during an Expansion trader transaction, and to record every pairing in
+ * SST_VehicleRegistry's key id map.
  */
 
 #ifdef EXPANSIONMODVEHICLE
@@ -17,6 +18,10 @@ modded class ExpansionCarKey
 		// Call the original method first
 		super.PairToVehicle(vehicle);
 		
+		// Keep the key id -> vehicle map current for key/delete requests, whoever paired it
+		if (vehicle && GetGame().IsServer())
+			SST_VehicleTracker.IndexVehicle(vehicle.GetEntity());
+		
 		// Get the owner player from the key's hierarchy
 		PlayerBase player = PlayerBase.Cast(GetHierarchyRootPlayer());
 		
@@ -34,9 +39,7 @@ modded class ExpansionCarKey
 			}
 			
 			// Also check if this vehicle is already tracked to avoid duplicates
-			int va, vb, vc, vd;
-			vehicle.GetMasterKeyPersistentID(va, vb, vc, vd);
-			string vehicleId = va.ToString() + "-" + vb.ToString() + "-" + vc.ToString() + "-" + vd.ToString();
+			string vehicleId = SST_VehicleTracker.GetVehicleId(vehicle);
 			
 			if (SST_VehicleTracker.IsVehicleTracked(vehicleId))
 			{
@@ -0,0 +1,73 @@
+/**
+ * @file SST_InventoryDirtyTracker.c
+ * @brief Tracks which players have inventory changes that have not been exported yet.
+ *
+ * Gameplay hooks (item moves, quantity and health changes, deletes) mark the
+ * owning player as dirty. The mission-side inventory exporter only re-serializes
+ * dirty players, plus a periodic forced refresh of everyone as a safety net.
+ */
+
+class SST_InventoryDirtyTracker
+{
+	protected static ref SST_InventoryDirtyTracker s_Instance;
+
+	// Steam64 -> mission time (ms) of the first change since the last export
+	protected ref map<string, int> m_DirtyPlayers;
+
+	void SST_InventoryDirtyTracker()
+	{
+		m_DirtyPlayers = new map<string, int>();
+	}
+
+	static SST_InventoryDirtyTracker GetInstance()
+	{
+		if (!s_Instance)
+			s_Instance = new SST_InventoryDirtyTracker();
+		return s_Instance;
+	}
+
+	// Mark the player owning this entity (if any) as dirty
+	static void MarkEntityOwner(EntityAI entity)
+	{
+		if (!entity)
+			return;
+
+		MarkPlayer(entity.GetHierarchyRootPlayer());
+	}
+
+	static void MarkPlayer(Man player)
+	{
+		if (!player)
+			return;
+
+		PlayerIdentity identity = player.GetIdentity();
+		if (!identity)
+			return;
+
+		GetInstance().MarkDirty(identity.GetPlainId());
+	}
+
+	void MarkDirty(string playerId)
+	{
+		if (playerId == "" || m_DirtyPlayers.Contains(playerId))
+			return;
+
+		m_DirtyPlayers.Set(playerId, GetGame().GetTime());
+	}
+
+	bool IsDirty(string playerId)
+	{
+		return m_DirtyPlayers.Contains(playerId);
+	}
+
+	// Called by the exporter once the player's inventory has been written
+	void ClearDirty(string playerId)
+	{
+		m_DirtyPlayers.Remove(playerId);
+	}
+
+	int GetDirtyCount()
+	{
+		return m_DirtyPlayers.Count();
+	}
+}
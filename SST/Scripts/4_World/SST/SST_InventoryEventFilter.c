@@ -0,0 +1,226 @@
+/**
+ * @file SST_InventoryEventFilter.c
+ * @brief Noise filter between the inventory hook and SST_InventoryEventLogger.
+ *
+ * ItemBase.EEItemLocationChanged fires for every item move on the server. Most
+ * of those moves are noise for an admin reading the log: an item that passes
+ * through a temporary location on its way between two of the player's own
+ * slots shows up as REMOVED + ADDED, and looting a stack of ammo boxes is forty
+ * identical PICKED_UP lines. The filter runs three stages per player:
+ *
+ * 1. Rate cap: at most MAX_EVENTS_PER_SECOND events per player and second.
+ *    Excess events are not built at all, only counted, and reported as one
+ *    SUPPRESSED event (count = dropped events) once the second is over.
+ *
+ * 2. Shuffles: every event is held for HOLD_WINDOW ms. If the same item moves
+ *    back in the opposite direction (REMOVED/DROPPED vs ADDED/PICKED_UP) for
+ *    the same player within that window, both events are discarded.
+ *
+ * 3. Storms: an event with the same type and item class as one still held is
+ *    merged into it; the held event's count and quantity grow instead.
+ *
+ * Held events are handed to SST_InventoryEventLogger.AppendEvent() once their
+ * window has passed, so the recent log and history lag by up to HOLD_WINDOW.
+ * FlushPlayer() (disconnect) and FlushAll() (mission finish) release them at
+ * once. Set ENABLED to false to log every event unfiltered, as before.
+ */
+
+// One event waiting in the hold window
+class SST_InventoryFilterEntry
+{
+	ref SST_InventoryEventData eventData;
+	EntityAI item;             // Weak: last item merged into the event, for shuffle matching
+	int releaseAt;             // GetGame().GetTime() when the event is logged
+}
+
+// Filter state of one player
+class SST_InventoryFilterPlayer
+{
+	string playerName;
+	int windowStart;           // Start of the current rate cap second
+	int windowEvents;          // Events admitted in that second
+	int suppressed;            // Events dropped by the rate cap, not yet reported
+	ref array<ref SST_InventoryFilterEntry> held = new array<ref SST_InventoryFilterEntry>();
+}
+
+class SST_InventoryEventFilter
+{
+	protected static ref SST_InventoryEventFilter s_Instance;
+
+	static const bool ENABLED = true;
+	static const bool DROP_SHUFFLES = true;
+	static const bool MERGE_STORMS = true;
+	static const int MAX_EVENTS_PER_SECOND = 10;   // 0 = no rate cap
+	static const int HOLD_WINDOW = 2000;            // ms an event waits for a reverse move or merges
+	static const int TICK_INTERVAL = 500;           // ms between release checks
+
+	// Steam64 -> filter state
+	protected ref map<string, ref SST_InventoryFilterPlayer> m_Players;
+
+	void SST_InventoryEventFilter()
+	{
+		m_Players = new map<string, ref SST_InventoryFilterPlayer>();
+
+		if (GetGame())
+			GetGame().GetCallQueue(CALL_CATEGORY_SYSTEM).CallLater(ReleaseAndScheduleNext, TICK_INTERVAL, false);
+	}
+
+	static SST_InventoryEventFilter GetInstance()
+	{
+		if (!s_Instance)
+			s_Instance = new SST_InventoryEventFilter();
+		return s_Instance;
+	}
+
+	// Rate cap, checked before the event is built; false means drop it
+	bool Admit(string playerId, string playerName)
+	{
+		if (!ENABLED || MAX_EVENTS_PER_SECOND <= 0)
+			return true;
+
+		SST_InventoryFilterPlayer state = GetOrCreatePlayer(playerId, playerName);
+		int now = GetGame().GetTime();
+		if (now - state.windowStart >= 1000)
+		{
+			state.windowStart = now;
+			state.windowEvents = 0;
+		}
+
+		if (state.windowEvents >= MAX_EVENTS_PER_SECOND)
+		{
+			state.suppressed++;
+			return false;
+		}
+
+		state.windowEvents++;
+		return true;
+	}
+
+	// Hold, cancel or merge an admitted event
+	void Submit(SST_InventoryEventData eventData, EntityAI item)
+	{
+		if (!ENABLED)
+		{
+			SST_InventoryEventLogger.GetInstance().AppendEvent(eventData);
+			return;
+		}
+
+		SST_InventoryFilterPlayer state = GetOrCreatePlayer(eventData.playerId, eventData.playerName);
+		bool entering = IsEntering(eventData.eventType);
+
+		for (int i = 0; i < state.held.Count(); i++)
+		{
+			SST_InventoryFilterEntry entry = state.held[i];
+			SST_InventoryEventData heldData = entry.eventData;
+
+			// The item went straight back: neither move happened as far as the log is concerned
+			if (DROP_SHUFFLES && item && entry.item == item && IsEntering(heldData.eventType) != entering)
+			{
+				heldData.count--;
+				heldData.itemQuantity -= eventData.itemQuantity;
+				entry.item = null;
+				if (heldData.count <= 0)
+					state.held.RemoveOrdered(i);
+				return;
+			}
+
+			if (MERGE_STORMS && heldData.eventType == eventData.eventType && heldData.itemClassName == eventData.itemClassName)
+			{
+				heldData.count += eventData.count;
+				heldData.itemQuantity += eventData.itemQuantity;
+				heldData.position = eventData.position;
+				entry.item = item;
+				return;
+			}
+		}
+
+		SST_InventoryFilterEntry held = new SST_InventoryFilterEntry();
+		held.eventData = eventData;
+		held.item = item;
+		held.releaseAt = GetGame().GetTime() + HOLD_WINDOW;
+		state.held.Insert(held);
+	}
+
+	// Log everything held for the player and forget their state, e.g. on disconnect
+	void FlushPlayer(string playerId)
+	{
+		SST_InventoryFilterPlayer state = m_Players.Get(playerId);
+		if (!state)
+			return;
+
+		Release(playerId, state, true);
+		m_Players.Remove(playerId);
+	}
+
+	// Log everything held, e.g. on mission finish
+	void FlushAll()
+	{
+		for (int i = 0; i < m_Players.Count(); i++)
+			Release(m_Players.GetKey(i), m_Players.GetElement(i), true);
+
+		m_Players.Clear();
+	}
+
+	protected SST_InventoryFilterPlayer GetOrCreatePlayer(string playerId, string playerName)
+	{
+		SST_InventoryFilterPlayer state = m_Players.Get(playerId);
+		if (!state)
+		{
+			state = new SST_InventoryFilterPlayer();
+			state.windowStart = GetGame().GetTime();
+			m_Players.Set(playerId, state);
+		}
+		state.playerName = playerName;
+		return state;
+	}
+
+	protected static bool IsEntering(string eventType)
+	{
+		return eventType == SST_InventoryEventType.ADDED || eventType == SST_InventoryEventType.PICKED_UP;
+	}
+
+	// Hand due events (all of them if force) to the logger, oldest first
+	protected void Release(string playerId, SST_InventoryFilterPlayer state, bool force)
+	{
+		SST_InventoryEventLogger logger = SST_InventoryEventLogger.GetInstance();
+		int now = GetGame().GetTime();
+
+		while (state.held.Count() > 0 && (force || state.held[0].releaseAt <= now))
+		{
+			logger.AppendEvent(state.held[0].eventData);
+			state.held.RemoveOrdered(0);
+		}
+
+		if (state.suppressed > 0 && (force || now - state.windowStart >= 1000))
+		{
+			SST_InventoryEventData summary = new SST_InventoryEventData();
+			summary.timestamp = SST_Clock.Now();
+			summary.timestampUnix = SST_Clock.NowUnix();
+			summary.eventType = SST_InventoryEventType.SUPPRESSED;
+			summary.playerName = state.playerName;
+			summary.playerId = playerId;
+			summary.count = state.suppressed;
+			logger.AppendEvent(summary);
+
+			state.suppressed = 0;
+		}
+	}
+
+	protected void ReleaseAndScheduleNext()
+	{
+		array<string> idle = new array<string>();
+		for (int i = 0; i < m_Players.Count(); i++)
+		{
+			SST_InventoryFilterPlayer state = m_Players.GetElement(i);
+			Release(m_Players.GetKey(i), state, false);
+
+			if (state.held.Count() == 0 && state.suppressed == 0 && GetGame().GetTime() - state.windowStart >= 1000)
+				idle.Insert(m_Players.GetKey(i));
+		}
+
+		foreach (string playerId : idle)
+			m_Players.Remove(playerId);
+
+		GetGame().GetCallQueue(CALL_CATEGORY_SYSTEM).CallLater(ReleaseAndScheduleNext, TICK_INTERVAL, false);
+	}
+}
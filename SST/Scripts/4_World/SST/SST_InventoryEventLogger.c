@@ -3,13 +3,24 @@
  * @brief Logs player inventory events (drops, pickups, adds/removes) to JSON.
  *
  * Appends lightweight inventory events to per-player JSON logs under
- * $profile:SST/events/ for API/dashboard consumption.
+ * $profile:SST/events/ for API/dashboard consumption. Logs are kept in memory
+ * and written back through SST_LogSink, not on every event. SST_LogResidency
+ * reads them on connect and evicts them some time after disconnect.
+ *
+ * Events pass through SST_InventoryEventFilter first, which drops own-inventory
+ * shuffles, merges bursts and rate caps each player.
+ *
+ * The JSON files are a capped "recent" view. The full history is appended to
+ * NDJSON segments (SST_NdjsonLog) under $profile:SST/history/<stream>/<steam64>/
+ * and only dropped by the segment retention policy.
  */
 
-class SST_InventoryEventLogger
+class SST_InventoryEventLogger : SST_HistoryLogSinkClient
 {
 	protected static ref SST_InventoryEventLogger s_Instance;
 	static const string EVENTS_FOLDER = "$profile:SST/events/";
+	static const string HISTORY_FOLDER = "$profile:SST/history/events/";
+	static const int RECENT_EVENTS = 100; // Events kept in <steam64>_events.json
 	
 	// Cache of loaded event logs per player
 	protected ref map<string, ref SST_PlayerInventoryEventsLog> m_EventLogs;
@@ -23,6 +34,8 @@ class SST_InventoryEventLogger
 			MakeDirectory("$profile:SST");
 		if (!FileExist(EVENTS_FOLDER))
 			MakeDirectory(EVENTS_FOLDER);
+		
+		SST_LogResidency.GetInstance().Register(this);
 	}
 	
 	static SST_InventoryEventLogger GetInstance()
@@ -32,20 +45,6 @@ class SST_InventoryEventLogger
 		return s_Instance;
 	}
 	
-	static string GetUTCTimestamp()
-	{
-		int year, month, day, hour, minute, second;
-		GetYearMonthDayUTC(year, month, day);
-		GetHourMinuteSecondUTC(hour, minute, second);
-		return string.Format("%1-%2-%3T%4:%5:%6Z",
-			year.ToStringLen(4),
-			month.ToStringLen(2),
-			day.ToStringLen(2),
-			hour.ToStringLen(2),
-			minute.ToStringLen(2),
-			second.ToStringLen(2));
-	}
-	
 	// Get quantity for any item type
 	static float GetItemQuantity(EntityAI item)
 	{
@@ -63,7 +62,7 @@ class SST_InventoryEventLogger
 		return 0;
 	}
 	
-	// Log an inventory event
+	// Log an inventory event (through SST_InventoryEventFilter)
 	void LogEvent(string eventType, PlayerBase player, EntityAI item, vector position)
 	{
 		if (!GetGame().IsServer())
@@ -79,9 +78,15 @@ class SST_InventoryEventLogger
 		string playerId = identity.GetPlainId();
 		string playerName = identity.GetName();
 		
+		// Over the player's rate cap: don't even build the event
+		SST_InventoryEventFilter filter = SST_InventoryEventFilter.GetInstance();
+		if (!filter.Admit(playerId, playerName))
+			return;
+		
 		// Create event data
 		ref SST_InventoryEventData eventData = new SST_InventoryEventData();
-		eventData.timestamp = GetUTCTimestamp();
+		eventData.timestamp = SST_Clock.Now();
+		eventData.timestampUnix = SST_Clock.NowUnix();
 		eventData.eventType = eventType;
 		eventData.playerName = playerName;
 		eventData.playerId = playerId;
@@ -91,21 +96,32 @@ class SST_InventoryEventLogger
 		eventData.itemQuantity = GetItemQuantity(item);
 		eventData.position = position;
 		
+		filter.Submit(eventData, item);
+	}
+	
+	// Store an event that passed the filter
+	void AppendEvent(SST_InventoryEventData eventData)
+	{
+		string playerId = eventData.playerId;
+		
 		// Load or create player's event log
-		ref SST_PlayerInventoryEventsLog playerLog = GetOrCreatePlayerLog(playerId, playerName);
+		ref SST_PlayerInventoryEventsLog playerLog = GetOrCreatePlayerLog(playerId, eventData.playerName);
 		playerLog.events.Insert(eventData);
 		
-		// Keep only last 100 events per player to prevent file bloat
-		while (playerLog.events.Count() > 100)
+		// The JSON file only keeps the most recent events; history goes to the NDJSON segments
+		while (playerLog.events.Count() > RECENT_EVENTS)
 		{
-			playerLog.events.Remove(0);
+			playerLog.events.RemoveOrdered(0);
 		}
 		
-		// Save to file
-		SavePlayerLog(playerId, playerLog);
+		QueueHistory(playerId, eventData);
+		
+		// Written back by the sink (batched)
+		SST_LogSink.GetInstance().Append(this, playerId);
+		SST_EventStream.GetInstance().AppendInventoryEvent(eventData);
 		
 		// Console log for debugging
-		Print("[SST] " + eventType + ": " + playerName + " - " + item.GetDisplayName() + " (" + item.GetType() + ")");
+		Print("[SST] " + eventData.eventType + ": " + eventData.playerName + " - " + eventData.itemDisplayName + " (" + eventData.itemClassName + ") x" + eventData.count.ToString());
 	}
 	
 	protected ref SST_PlayerInventoryEventsLog GetOrCreatePlayerLog(string playerId, string playerName)
@@ -114,22 +130,8 @@ class SST_InventoryEventLogger
 		if (m_EventLogs.Contains(playerId))
 			return m_EventLogs.Get(playerId);
 		
-		// Try to load from file
-		string filePath = EVENTS_FOLDER + playerId + "_events.json";
-		ref SST_PlayerInventoryEventsLog playerLog;
-		
-		if (FileExist(filePath))
-		{
-			string errorMsg;
-			if (JsonFileLoader<SST_PlayerInventoryEventsLog>.LoadFile(filePath, playerLog, errorMsg))
-			{
-				m_EventLogs.Set(playerId, playerLog);
-				return playerLog;
-			}
-		}
-		
-		// Create new log
-		playerLog = new SST_PlayerInventoryEventsLog();
+		// Not preloaded yet: start in memory, LoadLog merges the file in later (no disk access in hooks)
+		ref SST_PlayerInventoryEventsLog playerLog = new SST_PlayerInventoryEventsLog();
 		playerLog.playerName = playerName;
 		playerLog.playerId = playerId;
 		m_EventLogs.Set(playerId, playerLog);
@@ -137,7 +139,45 @@ class SST_InventoryEventLogger
 		return playerLog;
 	}
 	
-	protected void SavePlayerLog(string playerId, SST_PlayerInventoryEventsLog playerLog)
+	// Read <steam64>_events.json; its events go in front of anything logged since connect
+	override void LoadLog(string key)
+	{
+		string filePath = EVENTS_FOLDER + key + "_events.json";
+		if (!FileExist(filePath))
+			return;
+		
+		ref SST_PlayerInventoryEventsLog loaded;
+		string errorMsg;
+		if (!JsonFileLoader<SST_PlayerInventoryEventsLog>.LoadFile(filePath, loaded, errorMsg))
+		{
+			Print("[SST] WARNING: Could not read event log for " + key + ": " + errorMsg);
+			return;
+		}
+		
+		ref SST_PlayerInventoryEventsLog playerLog = m_EventLogs.Get(key);
+		if (!playerLog)
+		{
+			m_EventLogs.Set(key, loaded);
+			return;
+		}
+		
+		for (int i = loaded.events.Count() - 1; i >= 0; i--)
+		{
+			playerLog.events.InsertAt(loaded.events[i], 0);
+		}
+		
+		while (playerLog.events.Count() > RECENT_EVENTS)
+		{
+			playerLog.events.RemoveOrdered(0);
+		}
+	}
+	
+	override void UnloadLog(string key)
+	{
+		m_EventLogs.Remove(key);
+	}
+	
+	protected bool SavePlayerLog(string playerId, SST_PlayerInventoryEventsLog playerLog)
 	{
 		string filePath = EVENTS_FOLDER + playerId + "_events.json";
 		string errorMsg;
@@ -145,7 +185,33 @@ class SST_InventoryEventLogger
 		if (!JsonFileLoader<SST_PlayerInventoryEventsLog>.SaveFile(filePath, playerLog, errorMsg))
 		{
 			Print("[SST] ERROR: Failed to save event log for " + playerId + ": " + errorMsg);
+			return false;
 		}
+		return true;
+	}
+	
+	override string GetLogSinkName()
+	{
+		return "inventory_events";
+	}
+	
+	override string GetHistoryFolder()
+	{
+		return HISTORY_FOLDER;
+	}
+	
+	override void WriteHistoryRecord(SST_JsonWriter writer, Class record)
+	{
+		SST_JsonExport.WriteInventoryEvent(writer, SST_InventoryEventData.Cast(record));
+	}
+	
+	override bool SaveRecentLog(string key)
+	{
+		ref SST_PlayerInventoryEventsLog playerLog = m_EventLogs.Get(key);
+		if (!playerLog)
+			return true;
+		
+		return SavePlayerLog(key, playerLog);
 	}
 	
 	// Static helper methods for easy calling
@@ -173,10 +239,12 @@ class SST_InventoryEventLogger
 // ============================================================================
 // Player Life Event Logger (Death, Spawn, Connect, Disconnect)
 // ============================================================================
-class SST_PlayerLifeEventLogger
+class SST_PlayerLifeEventLogger : SST_HistoryLogSinkClient
 {
 	protected static ref SST_PlayerLifeEventLogger s_Instance;
 	static const string LIFE_EVENTS_FOLDER = "$profile:SST/life_events/";
+	static const string HISTORY_FOLDER = "$profile:SST/history/life_events/";
+	static const int RECENT_EVENTS = 50; // Events kept in <steam64>_life.json
 	
 	protected ref map<string, ref SST_PlayerLifeEventsLog> m_LifeEventLogs;
 	
@@ -188,6 +256,8 @@ class SST_PlayerLifeEventLogger
 			MakeDirectory("$profile:SST");
 		if (!FileExist(LIFE_EVENTS_FOLDER))
 			MakeDirectory(LIFE_EVENTS_FOLDER);
+		
+		SST_LogResidency.GetInstance().Register(this);
 	}
 	
 	static SST_PlayerLifeEventLogger GetInstance()
@@ -213,7 +283,8 @@ class SST_PlayerLifeEventLogger
 		string playerName = identity.GetName();
 		
 		ref SST_PlayerLifeEventData eventData = new SST_PlayerLifeEventData();
-		eventData.timestamp = SST_InventoryEventLogger.GetUTCTimestamp();
+		eventData.timestamp = SST_Clock.Now();
+		eventData.timestampUnix = SST_Clock.NowUnix();
 		eventData.eventType = eventType;
 		eventData.playerName = playerName;
 		eventData.playerId = playerId;
@@ -224,13 +295,16 @@ class SST_PlayerLifeEventLogger
 		ref SST_PlayerLifeEventsLog playerLog = GetOrCreateLifeLog(playerId, playerName);
 		playerLog.events.Insert(eventData);
 		
-		// Keep last 50 life events
-		while (playerLog.events.Count() > 50)
+		// Keep the last RECENT_EVENTS in the JSON file; history goes to the NDJSON segments
+		while (playerLog.events.Count() > RECENT_EVENTS)
 		{
-			playerLog.events.Remove(0);
+			playerLog.events.RemoveOrdered(0);
 		}
 		
-		SaveLifeLog(playerId, playerLog);
+		QueueHistory(playerId, eventData);
+		
+		SST_LogSink.GetInstance().Append(this, playerId);
+		SST_EventStream.GetInstance().AppendLifeEvent(eventData);
 		
 		Print("[SST] LIFE EVENT - " + eventType + ": " + playerName + " at " + player.GetPosition().ToString());
 	}
@@ -240,20 +314,8 @@ class SST_PlayerLifeEventLogger
 		if (m_LifeEventLogs.Contains(playerId))
 			return m_LifeEventLogs.Get(playerId);
 		
-		string filePath = LIFE_EVENTS_FOLDER + playerId + "_life.json";
-		ref SST_PlayerLifeEventsLog playerLog;
-		
-		if (FileExist(filePath))
-		{
-			string errorMsg;
-			if (JsonFileLoader<SST_PlayerLifeEventsLog>.LoadFile(filePath, playerLog, errorMsg))
-			{
-				m_LifeEventLogs.Set(playerId, playerLog);
-				return playerLog;
-			}
-		}
-		
-		playerLog = new SST_PlayerLifeEventsLog();
+		// Not preloaded yet (e.g. the connect event itself): LoadLog merges the file in later
+		ref SST_PlayerLifeEventsLog playerLog = new SST_PlayerLifeEventsLog();
 		playerLog.playerName = playerName;
 		playerLog.playerId = playerId;
 		m_LifeEventLogs.Set(playerId, playerLog);
@@ -261,7 +323,45 @@ class SST_PlayerLifeEventLogger
 		return playerLog;
 	}
 	
-	protected void SaveLifeLog(string playerId, SST_PlayerLifeEventsLog playerLog)
+	// Read <steam64>_life.json; its events go in front of anything logged since connect
+	override void LoadLog(string key)
+	{
+		string filePath = LIFE_EVENTS_FOLDER + key + "_life.json";
+		if (!FileExist(filePath))
+			return;
+		
+		ref SST_PlayerLifeEventsLog loaded;
+		string errorMsg;
+		if (!JsonFileLoader<SST_PlayerLifeEventsLog>.LoadFile(filePath, loaded, errorMsg))
+		{
+			Print("[SST] WARNING: Could not read life event log for " + key + ": " + errorMsg);
+			return;
+		}
+		
+		ref SST_PlayerLifeEventsLog playerLog = m_LifeEventLogs.Get(key);
+		if (!playerLog)
+		{
+			m_LifeEventLogs.Set(key, loaded);
+			return;
+		}
+		
+		for (int i = loaded.events.Count() - 1; i >= 0; i--)
+		{
+			playerLog.events.InsertAt(loaded.events[i], 0);
+		}
+		
+		while (playerLog.events.Count() > RECENT_EVENTS)
+		{
+			playerLog.events.RemoveOrdered(0);
+		}
+	}
+	
+	override void UnloadLog(string key)
+	{
+		m_LifeEventLogs.Remove(key);
+	}
+	
+	protected bool SaveLifeLog(string playerId, SST_PlayerLifeEventsLog playerLog)
 	{
 		string filePath = LIFE_EVENTS_FOLDER + playerId + "_life.json";
 		string errorMsg;
@@ -269,7 +369,33 @@ class SST_PlayerLifeEventLogger
 		if (!JsonFileLoader<SST_PlayerLifeEventsLog>.SaveFile(filePath, playerLog, errorMsg))
 		{
 			Print("[SST] ERROR: Failed to save life event log for " + playerId + ": " + errorMsg);
+			return false;
 		}
+		return true;
+	}
+	
+	override string GetLogSinkName()
+	{
+		return "life_events";
+	}
+	
+	override string GetHistoryFolder()
+	{
+		return HISTORY_FOLDER;
+	}
+	
+	override void WriteHistoryRecord(SST_JsonWriter writer, Class record)
+	{
+		SST_JsonExport.WriteLifeEvent(writer, SST_PlayerLifeEventData.Cast(record));
+	}
+	
+	override bool SaveRecentLog(string key)
+	{
+		ref SST_PlayerLifeEventsLog playerLog = m_LifeEventLogs.Get(key);
+		if (!playerLog)
+			return true;
+		
+		return SaveLifeLog(key, playerLog);
 	}
 	
 	// Static helpers
@@ -312,12 +438,17 @@ class SST_PlayerLifeEventLogger
 // ============================================================================
 // Item Grant API - Processes requests to give items to players
 // ============================================================================
-class SST_ItemGrantAPI
+class SST_ItemGrantAPI : SST_CommandHandler
 {
 	protected static ref SST_ItemGrantAPI s_Instance;
 	static const string GRANT_QUEUE_FILE = "$profile:SST/api/item_grants.json";
-	static const string GRANT_RESULTS_FILE = "$profile:SST/api/item_grants_results.json";
+	static const string SPOOL_QUEUE = "item_grants";
+	static const string KIT_SPOOL_QUEUE = "kit_grants";
 	static const float CHECK_INTERVAL = 5000.0; // Check every 5 seconds
+	static const int MAX_KIT_ITEMS = 100;         // Items per kit, attachments and cargo included
+	
+	protected ref SST_CommandSpool m_Spool;
+	protected ref SST_CommandSpool m_KitSpool;
 	
 	void SST_ItemGrantAPI()
 	{
@@ -325,6 +456,9 @@ class SST_ItemGrantAPI
 			MakeDirectory("$profile:SST");
 		if (!FileExist("$profile:SST/api"))
 			MakeDirectory("$profile:SST/api");
+		
+		m_Spool = new SST_CommandSpool(SPOOL_QUEUE);
+		m_KitSpool = new SST_CommandSpool(KIT_SPOOL_QUEUE);
 	}
 	
 	static SST_ItemGrantAPI GetInstance()
@@ -341,7 +475,7 @@ class SST_ItemGrantAPI
 	
 	protected void Init()
 	{
-		Print("[SST] Item Grant API initialized - checking " + GRANT_QUEUE_FILE + " every 5 seconds");
+		Print("[SST] Item Grant API initialized - checking spool " + SPOOL_QUEUE + " and " + GRANT_QUEUE_FILE + " every 5 seconds");
 		GetGame().GetCallQueue(CALL_CATEGORY_SYSTEM).CallLater(ProcessGrantsAndSchedule, 5000, false);
 	}
 	
@@ -356,6 +490,54 @@ class SST_ItemGrantAPI
 		if (!GetGame().IsServer())
 			return;
 		
+		ProcessSpooledGrants();
+		ProcessSpooledKits();
+		ProcessLegacyGrantQueue();
+	}
+	
+	// SST_CommandExecutor: run one claimed grant or kit file
+	override void ExecuteSpooled(SST_CommandSpool spool, string fileName)
+	{
+		if (spool == m_KitSpool)
+			ExecuteKitFile(fileName);
+		else
+			ExecuteGrantFile(fileName);
+	}
+	
+	// Claim spooled requests (current API); SST_CommandExecutor runs them within its tick budget
+	protected void ProcessSpooledGrants()
+	{
+		SST_CommandExecutor.GetInstance().Pull(m_Spool, this);
+	}
+	
+	protected void ExecuteGrantFile(string fileName)
+	{
+		ref SST_ItemGrantRequest request;
+		string errorMsg;
+		if (!JsonFileLoader<SST_ItemGrantRequest>.LoadFile(m_Spool.GetProcessingPath(fileName), request, errorMsg) || !request)
+		{
+			request = new SST_ItemGrantRequest();
+			request.processed = true;
+			request.result = "INVALID_REQUEST";
+			Print("[SST] ERROR: Spool item grant: unreadable request " + fileName + ": " + errorMsg);
+		}
+		else if (m_Spool.IsRecovered(fileName))
+		{
+			// Claimed before a restart: it may or may not have run, so don't run it again
+			request.processed = true;
+			request.result = "INTERRUPTED";
+		}
+		else
+		{
+			ProcessSingleGrant(request);
+		}
+		
+		m_Spool.Complete(fileName, SST_ResultJson<SST_ItemGrantRequest>.Write(request));
+	}
+	
+	// item_grants.json from API versions before the spool: drained, then deleted
+	protected void ProcessLegacyGrantQueue()
+	{
 		if (!FileExist(GRANT_QUEUE_FILE))
 			return;
 		
@@ -369,7 +551,10 @@ class SST_ItemGrantAPI
 		}
 		
 		if (!grantQueue || grantQueue.requests.Count() == 0)
+		{
+			DeleteFile(GRANT_QUEUE_FILE);
 			return;
+		}
 		
 		bool hasChanges = false;
 		
@@ -380,20 +565,12 @@ class SST_ItemGrantAPI
 			
 			hasChanges = true;
 			ProcessSingleGrant(request);
+			m_Spool.GetResults().Append(request.requestId, "", SST_ResultJson<SST_ItemGrantRequest>.Write(request));
 		}
 		
+		// Remove the drained queue so idle polls only cost a FileExist
 		if (hasChanges)
-		{
-			// Save updated queue with results
-			if (!JsonFileLoader<SST_ItemGrantQueue>.SaveFile(GRANT_RESULTS_FILE, grantQueue, errorMsg))
-			{
-				Print("[SST] ERROR: Failed to save grant results: " + errorMsg);
-			}
-			
-			// Clear the original queue file
-			ref SST_ItemGrantQueue emptyQueue = new SST_ItemGrantQueue();
-			JsonFileLoader<SST_ItemGrantQueue>.SaveFile(GRANT_QUEUE_FILE, emptyQueue, errorMsg);
-		}
+			DeleteFile(GRANT_QUEUE_FILE);
 	}
 	
 	protected void ProcessSingleGrant(SST_ItemGrantRequest request)
@@ -401,7 +578,7 @@ class SST_ItemGrantAPI
 		request.processed = true;
 		
 		// Find the player
-		PlayerBase targetPlayer = FindPlayerBySteamId(request.playerId);
+		PlayerBase targetPlayer = SST_PlayerIndex.FindBySteamId(request.playerId);
 		if (!targetPlayer)
 		{
 			request.result = "PLAYER_NOT_FOUND";
@@ -435,86 +612,359 @@ class SST_ItemGrantAPI
 			return;
 		}
 		
-		// Set health if specified
-		if (request.health >= 0 && request.health <= 100)
+		ApplyHealthAndQuantity(newItem, request.health, request.quantity);
+		
+		request.result = "SUCCESS";
+		Print("[SST] Item Grant SUCCESS: " + request.itemClassName + " given to " + targetPlayer.GetIdentity().GetName());
+		
+		// Send notification to player
+		string itemDisplayName = newItem.GetDisplayName();
+		if (itemDisplayName == "")
+			itemDisplayName = request.itemClassName;
+		
+		string qtyText = "";
+		if (request.quantity > 1)
+			qtyText = " x" + request.quantity.ToString();
+		
+		string notificationTitle = "ADMIN MESSAGE";
+		string notificationText = "Item " + itemDisplayName + qtyText + " added to inventory";
+		
+		// Send notification (5 second display time)
+		NotificationSystem.SendNotificationToPlayerExtended(targetPlayer, 5.0, notificationTitle, notificationText, "set:dayz_gui image:icon_connect");
+	}
+	
+	// health: percentage (0-100), anything else keeps the default; quantity: ammo or stack size if > 1
+	protected static void ApplyHealthAndQuantity(EntityAI item, float health, int quantity)
+	{
+		if (health >= 0 && health <= 100)
 		{
-			float maxHealth = newItem.GetMaxHealth("", "");
-			newItem.SetHealth("", "", maxHealth * (request.health / 100.0));
+			float maxHealth = item.GetMaxHealth("", "");
+			item.SetHealth("", "", maxHealth * (health / 100.0));
 		}
 		
-		// Set quantity if applicable
-		if (request.quantity > 1)
+		if (quantity > 1)
 		{
-			Magazine mag = Magazine.Cast(newItem);
+			Magazine mag = Magazine.Cast(item);
 			if (mag)
 			{
-				mag.ServerSetAmmoCount(Math.Min(request.quantity, mag.GetAmmoMax()));
+				mag.ServerSetAmmoCount(Math.Min(quantity, mag.GetAmmoMax()));
 			}
 			else
 			{
-				ItemBase itemBase = ItemBase.Cast(newItem);
+				ItemBase itemBase = ItemBase.Cast(item);
 				if (itemBase && itemBase.GetQuantityMax() > 0)
 				{
-					itemBase.SetQuantity(Math.Min(request.quantity, itemBase.GetQuantityMax()));
+					itemBase.SetQuantity(Math.Min(quantity, itemBase.GetQuantityMax()));
 				}
 			}
 		}
+	}
+	
+	// ------------------------------------------------------------------------
+	// Kit grants: several items (with attachments and cargo) for several players.
+	// The kit is validated once, then each player is granted in their own
+	// SST_FrameScheduler task; the result is journaled after the last one.
+	// ------------------------------------------------------------------------
+	
+	protected void ProcessSpooledKits()
+	{
+		SST_CommandExecutor.GetInstance().Pull(m_KitSpool, this);
+	}
+	
+	protected void ExecuteKitFile(string fileName)
+	{
+		ref SST_KitGrantRequest request;
+		string errorMsg;
+		if (!JsonFileLoader<SST_KitGrantRequest>.LoadFile(m_KitSpool.GetProcessingPath(fileName), request, errorMsg) || !request)
+		{
+			request = new SST_KitGrantRequest();
+			request.result = "INVALID_REQUEST";
+			Print("[SST] ERROR: Spool kit grant: unreadable request " + fileName + ": " + errorMsg);
+		}
+		else if (m_KitSpool.IsRecovered(fileName))
+		{
+			// Claimed before a restart: some players may already have the kit
+			request.result = "INTERRUPTED";
+		}
+		else if (StartKitGrant(fileName, request))
+		{
+			return; // Finished by the last SST_KitGrantTask
+		}
 		
-		request.result = "SUCCESS";
-		Print("[SST] Item Grant SUCCESS: " + request.itemClassName + " given to " + targetPlayer.GetIdentity().GetName());
+		CompleteKitGrant(fileName, request);
+	}
+	
+	// Validate the kit and queue one task per target player; false if nothing was queued
+	protected bool StartKitGrant(string fileName, SST_KitGrantRequest request)
+	{
+		if (!request.items || request.items.Count() == 0 || !request.playerIds || request.playerIds.Count() == 0)
+		{
+			request.result = "INVALID_REQUEST";
+			return false;
+		}
 		
-		// Send notification to player
-		string itemDisplayName = newItem.GetDisplayName();
-		if (itemDisplayName == "")
-			itemDisplayName = request.itemClassName;
+		int itemCount = ValidateKitItems(request.items, request);
+		if (itemCount > MAX_KIT_ITEMS)
+		{
+			request.result = "KIT_TOO_LARGE";
+			return false;
+		}
 		
-		string qtyText = "";
-		if (request.quantity > 1)
-			qtyText = " x" + request.quantity.ToString();
+		// Resolve targets once; "all" means everyone online now. Each Steam64 ID is granted
+		// once, even if it is listed twice or also covered by "all".
+		array<PlayerBase> targets = new array<PlayerBase>();
+		map<string, bool> seen = new map<string, bool>();
+		if (request.playerIds.Find("all") != -1)
+		{
+			array<PlayerBase> online = new array<PlayerBase>();
+			SST_PlayerIndex.GetInstance().GetPlayers(online);
+			foreach (PlayerBase onlinePlayer : online)
+			{
+				seen.Set(onlinePlayer.GetIdentity().GetPlainId(), true);
+				targets.Insert(onlinePlayer);
+			}
+		}
 		
-		string notificationTitle = "ADMIN MESSAGE";
-		string notificationText = "Item " + itemDisplayName + qtyText + " added to inventory";
+		foreach (string playerId : request.playerIds)
+		{
+			if (playerId == "all" || seen.Contains(playerId))
+				continue;
+			
+			seen.Set(playerId, true);
+			PlayerBase target = SST_PlayerIndex.FindBySteamId(playerId);
+			if (target)
+			{
+				targets.Insert(target);
+				continue;
+			}
+			
+			SST_KitGrantPlayerResult missing = new SST_KitGrantPlayerResult();
+			missing.playerId = playerId;
+			missing.result = "PLAYER_NOT_FOUND";
+			request.players.Insert(missing);
+		}
 		
-		// Send notification (5 second display time)
-		NotificationSystem.SendNotificationToPlayerExtended(targetPlayer, 5.0, notificationTitle, notificationText, "set:dayz_gui image:icon_connect");
+		if (targets.Count() == 0)
+			return false;
+		
+		SST_KitGrantJob job = new SST_KitGrantJob(fileName, request, targets.Count());
+		foreach (PlayerBase player : targets)
+			SST_FrameScheduler.Enqueue(new SST_KitGrantTask(job, player));
+		
+		Print("[SST] Kit grant " + request.kitName + " queued for " + targets.Count().ToString() + " players (" + itemCount.ToString() + " items each)");
+		return true;
 	}
 	
-	protected PlayerBase FindPlayerBySteamId(string steamId)
+	// Record classes missing from config in request.invalidClasses; returns the item count
+	protected static int ValidateKitItems(array<ref SST_KitItem> items, SST_KitGrantRequest request)
 	{
-		array<Man> players = new array<Man>();
-		GetGame().GetPlayers(players);
+		if (!items)
+			return 0;
 		
-		foreach (Man man : players)
+		int count = 0;
+		foreach (SST_KitItem kitItem : items)
 		{
-			if (!man)
+			if (!kitItem)
 				continue;
+			
+			count++;
+			string className = kitItem.itemClassName;
+			bool validClass = GetGame().ConfigIsExisting("CfgVehicles " + className) || GetGame().ConfigIsExisting("CfgWeapons " + className) || GetGame().ConfigIsExisting("CfgMagazines " + className);
+			if (!validClass && request.invalidClasses.Find(className) == -1)
+				request.invalidClasses.Insert(className);
+			
+			count += ValidateKitItems(kitItem.attachments, request);
+			count += ValidateKitItems(kitItem.cargo, request);
+		}
+		return count;
+	}
+	
+	// Called by SST_KitGrantTask: give the whole kit to one player, then notify them once
+	void GrantKitToPlayer(SST_KitGrantJob job, PlayerBase player, string playerId)
+	{
+		SST_KitGrantRequest request = job.request;
+		SST_KitGrantPlayerResult playerResult = new SST_KitGrantPlayerResult();
+		playerResult.playerId = playerId;
+		request.players.Insert(playerResult);
+		
+		if (!player || !player.GetIdentity())
+		{
+			playerResult.result = "PLAYER_NOT_FOUND";
+			return;
+		}
+		
+		playerResult.playerName = player.GetIdentity().GetName();
+		
+		foreach (SST_KitItem kitItem : request.items)
+		{
+			if (!kitItem || request.invalidClasses.Find(kitItem.itemClassName) != -1)
+				continue;
+			
+			EntityAI item = player.GetInventory().CreateInInventory(kitItem.itemClassName);
+			if (!item)
+			{
+				// Inventory full: spawn at feet
+				item = EntityAI.Cast(GetGame().CreateObjectEx(kitItem.itemClassName, player.GetPosition(), ECE_PLACE_ON_SURFACE));
+				if (item)
+					playerResult.dropped++;
+			}
+			
+			if (!item)
+			{
+				playerResult.failed.Insert(kitItem.itemClassName + ":SPAWN_FAILED");
+				continue;
+			}
+			
+			FillKitItem(item, kitItem, request, playerResult);
+		}
+		
+		if (playerResult.failed.Count() == 0)
+			playerResult.result = "SUCCESS";
+		else if (playerResult.granted > 0)
+			playerResult.result = "PARTIAL";
+		else
+			playerResult.result = "FAILED";
+		
+		if (playerResult.granted == 0)
+			return;
+		
+		string kitName = request.kitName;
+		if (kitName == "")
+			kitName = "Kit";
+		
+		string notificationText = kitName + " added to inventory (" + playerResult.granted.ToString() + " items)";
+		if (playerResult.dropped > 0)
+			notificationText += ", " + playerResult.dropped.ToString() + " on the ground";
+		
+		NotificationSystem.SendNotificationToPlayerExtended(player, 5.0, "ADMIN MESSAGE", notificationText, "set:dayz_gui image:icon_connect");
+	}
+	
+	// Health/quantity on a created item, then its attachments and cargo
+	protected static void FillKitItem(EntityAI item, SST_KitItem kitItem, SST_KitGrantRequest request, SST_KitGrantPlayerResult playerResult)
+	{
+		playerResult.granted++;
+		ApplyHealthAndQuantity(item, kitItem.health, kitItem.quantity);
+		
+		if (kitItem.attachments)
+		{
+			foreach (SST_KitItem attachment : kitItem.attachments)
+			{
+				if (!attachment || request.invalidClasses.Find(attachment.itemClassName) != -1)
+					continue;
 				
-			PlayerIdentity identity = man.GetIdentity();
-			if (identity && identity.GetPlainId() == steamId)
+				EntityAI attached = item.GetInventory().CreateAttachment(attachment.itemClassName);
+				if (attached)
+					FillKitItem(attached, attachment, request, playerResult);
+				else
+					playerResult.failed.Insert(attachment.itemClassName + ":ATTACH_FAILED");
+			}
+		}
+		
+		if (kitItem.cargo)
+		{
+			foreach (SST_KitItem content : kitItem.cargo)
 			{
-				return PlayerBase.Cast(man);
+				if (!content || request.invalidClasses.Find(content.itemClassName) != -1)
+					continue;
+				
+				EntityAI stored = item.GetInventory().CreateEntityInCargo(content.itemClassName);
+				if (stored)
+					FillKitItem(stored, content, request, playerResult);
+				else
+					playerResult.failed.Insert(content.itemClassName + ":NO_CARGO_SPACE");
 			}
 		}
-		return null;
+	}
+	
+	// Summarise, journal the result and release the claimed request
+	void CompleteKitGrant(string fileName, SST_KitGrantRequest request)
+	{
+		request.processed = true;
+		
+		if (request.result == "")
+		{
+			int succeeded = 0;
+			int granted = 0;
+			foreach (SST_KitGrantPlayerResult playerResult : request.players)
+			{
+				if (playerResult.result == "SUCCESS")
+					succeeded++;
+				granted += playerResult.granted;
+			}
+			
+			if (succeeded == request.players.Count() && request.invalidClasses.Count() == 0)
+				request.result = "SUCCESS";
+			else if (granted > 0)
+				request.result = "PARTIAL";
+			else
+				request.result = "FAILED";
+		}
+		
+		m_KitSpool.Complete(fileName, SST_ResultJson<SST_KitGrantRequest>.Write(request));
+		Print("[SST] Kit grant " + request.kitName + ": " + request.result + " (" + request.players.Count().ToString() + " players)");
+	}
+}
+
+// One kit grant in progress: the request and how many player tasks are left
+class SST_KitGrantJob : Managed
+{
+	string fileName;
+	ref SST_KitGrantRequest request;
+	int pending;
+	
+	void SST_KitGrantJob(string name, SST_KitGrantRequest kitRequest, int playerCount)
+	{
+		fileName = name;
+		request = kitRequest;
+		pending = playerCount;
+	}
+}
+
+// Frame scheduler task: give one kit to one player
+class SST_KitGrantTask : SST_SchedulerTask
+{
+	protected ref SST_KitGrantJob m_Job;
+	protected PlayerBase m_Player;  // Weak: may disconnect before the task runs
+	protected string m_PlayerId;
+	
+	void SST_KitGrantTask(SST_KitGrantJob job, PlayerBase player)
+	{
+		m_Job = job;
+		m_Player = player;
+		m_PlayerId = player.GetIdentity().GetPlainId();
+	}
+	
+	override void Run()
+	{
+		SST_ItemGrantAPI api = SST_ItemGrantAPI.GetInstance();
+		api.GrantKitToPlayer(m_Job, m_Player, m_PlayerId);
+		
+		m_Job.pending--;
+		if (m_Job.pending == 0)
+			api.CompleteKitGrant(m_Job.fileName, m_Job.request);
 	}
 }
 
 // ============================================================================
 // Item Delete API - Processes requests to delete items from players
 // ============================================================================
-class SST_ItemDeleteAPI
+class SST_ItemDeleteAPI : SST_CommandHandler
 {
 	protected static ref SST_ItemDeleteAPI s_Instance;
 	static const string DELETE_QUEUE_FILE = "$profile:SST/api/item_deletes.json";
-	static const string DELETE_RESULTS_FILE = "$profile:SST/api/item_deletes_results.json";
+	static const string SPOOL_QUEUE = "item_deletes";
 	static const float CHECK_INTERVAL = 5000.0; // Check every 5 seconds
 	
+	protected ref SST_CommandSpool m_Spool;
+	
 	void SST_ItemDeleteAPI()
 	{
 		if (!FileExist("$profile:SST"))
 			MakeDirectory("$profile:SST");
 		if (!FileExist("$profile:SST/api"))
 			MakeDirectory("$profile:SST/api");
+		
+		m_Spool = new SST_CommandSpool(SPOOL_QUEUE);
 	}
 	
 	static SST_ItemDeleteAPI GetInstance()
@@ -531,7 +981,7 @@ class SST_ItemDeleteAPI
 	
 	protected void Init()
 	{
-		Print("[SST] Item Delete API initialized - checking " + DELETE_QUEUE_FILE + " every 5 seconds");
+		Print("[SST] Item Delete API initialized - checking spool " + SPOOL_QUEUE + " and " + DELETE_QUEUE_FILE + " every 5 seconds");
 		GetGame().GetCallQueue(CALL_CATEGORY_SYSTEM).CallLater(ProcessDeletesAndSchedule, 5000, false);
 	}
 	
@@ -546,6 +996,52 @@ class SST_ItemDeleteAPI
 		if (!GetGame().IsServer())
 			return;
 		
+		ProcessSpooledDeletes();
+		ProcessLegacyDeleteQueue();
+	}
+	
+	// SST_CommandExecutor: run one claimed delete file
+	override void ExecuteSpooled(SST_CommandSpool spool, string fileName)
+	{
+		ExecuteDeleteFile(fileName);
+	}
+	
+	// Claim spooled requests (current API); SST_CommandExecutor runs them within its tick budget
+	protected void ProcessSpooledDeletes()
+	{
+		SST_CommandExecutor.GetInstance().Pull(m_Spool, this);
+	}
+	
+	protected void ExecuteDeleteFile(string fileName)
+	{
+		ref SST_ItemDeleteRequest request;
+		string errorMsg;
+		if (!JsonFileLoader<SST_ItemDeleteRequest>.LoadFile(m_Spool.GetProcessingPath(fileName), request, errorMsg) || !request)
+		{
+			request = new SST_ItemDeleteRequest();
+			request.processed = true;
+			request.status = "failed";
+			request.result = "Invalid request file";
+			Print("[SST] ERROR: Spool item delete: unreadable request " + fileName + ": " + errorMsg);
+		}
+		else if (m_Spool.IsRecovered(fileName))
+		{
+			// Claimed before a restart: it may or may not have run, so don't run it again
+			request.processed = true;
+			request.status = "failed";
+			request.result = "Interrupted by a server restart";
+		}
+		else
+		{
+			ProcessSingleDelete(request);
+		}
+		
+		m_Spool.Complete(fileName, SST_ResultJson<SST_ItemDeleteRequest>.Write(request));
+	}
+	
+	// item_deletes.json from API versions before the spool: drained, then deleted
+	protected void ProcessLegacyDeleteQueue()
+	{
 		if (!FileExist(DELETE_QUEUE_FILE))
 			return;
 		
@@ -559,7 +1055,10 @@ class SST_ItemDeleteAPI
 		}
 		
 		if (!deleteQueue || deleteQueue.requests.Count() == 0)
+		{
+			DeleteFile(DELETE_QUEUE_FILE);
 			return;
+		}
 		
 		bool hasChanges = false;
 		
@@ -570,30 +1069,12 @@ class SST_ItemDeleteAPI
 			
 			hasChanges = true;
 			ProcessSingleDelete(request);
+			m_Spool.GetResults().Append(request.requestId, "", SST_ResultJson<SST_ItemDeleteRequest>.Write(request));
 		}
 		
+		// Remove the drained queue so idle polls only cost a FileExist
 		if (hasChanges)
-		{
-			// Append results to results file
-			ref SST_ItemDeleteQueue existingResults = new SST_ItemDeleteQueue();
-			if (FileExist(DELETE_RESULTS_FILE))
-				JsonFileLoader<SST_ItemDeleteQueue>.LoadFile(DELETE_RESULTS_FILE, existingResults, errorMsg);
-			
-			foreach (SST_ItemDeleteRequest req : deleteQueue.requests)
-			{
-				existingResults.requests.Insert(req);
-			}
-			
-			// Keep only last 100 results
-			while (existingResults.requests.Count() > 100)
-				existingResults.requests.Remove(0);
-			
-			JsonFileLoader<SST_ItemDeleteQueue>.SaveFile(DELETE_RESULTS_FILE, existingResults, errorMsg);
-			
-			// Clear the original queue file
-			ref SST_ItemDeleteQueue emptyQueue = new SST_ItemDeleteQueue();
-			JsonFileLoader<SST_ItemDeleteQueue>.SaveFile(DELETE_QUEUE_FILE, emptyQueue, errorMsg);
-		}
+			DeleteFile(DELETE_QUEUE_FILE);
 	}
 	
 	protected void ProcessSingleDelete(SST_ItemDeleteRequest request)
@@ -604,7 +1085,7 @@ class SST_ItemDeleteAPI
 		Print("[SST] Processing item delete request: " + request.requestId + " for player " + request.playerId);
 		
 		// Find the player
-		PlayerBase targetPlayer = FindPlayerBySteamId(request.playerId);
+		PlayerBase targetPlayer = SST_PlayerIndex.FindBySteamId(request.playerId);
 		if (!targetPlayer)
 		{
 			request.result = "Player not online";
@@ -612,13 +1093,15 @@ class SST_ItemDeleteAPI
 			return;
 		}
 		
-		// Get player's inventory
-		EntityAI item = FindItemByPath(targetPlayer, request.itemPath, request.itemClassName);
+		// Stable id first (O(1) lookup in the index built by the last export), then the positional path
+		EntityAI item = SST_InventoryItemIndex.GetInstance().Resolve(targetPlayer, request.itemId);
+		if (!item)
+			item = FindItemByPath(targetPlayer, request.itemPath, request.itemClassName);
 		
 		if (!item)
 		{
-			request.result = "Item not found at path: " + request.itemPath;
-			Print("[SST] Item Delete FAILED: Item " + request.itemClassName + " not found at path " + request.itemPath);
+			request.result = "Item not found (id: " + request.itemId + ", path: " + request.itemPath + ")";
+			Print("[SST] Item Delete FAILED: Item " + request.itemClassName + " not found (id " + request.itemId + ", path " + request.itemPath + ")");
 			return;
 		}
 		
@@ -665,181 +1148,21 @@ class SST_ItemDeleteAPI
 	// Path format: "slotIndex.cargo|attachments.itemIndex" e.g. "0.cargo.2" or "3.attachments.0.cargo.1"
 	protected EntityAI FindItemByPath(PlayerBase player, string path, string expectedClassName)
 	{
-		if (!player || path == "")
-			return null;
-		
-		array<string> parts = new array<string>();
-		path.Split(".", parts);
-		
-		if (parts.Count() < 1)
-			return null;
-		
-		// Get the player's inventory items using same method as inventory export
-		// Use EnumerateInventory then filter to top-level items only
-		array<EntityAI> allItems = new array<EntityAI>();
-		player.GetInventory().EnumerateInventory(InventoryTraversalType.PREORDER, allItems);
-		
-		// Build list of child items to exclude
-		ref array<EntityAI> childItems = new array<EntityAI>();
-		foreach (EntityAI item : allItems)
-		{
-			if (!item || item == player)
-				continue;
-			
-			GameInventory itemInv = item.GetInventory();
-			if (itemInv)
-			{
-				// Mark attachments as children
-				int attCount = itemInv.AttachmentCount();
-				for (int a = 0; a < attCount; a++)
-				{
-					EntityAI att = itemInv.GetAttachmentFromIndex(a);
-					if (att)
-						childItems.Insert(att);
-				}
-				
-				// Mark cargo items as children
-				CargoBase itemCargo = itemInv.GetCargo();
-				if (itemCargo)
-				{
-					int cargoCount = itemCargo.GetItemCount();
-					for (int c = 0; c < cargoCount; c++)
-					{
-						EntityAI cargoItem = itemCargo.GetItem(c);
-						if (cargoItem)
-							childItems.Insert(cargoItem);
-					}
-				}
-			}
-		}
-		
-		// Build top-level items list (same order as inventory export)
-		array<EntityAI> topLevelItems = new array<EntityAI>();
-		foreach (EntityAI topItem : allItems)
-		{
-			if (!topItem || topItem == player)
-				continue;
-			
-			// Skip if this is a child of another item
-			if (childItems.Find(topItem) != -1)
-				continue;
-			
-			topLevelItems.Insert(topItem);
-		}
-		
-		// Parse first part as the root item index
-		int rootIndex = parts[0].ToInt();
-		if (rootIndex < 0 || rootIndex >= topLevelItems.Count())
-		{
-			Print("[SST] FindItemByPath: Root index " + rootIndex.ToString() + " out of bounds (have " + topLevelItems.Count().ToString() + " top-level items)");
+		if (!player)
 			return null;
-		}
-		
-		EntityAI currentItem = topLevelItems[rootIndex];
-		Print("[SST] FindItemByPath: Starting at root item " + rootIndex.ToString() + " = " + currentItem.GetType());
-		
-		// Navigate deeper into the path
-		int partIdx = 1;
-		while (partIdx < parts.Count() && currentItem)
-		{
-			string part = parts[partIdx];
-			
-			if (part == "cargo")
-			{
-				// Next part should be index
-				partIdx++;
-				if (partIdx >= parts.Count())
-					break;
-				
-				int cargoIdx = parts[partIdx].ToInt();
-				CargoBase cargo = currentItem.GetInventory().GetCargo();
-				if (!cargo)
-				{
-					Print("[SST] FindItemByPath: Item " + currentItem.GetType() + " has no cargo");
-					return null;
-				}
-				if (cargoIdx < 0 || cargoIdx >= cargo.GetItemCount())
-				{
-					Print("[SST] FindItemByPath: Cargo index " + cargoIdx.ToString() + " out of bounds (have " + cargo.GetItemCount().ToString() + " items)");
-					return null;
-				}
-				
-				currentItem = cargo.GetItem(cargoIdx);
-				Print("[SST] FindItemByPath: Navigated to cargo[" + cargoIdx.ToString() + "] = " + currentItem.GetType());
-			}
-			else if (part == "attachments")
-			{
-				// Next part should be index
-				partIdx++;
-				if (partIdx >= parts.Count())
-					break;
-				
-				int attIdx = parts[partIdx].ToInt();
-				int navAttCount = currentItem.GetInventory().AttachmentCount();
-				if (attIdx < 0 || attIdx >= navAttCount)
-				{
-					Print("[SST] FindItemByPath: Attachment index " + attIdx.ToString() + " out of bounds (have " + navAttCount.ToString() + " attachments)");
-					return null;
-				}
-				
-				currentItem = currentItem.GetInventory().GetAttachmentFromIndex(attIdx);
-				Print("[SST] FindItemByPath: Navigated to attachment[" + attIdx.ToString() + "] = " + currentItem.GetType());
-			}
-			else
-			{
-				Print("[SST] FindItemByPath: Unknown path part: " + part);
-				// Unknown path part
-				return null;
-			}
-			
-			partIdx++;
-		}
 		
-		// Verify the class name matches
-		if (currentItem && currentItem.GetType() == expectedClassName)
-			return currentItem;
+		// Id-only request whose id went stale: class name search is all that's left
+		if (path == "")
+			return SST_InventoryTraversal.FindByClassName(player, expectedClassName);
 		
-		// If path navigation failed but we have the expected class, search by class name as fallback
-		if (!currentItem)
-		{
-			return FindItemByClassName(player, expectedClassName);
-		}
+		// Same top-level ordering as the inventory export
+		EntityAI item = SST_InventoryTraversal.ResolvePath(player, path);
 		
-		return currentItem;
-	}
-	
-	// Fallback: find first item matching class name in player's inventory
-	protected EntityAI FindItemByClassName(PlayerBase player, string className)
-	{
-		array<EntityAI> items = new array<EntityAI>();
-		player.GetInventory().EnumerateInventory(InventoryTraversalType.PREORDER, items);
-		
-		foreach (EntityAI item : items)
-		{
-			if (item.GetType() == className)
-				return item;
-		}
+		// If path navigation failed, search by class name as fallback
+		if (!item)
+			return SST_InventoryTraversal.FindByClassName(player, expectedClassName);
 		
-		return null;
-	}
-	
-	protected PlayerBase FindPlayerBySteamId(string steamId)
-	{
-		array<Man> players = new array<Man>();
-		GetGame().GetPlayers(players);
-		
-		foreach (Man man : players)
-		{
-			if (!man)
-				continue;
-				
-			PlayerIdentity identity = man.GetIdentity();
-			if (identity && identity.GetPlainId() == steamId)
-			{
-				return PlayerBase.Cast(man);
-			}
-		}
-		return null;
+		return item;
 	}
 }
 
@@ -898,15 +1221,28 @@ modded class ItemBase
 		if (!GetGame().IsServer())
 			return;
 		
-		// Get old and new owners (players)
+		// Resolve each owner once; a move within the same parent never changes the owner
+		EntityAI oldParent = oldLoc.GetParent();
+		EntityAI newParent = newLoc.GetParent();
 		PlayerBase oldPlayer = null;
 		PlayerBase newPlayer = null;
 		
-		if (oldLoc.GetParent())
-			oldPlayer = PlayerBase.Cast(oldLoc.GetParent().GetHierarchyRootPlayer());
+		if (oldParent)
+			oldPlayer = PlayerBase.Cast(oldParent.GetHierarchyRootPlayer());
+		
+		if (newParent == oldParent)
+			newPlayer = oldPlayer;
+		else if (newParent)
+			newPlayer = PlayerBase.Cast(newParent.GetHierarchyRootPlayer());
 		
-		if (newLoc.GetParent())
-			newPlayer = PlayerBase.Cast(newLoc.GetParent().GetHierarchyRootPlayer());
+		// Any move touching a player's inventory (including own slot shuffles) changes their export
+		SST_InventoryDirtyTracker.MarkPlayer(oldPlayer);
+		if (newPlayer != oldPlayer)
+			SST_InventoryDirtyTracker.MarkPlayer(newPlayer);
+		
+		// Same owner (or none) on both sides: nothing to log
+		if (oldPlayer == newPlayer)
+			return;
 		
 		vector itemPos = GetPosition();
 		
@@ -939,10 +1275,35 @@ modded class ItemBase
 			}
 		}
 		// Item transferred between players
-		else if (oldPlayer && newPlayer && oldPlayer != newPlayer)
+		else
 		{
 			SST_InventoryEventLogger.LogRemoved(oldPlayer, this, itemPos);
 			SST_InventoryEventLogger.LogAdded(newPlayer, this, itemPos);
 		}
 	}
+	
+	override void OnQuantityChanged(float delta)
+	{
+		super.OnQuantityChanged(delta);
+		
+		if (GetGame().IsServer())
+			SST_InventoryDirtyTracker.MarkEntityOwner(this);
+	}
+	
+	override void EEHealthLevelChanged(int oldLevel, int newLevel, string zone)
+	{
+		super.EEHealthLevelChanged(oldLevel, newLevel, zone);
+		
+		if (GetGame().IsServer())
+			SST_InventoryDirtyTracker.MarkEntityOwner(this);
+	}
+	
+	override void EEDelete(EntityAI parent)
+	{
+		// Deleting an item does not raise EEItemLocationChanged
+		if (GetGame().IsServer())
+			SST_InventoryDirtyTracker.MarkEntityOwner(this);
+		
+		super.EEDelete(parent);
+	}
 }
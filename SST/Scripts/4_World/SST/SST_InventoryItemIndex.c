@@ -0,0 +1,78 @@
+/**
+ * @file SST_InventoryItemIndex.c
+ * @brief Stable item ids and a per-player id -> entity index.
+ *
+ * The inventory exporter stamps every exported item with an id and rebuilds the
+ * owning player's index while it walks the tree. The item delete API resolves
+ * an itemId from the dashboard with a single map lookup instead of re-walking
+ * the inventory; the positional itemPath is only used when the id is stale.
+ */
+
+class SST_InventoryItemIndex
+{
+	protected static ref SST_InventoryItemIndex s_Instance;
+
+	// Steam64 -> (itemId -> entity). Entity pointers are weak and become null once the item is deleted.
+	protected ref map<string, ref map<string, EntityAI>> m_PlayerIndexes;
+
+	void SST_InventoryItemIndex()
+	{
+		m_PlayerIndexes = new map<string, ref map<string, EntityAI>>();
+	}
+
+	static SST_InventoryItemIndex GetInstance()
+	{
+		if (!s_Instance)
+			s_Instance = new SST_InventoryItemIndex();
+		return s_Instance;
+	}
+
+	// Persistent ID when the item has been saved to storage, network ID otherwise
+	static string GetItemId(EntityAI item)
+	{
+		if (!item)
+			return "";
+
+		int b1, b2, b3, b4;
+		item.GetPersistentID(b1, b2, b3, b4);
+		if (b1 != 0 || b2 != 0 || b3 != 0 || b4 != 0)
+			return string.Format("%1-%2-%3-%4", b1, b2, b3, b4);
+
+		int low, high;
+		item.GetNetworkID(low, high);
+		return string.Format("n%1-%2", low, high);
+	}
+
+	// Start a fresh index for the player; the exporter fills it while walking the inventory
+	map<string, EntityAI> ResetPlayer(string playerId)
+	{
+		map<string, EntityAI> index = new map<string, EntityAI>();
+		m_PlayerIndexes.Set(playerId, index);
+		return index;
+	}
+
+	void RemovePlayer(string playerId)
+	{
+		m_PlayerIndexes.Remove(playerId);
+	}
+
+	// Resolve an exported itemId, only if the item still exists and is still carried by this player
+	EntityAI Resolve(Man player, string itemId)
+	{
+		if (!player || !player.GetIdentity() || itemId == "")
+			return null;
+
+		map<string, EntityAI> index = m_PlayerIndexes.Get(player.GetIdentity().GetPlainId());
+		if (!index)
+			return null;
+
+		EntityAI item = index.Get(itemId);
+		if (!item)
+			return null;
+
+		if (item.GetHierarchyRootPlayer() != player)
+			return null;
+
+		return item;
+	}
+}
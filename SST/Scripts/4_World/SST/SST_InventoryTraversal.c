@@ -0,0 +1,193 @@
+/**
+ * @file SST_InventoryTraversal.c
+ * @brief Shared single-pass walk over a player's attachment/cargo tree.
+ *
+ * Used by both the inventory exporter and the item delete API so that the
+ * top-level item order (and therefore item paths like "0.cargo.2") is
+ * produced by exactly one piece of code.
+ */
+
+class SST_InventoryTraversal
+{
+	// Collect the player's top-level items in a deterministic order:
+	// attachments by attachment index, then the item in hands, then player cargo.
+	static void GetTopLevelItems(Man player, array<EntityAI> items)
+	{
+		if (!player || !items)
+			return;
+
+		GameInventory inventory = player.GetInventory();
+		if (!inventory)
+			return;
+
+		int attachmentCount = inventory.AttachmentCount();
+		for (int i = 0; i < attachmentCount; i++)
+		{
+			EntityAI attachment = inventory.GetAttachmentFromIndex(i);
+			if (attachment)
+				items.Insert(attachment);
+		}
+
+		HumanInventory humanInventory = player.GetHumanInventory();
+		if (humanInventory)
+		{
+			EntityAI inHands = humanInventory.GetEntityInHands();
+			if (inHands)
+				items.Insert(inHands);
+		}
+
+		CargoBase cargo = inventory.GetCargo();
+		if (cargo)
+		{
+			int cargoCount = cargo.GetItemCount();
+			for (int j = 0; j < cargoCount; j++)
+			{
+				EntityAI cargoItem = cargo.GetItem(j);
+				if (cargoItem)
+					items.Insert(cargoItem);
+			}
+		}
+	}
+
+	// Slot ID if the item is attached somewhere, -1 otherwise (cargo, hands, ground)
+	static int GetAttachmentSlotId(EntityAI item)
+	{
+		if (!item || !item.GetInventory())
+			return -1;
+
+		InventoryLocation loc = new InventoryLocation();
+		if (!item.GetInventory().GetCurrentInventoryLocation(loc))
+			return -1;
+
+		if (loc.GetType() != InventoryLocationType.ATTACHMENT)
+			return -1;
+
+		return loc.GetSlot();
+	}
+
+	// Resolve an export path such as "0.cargo.2" or "3.attachments.0.cargo.1"
+	static EntityAI ResolvePath(Man player, string path)
+	{
+		if (!player || path == "")
+			return null;
+
+		array<string> parts = new array<string>();
+		path.Split(".", parts);
+
+		if (parts.Count() < 1)
+			return null;
+
+		array<EntityAI> topLevelItems = new array<EntityAI>();
+		GetTopLevelItems(player, topLevelItems);
+
+		int rootIndex = parts[0].ToInt();
+		if (rootIndex < 0 || rootIndex >= topLevelItems.Count())
+		{
+			Print("[SST] ResolvePath: Root index " + rootIndex.ToString() + " out of bounds (have " + topLevelItems.Count().ToString() + " top-level items)");
+			return null;
+		}
+
+		EntityAI currentItem = topLevelItems[rootIndex];
+
+		int partIdx = 1;
+		while (partIdx < parts.Count() && currentItem)
+		{
+			string part = parts[partIdx];
+			if (part != "cargo" && part != "attachments")
+			{
+				Print("[SST] ResolvePath: Unknown path part: " + part);
+				return null;
+			}
+
+			// Every container part must be followed by an index
+			partIdx++;
+			if (partIdx >= parts.Count())
+				break;
+
+			int childIdx = parts[partIdx].ToInt();
+
+			if (part == "cargo")
+			{
+				CargoBase cargo = currentItem.GetInventory().GetCargo();
+				if (!cargo)
+				{
+					Print("[SST] ResolvePath: Item " + currentItem.GetType() + " has no cargo");
+					return null;
+				}
+				if (childIdx < 0 || childIdx >= cargo.GetItemCount())
+				{
+					Print("[SST] ResolvePath: Cargo index " + childIdx.ToString() + " out of bounds (have " + cargo.GetItemCount().ToString() + " items)");
+					return null;
+				}
+
+				currentItem = cargo.GetItem(childIdx);
+			}
+			else
+			{
+				int attCount = currentItem.GetInventory().AttachmentCount();
+				if (childIdx < 0 || childIdx >= attCount)
+				{
+					Print("[SST] ResolvePath: Attachment index " + childIdx.ToString() + " out of bounds (have " + attCount.ToString() + " attachments)");
+					return null;
+				}
+
+				currentItem = currentItem.GetInventory().GetAttachmentFromIndex(childIdx);
+			}
+
+			partIdx++;
+		}
+
+		return currentItem;
+	}
+
+	// Depth-first search below root for the first item of the given class
+	static EntityAI FindByClassName(EntityAI root, string className)
+	{
+		if (!root || !root.GetInventory())
+			return null;
+
+		GameInventory inventory = root.GetInventory();
+
+		int attachmentCount = inventory.AttachmentCount();
+		for (int i = 0; i < attachmentCount; i++)
+		{
+			EntityAI attachment = inventory.GetAttachmentFromIndex(i);
+			EntityAI foundInAttachment = MatchOrDescend(attachment, className);
+			if (foundInAttachment)
+				return foundInAttachment;
+		}
+
+		Man man = Man.Cast(root);
+		if (man && man.GetHumanInventory())
+		{
+			EntityAI foundInHands = MatchOrDescend(man.GetHumanInventory().GetEntityInHands(), className);
+			if (foundInHands)
+				return foundInHands;
+		}
+
+		CargoBase cargo = inventory.GetCargo();
+		if (cargo)
+		{
+			int cargoCount = cargo.GetItemCount();
+			for (int j = 0; j < cargoCount; j++)
+			{
+				EntityAI foundInCargo = MatchOrDescend(cargo.GetItem(j), className);
+				if (foundInCargo)
+					return foundInCargo;
+			}
+		}
+
+		return null;
+	}
+
+	protected static EntityAI MatchOrDescend(EntityAI item, string className)
+	{
+		if (!item)
+			return null;
+
+		if (item.GetType() == className)
+			return item;
+
+		return FindByClassName(item, className);
+	}
+}
@@ -2,11 +2,13 @@
  * @file SST_PlayerCommands.c
  * @brief Processes admin-initiated player commands from the SST API queue.
  *
- * Reads queued commands (heal, teleport, direct message, broadcast) from JSON,
- * executes them on the server, and writes results back to the results file.
+ * Reads queued commands (heal, teleport, direct message, broadcast) from the
+ * command spool, executes them on the server, and appends each result to the
+ * queue's results journal (SST_CommandSpool, SST_ResultsJournal).
  *
- * Queue file:   $profile:SST/api/player_commands.json
- * Results file: $profile:SST/api/player_commands_results.json
+ * Spool:        $profile:SST/api/spool/player_commands/{incoming,processing}/
+ * Results:      $profile:SST/api/results/player_commands/
+ * Legacy queue: $profile:SST/api/player_commands.json, still drained
  */
 
 // ============================================================================
@@ -39,19 +41,23 @@ class SST_PlayerCommandQueue
 // ============================================================================
 // Player Commands API - Executes queued admin actions
 // ============================================================================
-class SST_PlayerCommands
+class SST_PlayerCommands : SST_CommandHandler
 {
 	protected static ref SST_PlayerCommands s_Instance;
 	static const string COMMAND_QUEUE_FILE = "$profile:SST/api/player_commands.json";
-	static const string COMMAND_RESULTS_FILE = "$profile:SST/api/player_commands_results.json";
+	static const string SPOOL_QUEUE = "player_commands";
 	static const float CHECK_INTERVAL = 2000.0; // Check every 2 seconds for faster response
 	
+	protected ref SST_CommandSpool m_Spool;
+	
 	void SST_PlayerCommands()
 	{
 		if (!FileExist("$profile:SST"))
 			MakeDirectory("$profile:SST");
 		if (!FileExist("$profile:SST/api"))
 			MakeDirectory("$profile:SST/api");
+		
+		m_Spool = new SST_CommandSpool(SPOOL_QUEUE);
 	}
 	
 	static SST_PlayerCommands GetInstance()
@@ -68,7 +74,7 @@ class SST_PlayerCommands
 	
 	protected void Init()
 	{
-		Print("[SST] Player Commands API initialized - checking " + COMMAND_QUEUE_FILE + " every 2 seconds");
+		Print("[SST] Player Commands API initialized - checking spool " + SPOOL_QUEUE + " and " + COMMAND_QUEUE_FILE + " every 2 seconds");
 		GetGame().GetCallQueue(CALL_CATEGORY_SYSTEM).CallLater(ProcessCommandsAndSchedule, 2000, false);
 	}
 	
@@ -83,6 +89,50 @@ class SST_PlayerCommands
 		if (!GetGame().IsServer())
 			return;
 		
+		ProcessSpooledCommands();
+		ProcessLegacyCommandQueue();
+	}
+	
+	// SST_CommandExecutor: run one claimed command file
+	override void ExecuteSpooled(SST_CommandSpool spool, string fileName)
+	{
+		ExecuteCommandFile(fileName);
+	}
+	
+	// Claim spooled requests (current API); SST_CommandExecutor runs them within its tick budget
+	protected void ProcessSpooledCommands()
+	{
+		SST_CommandExecutor.GetInstance().Pull(m_Spool, this);
+	}
+	
+	protected void ExecuteCommandFile(string fileName)
+	{
+		ref SST_PlayerCommandRequest request;
+		string errorMsg;
+		if (!JsonFileLoader<SST_PlayerCommandRequest>.LoadFile(m_Spool.GetProcessingPath(fileName), request, errorMsg) || !request)
+		{
+			request = new SST_PlayerCommandRequest();
+			request.processed = true;
+			request.result = "INVALID_REQUEST";
+			Print("[SST] ERROR: Spool command: unreadable request " + fileName + ": " + errorMsg);
+		}
+		else if (m_Spool.IsRecovered(fileName))
+		{
+			// Claimed before a restart: it may or may not have run, so don't run it again
+			request.processed = true;
+			request.result = "INTERRUPTED";
+		}
+		else
+		{
+			ProcessSingleCommand(request);
+		}
+		
+		m_Spool.Complete(fileName, SST_ResultJson<SST_PlayerCommandRequest>.Write(request));
+	}
+	
+	// player_commands.json from API versions before the spool: drained, then deleted
+	protected void ProcessLegacyCommandQueue()
+	{
 		if (!FileExist(COMMAND_QUEUE_FILE))
 			return;
 		
@@ -96,7 +146,10 @@ class SST_PlayerCommands
 		}
 		
 		if (!commandQueue || commandQueue.requests.Count() == 0)
+		{
+			DeleteFile(COMMAND_QUEUE_FILE);
 			return;
+		}
 		
 		bool hasChanges = false;
 		
@@ -107,20 +160,14 @@ class SST_PlayerCommands
 			
 			hasChanges = true;
 			ProcessSingleCommand(request);
+			
+			// Legacy commands carry no requestId: journaled, but not indexed
+			m_Spool.GetResults().Append("", "", SST_ResultJson<SST_PlayerCommandRequest>.Write(request));
 		}
 		
+		// Remove the drained queue so idle polls only cost a FileExist
 		if (hasChanges)
-		{
-			// Save updated queue with results
-			if (!JsonFileLoader<SST_PlayerCommandQueue>.SaveFile(COMMAND_RESULTS_FILE, commandQueue, errorMsg))
-			{
-				Print("[SST] ERROR: Failed to save command results: " + errorMsg);
-			}
-			
-			// Clear the original queue file
-			ref SST_PlayerCommandQueue emptyQueue = new SST_PlayerCommandQueue();
-			JsonFileLoader<SST_PlayerCommandQueue>.SaveFile(COMMAND_QUEUE_FILE, emptyQueue, errorMsg);
-		}
+			DeleteFile(COMMAND_QUEUE_FILE);
 	}
 	
 	protected void ProcessSingleCommand(SST_PlayerCommandRequest request)
@@ -135,7 +182,7 @@ class SST_PlayerCommands
 		}
 		
 		// Find the player
-		PlayerBase targetPlayer = FindPlayerBySteamId(request.playerId);
+		PlayerBase targetPlayer = SST_PlayerIndex.FindBySteamId(request.playerId);
 		if (!targetPlayer)
 		{
 			request.result = "PLAYER_NOT_FOUND";
@@ -351,23 +398,4 @@ class SST_PlayerCommands
 		ref Param1<string> params = new Param1<string>(message);
 		GetGame().RPCSingleParam(player, ERPCs.RPC_USER_ACTION_MESSAGE, params, true, player.GetIdentity());
 	}
-	
-	protected PlayerBase FindPlayerBySteamId(string steamId)
-	{
-		array<Man> players = new array<Man>();
-		GetGame().GetPlayers(players);
-		
-		foreach (Man man : players)
-		{
-			if (!man)
-				continue;
-				
-			PlayerIdentity identity = man.GetIdentity();
-			if (identity && identity.GetPlainId() == steamId)
-			{
-				return PlayerBase.Cast(man);
-			}
-		}
-		return null;
-	}
 }
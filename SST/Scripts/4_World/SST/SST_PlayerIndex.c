@@ -0,0 +1,150 @@
+/**
+ * @file SST_PlayerIndex.c
+ * @brief Steam64 / BI id -> PlayerBase index shared by the command processors.
+ *
+ * Every processor used to resolve request.playerId with its own copy of
+ * FindPlayerBySteamId(), which calls GetGame().GetPlayers() and compares every
+ * identity. A batch of 200 grants meant 200 full scans of the player list.
+ *
+ * MissionServer.InvokeOnConnect() adds the player (also after a respawn, which
+ * creates a new entity) and InvokeOnDisconnect() removes them, so a lookup is
+ * one map access. A lookup re-checks the identity of the entity it found.
+ * Stale entries and misses fall back to Rebuild() from GetPlayers(), at most
+ * once per REBUILD_INTERVAL, in case a player was swapped without the hooks.
+ */
+
+class SST_PlayerIndex
+{
+	protected static ref SST_PlayerIndex s_Instance;
+
+	static const int REBUILD_INTERVAL = 10000;     // ms between fallback rebuilds on a miss
+
+	// Weak: the entities belong to the game
+	protected ref map<string, PlayerBase> m_ByPlainId;
+	protected ref map<string, PlayerBase> m_ByBiId;
+
+	protected int m_LastRebuildAt;
+
+	void SST_PlayerIndex()
+	{
+		m_ByPlainId = new map<string, PlayerBase>();
+		m_ByBiId = new map<string, PlayerBase>();
+		m_LastRebuildAt = -REBUILD_INTERVAL;
+	}
+
+	static SST_PlayerIndex GetInstance()
+	{
+		if (!s_Instance)
+			s_Instance = new SST_PlayerIndex();
+		return s_Instance;
+	}
+
+	// Steam64 (plain id) lookup; null if the player is not online
+	static PlayerBase FindBySteamId(string steamId)
+	{
+		return GetInstance().FindByPlainId(steamId);
+	}
+
+	void Add(PlayerBase player)
+	{
+		if (!player || !player.GetIdentity())
+			return;
+
+		m_ByPlainId.Set(player.GetIdentity().GetPlainId(), player);
+		m_ByBiId.Set(player.GetIdentity().GetId(), player);
+	}
+
+	void Remove(PlayerBase player)
+	{
+		if (!player)
+			return;
+
+		RemoveEntity(m_ByPlainId, player);
+		RemoveEntity(m_ByBiId, player);
+	}
+
+	PlayerBase FindByPlainId(string plainId)
+	{
+		if (plainId == "")
+			return null;
+
+		PlayerBase player = m_ByPlainId.Get(plainId);
+		if (IsValid(player) && player.GetIdentity().GetPlainId() == plainId)
+			return player;
+
+		if (!RebuildIfDue())
+			return null;
+
+		return m_ByPlainId.Get(plainId);
+	}
+
+	PlayerBase FindByBiId(string biId)
+	{
+		if (biId == "")
+			return null;
+
+		PlayerBase player = m_ByBiId.Get(biId);
+		if (IsValid(player) && player.GetIdentity().GetId() == biId)
+			return player;
+
+		if (!RebuildIfDue())
+			return null;
+
+		return m_ByBiId.Get(biId);
+	}
+
+	int GetCount()
+	{
+		return m_ByPlainId.Count();
+	}
+
+	// Copy the online players into players, one per Steam64 ID
+	void GetPlayers(notnull array<PlayerBase> players)
+	{
+		players.Clear();
+		for (int i = 0; i < m_ByPlainId.Count(); i++)
+		{
+			PlayerBase player = m_ByPlainId.GetElement(i);
+			if (IsValid(player) && player.GetIdentity().GetPlainId() == m_ByPlainId.GetKey(i))
+				players.Insert(player);
+		}
+	}
+
+	// Re-read the online players from the game
+	void Rebuild()
+	{
+		m_LastRebuildAt = GetGame().GetTime();
+		m_ByPlainId.Clear();
+		m_ByBiId.Clear();
+
+		array<Man> players = new array<Man>();
+		GetGame().GetPlayers(players);
+
+		foreach (Man man : players)
+			Add(PlayerBase.Cast(man));
+	}
+
+	protected bool RebuildIfDue()
+	{
+		if (GetGame().GetTime() - m_LastRebuildAt < REBUILD_INTERVAL)
+			return false;
+
+		Rebuild();
+		return true;
+	}
+
+	protected static bool IsValid(PlayerBase player)
+	{
+		return player && player.GetIdentity();
+	}
+
+	protected static void RemoveEntity(map<string, PlayerBase> index, PlayerBase player)
+	{
+		// Scan instead of using the identity: it may already be gone at disconnect
+		for (int i = index.Count() - 1; i >= 0; i--)
+		{
+			if (index.GetElement(i) == player)
+				index.RemoveElement(i);
+		}
+	}
+}
@@ -3,7 +3,12 @@
  * @brief Logs Expansion Market trades to per-player JSON files.
  *
  * Records purchases and sales (from Expansion Market hooks) to $profile:SST/trades/.
- * Intended for consumption by external tooling/dashboards.
+ * Intended for consumption by external tooling/dashboards. Files are written
+ * back through SST_LogSink, not on every trade, and loaded/evicted by
+ * SST_LogResidency around the player's session.
+ *
+ * <steam64>_trades.json keeps totals and the most recent trades; every trade is
+ * also appended to $profile:SST/history/trades/<steam64>/ (SST_NdjsonLog).
  */
 
 class SST_TradeEventType
@@ -15,6 +20,7 @@ class SST_TradeEventType
 class SST_TradeEventData
 {
 	string timestamp;
+	int timestampUnix;          // Same time as epoch seconds (SST_Clock.NowUnix)
 	string eventType;           // PURCHASE or SALE
 	string playerName;
 	string playerId;
@@ -40,10 +46,12 @@ class SST_PlayerTradeLog
 }
 
 // Aggregates and persists trade events.
-class SST_TradeLogger
+class SST_TradeLogger : SST_HistoryLogSinkClient
 {
 	protected static ref SST_TradeLogger s_Instance;
 	static const string TRADES_FOLDER = "$profile:SST/trades/";
+	static const string HISTORY_FOLDER = "$profile:SST/history/trades/";
+	static const int RECENT_TRADES = 500; // Trades kept in <steam64>_trades.json
 	
 	// Cache of loaded trade logs per player
 	protected ref map<string, ref SST_PlayerTradeLog> m_TradeLogs;
@@ -57,6 +65,8 @@ class SST_TradeLogger
 			MakeDirectory("$profile:SST");
 		if (!FileExist(TRADES_FOLDER))
 			MakeDirectory(TRADES_FOLDER);
+		
+		SST_LogResidency.GetInstance().Register(this);
 	}
 	
 	static SST_TradeLogger GetInstance()
@@ -66,20 +76,6 @@ class SST_TradeLogger
 		return s_Instance;
 	}
 	
-	static string GetUTCTimestamp()
-	{
-		int year, month, day, hour, minute, second;
-		GetYearMonthDayUTC(year, month, day);
-		GetHourMinuteSecondUTC(hour, minute, second);
-		return string.Format("%1-%2-%3T%4:%5:%6Z",
-			year.ToStringLen(4),
-			month.ToStringLen(2),
-			day.ToStringLen(2),
-			hour.ToStringLen(2),
-			minute.ToStringLen(2),
-			second.ToStringLen(2));
-	}
-	
 	// Log a trade event
 	void LogTrade(string eventType, PlayerBase player, string itemClassName, string itemDisplayName, int quantity, int price, string traderName, string traderZone, vector traderPosition)
 	{
@@ -99,7 +95,8 @@ class SST_TradeLogger
 		
 		// Create trade event data
 		ref SST_TradeEventData tradeData = new SST_TradeEventData();
-		tradeData.timestamp = GetUTCTimestamp();
+		tradeData.timestamp = SST_Clock.Now();
+		tradeData.timestampUnix = SST_Clock.NowUnix();
 		tradeData.eventType = eventType;
 		tradeData.playerName = playerName;
 		tradeData.playerId = playerId;
@@ -128,14 +125,17 @@ class SST_TradeLogger
 			playerLog.totalEarned += price;
 		}
 		
-		// Keep only last 500 trades per player to prevent file bloat
-		while (playerLog.trades.Count() > 500)
+		// The JSON file keeps the most recent trades (totals cover all of them); history goes to the NDJSON segments
+		while (playerLog.trades.Count() > RECENT_TRADES)
 		{
-			playerLog.trades.Remove(0);
+			playerLog.trades.RemoveOrdered(0);
 		}
 		
-		// Save to file
-		SavePlayerLog(playerId, playerLog);
+		QueueHistory(playerId, tradeData);
+		
+		// Written back by the sink (batched)
+		SST_LogSink.GetInstance().Append(this, playerId);
+		SST_EventStream.GetInstance().AppendTrade(tradeData);
 		
 		// Console log for debugging
 		Print("[SST] TRADE " + eventType + ": " + playerName + " - " + itemDisplayName + " x" + quantity + " for " + price);
@@ -147,22 +147,8 @@ class SST_TradeLogger
 		if (m_TradeLogs.Contains(playerId))
 			return m_TradeLogs.Get(playerId);
 		
-		// Try to load from file
-		string filePath = TRADES_FOLDER + playerId + "_trades.json";
-		ref SST_PlayerTradeLog playerLog;
-		
-		if (FileExist(filePath))
-		{
-			string errorMsg;
-			if (JsonFileLoader<SST_PlayerTradeLog>.LoadFile(filePath, playerLog, errorMsg))
-			{
-				m_TradeLogs.Set(playerId, playerLog);
-				return playerLog;
-			}
-		}
-		
-		// Create new log
-		playerLog = new SST_PlayerTradeLog();
+		// Not preloaded yet: start in memory, LoadLog merges the file in later (no disk access in hooks)
+		ref SST_PlayerTradeLog playerLog = new SST_PlayerTradeLog();
 		playerLog.playerName = playerName;
 		playerLog.playerId = playerId;
 		playerLog.totalPurchases = 0;
@@ -174,7 +160,50 @@ class SST_TradeLogger
 		return playerLog;
 	}
 	
-	protected void SavePlayerLog(string playerId, SST_PlayerTradeLog playerLog)
+	// Read <steam64>_trades.json; its totals add to and its trades go in front of anything logged since connect
+	override void LoadLog(string key)
+	{
+		string filePath = TRADES_FOLDER + key + "_trades.json";
+		if (!FileExist(filePath))
+			return;
+		
+		ref SST_PlayerTradeLog loaded;
+		string errorMsg;
+		if (!JsonFileLoader<SST_PlayerTradeLog>.LoadFile(filePath, loaded, errorMsg))
+		{
+			Print("[SST] WARNING: Could not read trade log for " + key + ": " + errorMsg);
+			return;
+		}
+		
+		ref SST_PlayerTradeLog playerLog = m_TradeLogs.Get(key);
+		if (!playerLog)
+		{
+			m_TradeLogs.Set(key, loaded);
+			return;
+		}
+		
+		playerLog.totalPurchases += loaded.totalPurchases;
+		playerLog.totalSales += loaded.totalSales;
+		playerLog.totalSpent += loaded.totalSpent;
+		playerLog.totalEarned += loaded.totalEarned;
+		
+		for (int i = loaded.trades.Count() - 1; i >= 0; i--)
+		{
+			playerLog.trades.InsertAt(loaded.trades[i], 0);
+		}
+		
+		while (playerLog.trades.Count() > RECENT_TRADES)
+		{
+			playerLog.trades.RemoveOrdered(0);
+		}
+	}
+	
+	override void UnloadLog(string key)
+	{
+		m_TradeLogs.Remove(key);
+	}
+	
+	protected bool SavePlayerLog(string playerId, SST_PlayerTradeLog playerLog)
 	{
 		string filePath = TRADES_FOLDER + playerId + "_trades.json";
 		string errorMsg;
@@ -182,7 +211,53 @@ class SST_TradeLogger
 		if (!JsonFileLoader<SST_PlayerTradeLog>.SaveFile(filePath, playerLog, errorMsg))
 		{
 			Print("[SST] ERROR: Failed to save trade log for " + playerId + ": " + errorMsg);
+			return false;
 		}
+		return true;
+	}
+	
+	override string GetLogSinkName()
+	{
+		return "trades";
+	}
+	
+	override string GetHistoryFolder()
+	{
+		return HISTORY_FOLDER;
+	}
+	
+	override void WriteHistoryRecord(SST_JsonWriter writer, Class record)
+	{
+		WriteTradeEvent(writer, SST_TradeEventData.Cast(record));
+	}
+	
+	override bool SaveRecentLog(string key)
+	{
+		ref SST_PlayerTradeLog playerLog = m_TradeLogs.Get(key);
+		if (!playerLog)
+			return true;
+		
+		return SavePlayerLog(key, playerLog);
+	}
+	
+	// Same layout as JsonFileLoader<SST_TradeEventData>; also used by SST_EventStream
+	static void WriteTradeEvent(SST_JsonWriter writer, SST_TradeEventData trade)
+	{
+		writer.BeginObject();
+		writer.WriteString("timestamp", trade.timestamp);
+		writer.WriteInt("timestampUnix", trade.timestampUnix);
+		writer.WriteString("eventType", trade.eventType);
+		writer.WriteString("playerName", trade.playerName);
+		writer.WriteString("playerId", trade.playerId);
+		writer.WriteString("itemClassName", trade.itemClassName);
+		writer.WriteString("itemDisplayName", trade.itemDisplayName);
+		writer.WriteInt("quantity", trade.quantity);
+		writer.WriteInt("price", trade.price);
+		writer.WriteString("traderName", trade.traderName);
+		writer.WriteString("traderZone", trade.traderZone);
+		writer.WriteVector("traderPosition", trade.traderPosition);
+		writer.WriteVector("playerPosition", trade.playerPosition);
+		writer.EndObject();
 	}
 	
 	// Static helper methods for easy calling
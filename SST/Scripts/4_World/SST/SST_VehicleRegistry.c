@@ -0,0 +1,182 @@
+/**
+ * @file SST_VehicleRegistry.c
+ * @brief Live vehicle entities, maintained from the vehicles' own init/delete hooks.
+ *
+ * SST_VehicleTracker used to find vehicles with SceneGetEntitiesInBox() over
+ * a hard-coded 15.5 km box, which returns every dynamic entity on the map
+ * (items on the ground included), and then tried to cast each one to a keyed
+ * vehicle. That ran every 60 s and for every key/delete request.
+ *
+ * CarScript and, with Expansion Vehicles, ExpansionVehicleBase add themselves
+ * here in EEInit() and remove themselves in EEDelete(), so a position update
+ * only walks the vehicles. Those are the two kinds ExpansionVehicle.Get()
+ * accepts, which is what the old scan filtered on. Because nothing depends on a world
+ * box, it works on any map size. The registry holds weak references, and
+ * entries whose entity is gone are dropped by GetVehicles().
+ *
+ * It also maps key ids (the Expansion master key persistent id "A-B-C-D") to
+ * vehicles, so a key or delete request resolves its vehicle with one map
+ * lookup. SST_VehicleTracker sets the id after the vehicle loads from storage
+ * (AfterStoreLoad), when a key is paired, and on every position update. The
+ * entry is removed together with the vehicle.
+ */
+
+class SST_VehicleRegistry
+{
+	protected static ref SST_VehicleRegistry s_Instance;
+
+	// Weak: the entities belong to the game
+	protected ref array<EntityAI> m_Vehicles;
+	protected ref map<string, EntityAI> m_ByKeyId;
+	protected ref map<EntityAI, string> m_KeyIdOf;
+
+	void SST_VehicleRegistry()
+	{
+		m_Vehicles = new array<EntityAI>();
+		m_ByKeyId = new map<string, EntityAI>();
+		m_KeyIdOf = new map<EntityAI, string>();
+	}
+
+	static SST_VehicleRegistry GetInstance()
+	{
+		if (!s_Instance)
+			s_Instance = new SST_VehicleRegistry();
+		return s_Instance;
+	}
+
+	void Add(EntityAI vehicle)
+	{
+		if (!vehicle || m_Vehicles.Find(vehicle) != -1)
+			return;
+
+		m_Vehicles.Insert(vehicle);
+	}
+
+	void Remove(EntityAI vehicle)
+	{
+		int index = m_Vehicles.Find(vehicle);
+		if (index != -1)
+			m_Vehicles.Remove(index);
+
+		string keyId;
+		if (m_KeyIdOf.Find(vehicle, keyId))
+		{
+			m_KeyIdOf.Remove(vehicle);
+			if (m_ByKeyId.Get(keyId) == vehicle)
+				m_ByKeyId.Remove(keyId);
+		}
+	}
+
+	// Record the vehicle's key id; replaces the one it had before (re-paired)
+	void SetKeyId(EntityAI vehicle, string keyId)
+	{
+		if (!vehicle || keyId == "")
+			return;
+
+		string previous;
+		if (m_KeyIdOf.Find(vehicle, previous))
+		{
+			if (previous == keyId)
+				return;
+			if (m_ByKeyId.Get(previous) == vehicle)
+				m_ByKeyId.Remove(previous);
+		}
+
+		m_KeyIdOf.Set(vehicle, keyId);
+		m_ByKeyId.Set(keyId, vehicle);
+	}
+
+	// Vehicle last recorded with this key id; null if none (the caller verifies the id is still current)
+	EntityAI FindByKeyId(string keyId)
+	{
+		return m_ByKeyId.Get(keyId);
+	}
+
+	// Copy the live vehicles into vehicles (order not kept)
+	void GetVehicles(notnull array<EntityAI> vehicles)
+	{
+		vehicles.Clear();
+
+		for (int i = m_Vehicles.Count() - 1; i >= 0; i--)
+		{
+			EntityAI vehicle = m_Vehicles[i];
+			if (!vehicle)
+			{
+				m_Vehicles.Remove(i);
+				continue;
+			}
+
+			vehicles.Insert(vehicle);
+		}
+	}
+
+	int GetCount()
+	{
+		return m_Vehicles.Count();
+	}
+}
+
+// ============================================================================
+// Mod CarScript to keep the registry current (server only)
+// ============================================================================
+modded class CarScript
+{
+	override void EEInit()
+	{
+		super.EEInit();
+
+		if (GetGame().IsServer())
+			SST_VehicleRegistry.GetInstance().Add(this);
+	}
+
+	override void EEDelete(EntityAI parent)
+	{
+		if (GetGame().IsServer())
+			SST_VehicleRegistry.GetInstance().Remove(this);
+
+		super.EEDelete(parent);
+	}
+
+#ifdef EXPANSIONMODVEHICLE
+	// The master key id is part of the stored state, so it is known only after loading
+	override void AfterStoreLoad()
+	{
+		super.AfterStoreLoad();
+
+		if (GetGame().IsServer())
+			SST_VehicleTracker.IndexVehicle(this);
+	}
+#endif
+}
+
+#ifdef EXPANSIONMODVEHICLE
+// ============================================================================
+// Mod ExpansionVehicleBase (Expansion's own vehicles, not CarScript) the same way
+// ============================================================================
+modded class ExpansionVehicleBase
+{
+	override void EEInit()
+	{
+		super.EEInit();
+
+		if (GetGame().IsServer())
+			SST_VehicleRegistry.GetInstance().Add(this);
+	}
+
+	override void EEDelete(EntityAI parent)
+	{
+		if (GetGame().IsServer())
+			SST_VehicleRegistry.GetInstance().Remove(this);
+
+		super.EEDelete(parent);
+	}
+
+	override void AfterStoreLoad()
+	{
+		super.AfterStoreLoad();
+
+		if (GetGame().IsServer())
+			SST_VehicleTracker.IndexVehicle(this);
+	}
+}
+#endif
@@ -4,6 +4,17 @@
  *
  * Tracks Expansion vehicle purchases, periodically records last known positions,
  * and processes API-driven requests for key generation and vehicle deletion.
+ * Vehicles are looked up in SST_VehicleRegistry, not by scanning the map.
+ *
+ * Purchases are appended to an NDJSON journal (vehicles/purchases/, one
+ * SST_NdjsonLog record per purchase) and folded into purchases_summary.json,
+ * so a purchase never rewrites the purchase history.
+ *
+ * Tracked vehicles are published as a full "tracked" snapshot at most once per
+ * FULL_SAVE_INTERVAL. In between, vehicles that moved more than
+ * POSITION_THRESHOLD metres or changed state go into a "tracked_delta"
+ * snapshot. The delta is cumulative since the full snapshot it names in
+ * baseGeneration, so a reader only needs the two files.
  *
  * This file is only compiled when Expansion Vehicles are present.
  */
@@ -30,6 +41,7 @@ class SST_VehicleKeyData
 class SST_VehiclePurchaseData
 {
 	string timestamp;
+	int timestampUnix;        // Same time as epoch seconds (SST_Clock.NowUnix)
 	string vehicleClassName;
 	string vehicleDisplayName;
 	string ownerId;           // Steam64 ID of purchaser
@@ -42,6 +54,26 @@ class SST_VehiclePurchaseData
 	vector purchasePosition;  // Where vehicle was spawned
 }
 
+// Per vehicle class totals in purchases_summary.json
+class SST_VehiclePurchaseClassTotal
+{
+	string vehicleClassName;
+	int count;
+	int spent;
+}
+
+// purchases_summary.json: running totals since the journal started (they outlive journal retention)
+class SST_VehiclePurchaseSummary
+{
+	string generatedAt;
+	int totalPurchases;
+	int totalSpent;
+	int firstPurchaseUnix;
+	int lastPurchaseUnix;
+	ref SST_VehiclePurchaseData lastPurchase;
+	ref array<ref SST_VehiclePurchaseClassTotal> classes = new array<ref SST_VehiclePurchaseClassTotal>();
+}
+
 class SST_TrackedVehicle
 {
 	string vehicleId;         // Unique identifier (persistent ID string)
@@ -51,7 +83,8 @@ class SST_TrackedVehicle
 	string ownerName;
 	string keyClassName;      // Key type used for this vehicle
 	vector lastPosition;
-	string lastUpdateTime;
+	string lastUpdateTime;    // Last recorded change: moved POSITION_THRESHOLD metres or ruined state changed
+	string lastSeenTime;      // Last position pass that found the vehicle loaded; published with the full snapshot
 	bool isDestroyed;
 	ref SST_VehicleKeyData keyData;
 	ref array<ref SST_VehicleKeyData> additionalKeys;  // If extra keys were made
@@ -61,6 +94,15 @@ class SST_TrackedVehicle
 	string traderZone;
 }
 
+// tracked_delta snapshot: changes since the "tracked" generation baseGeneration
+class SST_TrackedVehicleDelta
+{
+	int baseGeneration;
+	int sequence;             // Deltas published since that full snapshot
+	ref array<ref SST_TrackedVehicle> changed = new array<ref SST_TrackedVehicle>();
+	ref array<string> removed = new array<string>();
+}
+
 class SST_KeyGenerationRequest
 {
 	string requestId;
@@ -96,32 +138,57 @@ class SST_VehicleDeleteQueue
 // ----------------------------------------------------------------------------
 // Runtime service: keeps in-memory state, writes JSON, and executes requests
 // ----------------------------------------------------------------------------
-class SST_VehicleTracker
+class SST_VehicleTracker : SST_CommandHandler
 {
 	protected static ref SST_VehicleTracker s_Instance;
 	
 	static const string VEHICLES_FOLDER = "$profile:SST/vehicles/";
-	static const string PURCHASES_FILE = "$profile:SST/vehicles/purchases.json";
+	static const string PURCHASES_FOLDER = "$profile:SST/vehicles/purchases/";           // NDJSON journal (SST_NdjsonLog)
+	static const string PURCHASES_SUMMARY_FILE = "$profile:SST/vehicles/purchases_summary.json";
+	static const string PURCHASES_FILE = "$profile:SST/vehicles/purchases.json";         // Before the journal; imported once
+	static const string MIGRATED_SUFFIX = ".migrated";                                    // PURCHASES_FILE is renamed to this after the import
 	static const string TRACKED_FILE = "$profile:SST/vehicles/tracked.json";
+	static const string SNAPSHOT_CHANNEL = "vehicles";
+	static const string TRACKED_SNAPSHOT = "tracked";
+	static const string DELTA_SNAPSHOT = "tracked_delta";
 	static const string KEY_QUEUE_FILE = "$profile:SST/api/key_grants.json";
-	static const string KEY_RESULTS_FILE = "$profile:SST/api/key_grants_results.json";
 	static const string DELETE_QUEUE_FILE = "$profile:SST/api/vehicle_delete.json";
-	static const string DELETE_RESULTS_FILE = "$profile:SST/api/vehicle_delete_results.json";
 	
 	protected ref map<string, ref SST_TrackedVehicle> m_TrackedVehicles;
-	protected ref array<ref SST_VehiclePurchaseData> m_Purchases;
+	protected ref SST_NdjsonLog m_PurchaseLog;
+	protected ref SST_VehiclePurchaseSummary m_PurchaseSummary;
 	protected float m_UpdateTimer;
 	protected float m_KeyCheckTimer;
 	
 	static const float POSITION_UPDATE_INTERVAL = 60.0;  // Update positions every 60 seconds
 	static const float KEY_CHECK_INTERVAL = 5.0;         // Check for key requests every 5 seconds
+	static const string KEY_SPOOL_QUEUE = "key_grants";
+	static const string DELETE_SPOOL_QUEUE = "vehicle_delete";
+	static const int REINDEX_INTERVAL = 10000;           // ms between full key id re-indexes on a lookup miss
+	static const float FULL_SAVE_INTERVAL = 300.0;       // At most one full tracked snapshot per 5 minutes
+	static const float POSITION_THRESHOLD = 5.0;         // Metres a vehicle must move before it is exported again
+	
+	// Vehicle ids changed or removed since the last full snapshot (the cumulative delta)
+	protected ref map<string, bool> m_ChangedIds;
+	protected ref map<string, bool> m_RemovedIds;
+	protected bool m_DeltaPending;                       // Changes not published in a delta yet
+	protected bool m_SeenSinceSave;                      // lastSeenTime moved on since the last full snapshot
+	protected int m_DeltaSequence;
+	protected float m_FullSaveTimer;
+	
+	protected ref SST_CommandSpool m_KeySpool;
+	protected ref SST_CommandSpool m_DeleteSpool;
+	
+	protected int m_LastReindexAt;
 	
 	void SST_VehicleTracker()
 	{
 		m_TrackedVehicles = new map<string, ref SST_TrackedVehicle>();
-		m_Purchases = new array<ref SST_VehiclePurchaseData>();
+		m_ChangedIds = new map<string, bool>();
+		m_RemovedIds = new map<string, bool>();
 		m_UpdateTimer = 0;
 		m_KeyCheckTimer = 0;
+		m_LastReindexAt = -REINDEX_INTERVAL;
 		
 		// Create folders
 		if (!FileExist("$profile:SST"))
@@ -130,6 +197,13 @@ class SST_VehicleTracker
 			MakeDirectory(VEHICLES_FOLDER);
 		if (!FileExist("$profile:SST/api"))
 			MakeDirectory("$profile:SST/api");
+		
+		m_KeySpool = new SST_CommandSpool(KEY_SPOOL_QUEUE);
+		m_DeleteSpool = new SST_CommandSpool(DELETE_SPOOL_QUEUE);
+			
+		m_PurchaseLog = new SST_NdjsonLog(PURCHASES_FOLDER);
+		LoadPurchaseSummary();
+		ImportLegacyPurchases();
 			
 		// Load existing data
 		LoadTrackedVehicles();
@@ -142,20 +216,6 @@ class SST_VehicleTracker
 		return s_Instance;
 	}
 	
-	static string GetUTCTimestamp()
-	{
-		int year, month, day, hour, minute, second;
-		GetYearMonthDayUTC(year, month, day);
-		GetHourMinuteSecondUTC(hour, minute, second);
-		return string.Format("%1-%2-%3T%4:%5:%6Z",
-			year.ToStringLen(4),
-			month.ToStringLen(2),
-			day.ToStringLen(2),
-			hour.ToStringLen(2),
-			minute.ToStringLen(2),
-			second.ToStringLen(2));
-	}
-	
 	// Called when a vehicle is purchased with a key
 	void OnVehiclePurchased(PlayerBase player, EntityAI vehicleEntity, ExpansionCarKey key, string keyClassName, int price, string traderName, string traderZone)
 	{
@@ -178,7 +238,8 @@ class SST_VehicleTracker
 		
 		// Create purchase record
 		ref SST_VehiclePurchaseData purchase = new SST_VehiclePurchaseData();
-		purchase.timestamp = GetUTCTimestamp();
+		purchase.timestamp = SST_Clock.Now();
+		purchase.timestampUnix = SST_Clock.NowUnix();
 		purchase.vehicleClassName = vehicleEntity.GetType();
 		purchase.vehicleDisplayName = vehicleEntity.GetDisplayName();
 		purchase.ownerId = identity.GetPlainId();
@@ -190,8 +251,9 @@ class SST_VehicleTracker
 		purchase.traderZone = traderZone;
 		purchase.purchasePosition = vehicleEntity.GetPosition();
 		
-		m_Purchases.Insert(purchase);
-		SavePurchases();
+		array<ref SST_VehiclePurchaseData> purchases = new array<ref SST_VehiclePurchaseData>();
+		purchases.Insert(purchase);
+		JournalPurchases(purchases);
 		
 		// Track the vehicle
 		ref SST_TrackedVehicle tracked = new SST_TrackedVehicle();
@@ -202,7 +264,8 @@ class SST_VehicleTracker
 		tracked.ownerName = identity.GetName();
 		tracked.keyClassName = keyClassName;
 		tracked.lastPosition = vehicleEntity.GetPosition();
-		tracked.lastUpdateTime = GetUTCTimestamp();
+		tracked.lastUpdateTime = SST_Clock.Now();
+		tracked.lastSeenTime = tracked.lastUpdateTime;
 		tracked.isDestroyed = false;
 		tracked.keyData = keyData;
 		tracked.additionalKeys = new array<ref SST_VehicleKeyData>();
@@ -212,7 +275,7 @@ class SST_VehicleTracker
 		tracked.traderZone = traderZone;
 		
 		m_TrackedVehicles.Set(vehicleId, tracked);
-		SaveTrackedVehicles();
+		MarkChanged(vehicleId);
 		
 		Print("[SST] Vehicle purchased and tracked: " + vehicleEntity.GetType() + " by " + identity.GetName() + " (ID: " + vehicleId + ")");
 	}
@@ -226,43 +289,38 @@ class SST_VehicleTracker
 		if (m_TrackedVehicles.Count() == 0)
 			return;
 			
-		bool needsSave = false;
-		
-		// Use DayZPlayerUtils to get entities in a large box covering the map
-		// DayZ maps are typically around 15360m x 15360m
-		vector minPos = "-100 -100 -100";
-		vector maxPos = "15500 1000 15500";
-		
+		// Only the live vehicles (SST_VehicleRegistry), not every dynamic entity on the map
 		array<EntityAI> entities = new array<EntityAI>();
-		DayZPlayerUtils.SceneGetEntitiesInBox(minPos, maxPos, entities, QueryFlags.DYNAMIC);
+		SST_VehicleRegistry.GetInstance().GetVehicles(entities);
 		
 		foreach (EntityAI entity : entities)
 		{
-			if (!entity)
+			// Keyed Expansion vehicles only; refreshes the registry's key id as a side effect
+			string vehicleId = GetVehicleId(ExpansionVehicle.Get(entity));
+			if (vehicleId == "")
 				continue;
 			
-			// Check if this is a vehicle with expansion component
-			ExpansionVehicle vehicle = ExpansionVehicle.Get(entity);
-			if (!vehicle || !vehicle.HasKey())
+			SST_VehicleRegistry.GetInstance().SetKeyId(entity, vehicleId);
+			
+			SST_TrackedVehicle tracked = m_TrackedVehicles.Get(vehicleId);
+			if (!tracked)
 				continue;
 			
-			// Get the vehicle's key ID
-			int a, b, c, d;
-			vehicle.GetMasterKeyPersistentID(a, b, c, d);
-			string vehicleId = string.Format("%1-%2-%3-%4", a, b, c, d);
+			// Seen, but a parked vehicle is not put in the delta for that; lastSeenTime goes out with
+			// the next full snapshot, lastUpdateTime is the last recorded change
+			tracked.lastSeenTime = SST_Clock.Now();
+			m_SeenSinceSave = true;
 			
-			SST_TrackedVehicle tracked = m_TrackedVehicles.Get(vehicleId);
-			if (tracked)
-			{
-				tracked.lastPosition = entity.GetPosition();
-				tracked.lastUpdateTime = GetUTCTimestamp();
-				tracked.isDestroyed = entity.IsRuined();
-				needsSave = true;
-			}
+			vector position = entity.GetPosition();
+			bool destroyed = entity.IsRuined();
+			if (vector.Distance(position, tracked.lastPosition) < POSITION_THRESHOLD && destroyed == tracked.isDestroyed)
+				continue;
+			
+			tracked.lastPosition = position;
+			tracked.lastUpdateTime = tracked.lastSeenTime;
+			tracked.isDestroyed = destroyed;
+			MarkChanged(vehicleId);
 		}
-		
-		if (needsSave)
-			SaveTrackedVehicles();
 	}
 	
 	// Check for key generation requests from API
@@ -270,7 +328,54 @@ class SST_VehicleTracker
 	{
 		if (!GetGame().IsServer())
 			return;
-			
+		
+		ProcessSpooledKeyRequests();
+		ProcessLegacyKeyQueue();
+	}
+	
+	// SST_CommandExecutor: run one claimed key or delete file
+	override void ExecuteSpooled(SST_CommandSpool spool, string fileName)
+	{
+		if (spool == m_KeySpool)
+			ExecuteKeyFile(fileName);
+		else
+			ExecuteDeleteFile(fileName);
+	}
+	
+	// Claim spooled requests (current API); SST_CommandExecutor runs them within its tick budget
+	protected void ProcessSpooledKeyRequests()
+	{
+		SST_CommandExecutor.GetInstance().Pull(m_KeySpool, this);
+	}
+	
+	protected void ExecuteKeyFile(string fileName)
+	{
+		ref SST_KeyGenerationRequest request;
+		string errorMsg;
+		if (!JsonFileLoader<SST_KeyGenerationRequest>.LoadFile(m_KeySpool.GetProcessingPath(fileName), request, errorMsg) || !request)
+		{
+			request = new SST_KeyGenerationRequest();
+			request.status = "failed";
+			request.result = "Invalid request file";
+			Print("[SST] ERROR: Spool key request: unreadable request " + fileName + ": " + errorMsg);
+		}
+		else if (m_KeySpool.IsRecovered(fileName))
+		{
+			// Claimed before a restart: it may or may not have run, so don't run it again
+			request.status = "failed";
+			request.result = "Interrupted by a server restart";
+		}
+		else
+		{
+			ProcessSingleKeyRequest(request);
+		}
+		
+		m_KeySpool.Complete(fileName, SST_ResultJson<SST_KeyGenerationRequest>.Write(request));
+	}
+	
+	// key_grants.json from API versions before the spool: drained, then deleted
+	protected void ProcessLegacyKeyQueue()
+	{
 		if (!FileExist(KEY_QUEUE_FILE))
 			return;
 			
@@ -281,7 +386,10 @@ class SST_VehicleTracker
 			return;
 			
 		if (queue.requests.Count() == 0)
+		{
+			DeleteFile(KEY_QUEUE_FILE);
 			return;
+		}
 			
 		// Process each request
 		foreach (SST_KeyGenerationRequest request : queue.requests)
@@ -290,14 +398,11 @@ class SST_VehicleTracker
 				continue;
 				
 			ProcessSingleKeyRequest(request);
+			m_KeySpool.GetResults().Append(request.requestId, "", SST_ResultJson<SST_KeyGenerationRequest>.Write(request));
 		}
 		
-		// Save results and clear queue
-		SaveKeyResults(queue);
-		
-		// Clear the queue
-		ref SST_KeyGenerationQueue emptyQueue = new SST_KeyGenerationQueue();
-		JsonFileLoader<SST_KeyGenerationQueue>.SaveFile(KEY_QUEUE_FILE, emptyQueue, errorMsg);
+		// Remove the drained queue so idle polls only cost a FileExist
+		DeleteFile(KEY_QUEUE_FILE);
 	}
 	
 	protected void ProcessSingleKeyRequest(SST_KeyGenerationRequest request)
@@ -305,7 +410,7 @@ class SST_VehicleTracker
 		Print("[SST] Processing key request: " + request.requestId + " for vehicle " + request.vehicleId);
 		
 		// Find the target player
-		PlayerBase targetPlayer = FindPlayerById(request.playerId);
+		PlayerBase targetPlayer = SST_PlayerIndex.FindBySteamId(request.playerId);
 		if (!targetPlayer)
 		{
 			request.status = "failed";
@@ -374,139 +479,71 @@ class SST_VehicleTracker
 			ref SST_VehicleKeyData newKeyData = new SST_VehicleKeyData();
 			key.GetMasterKeyPersistentID(newKeyData.persistentIdA, newKeyData.persistentIdB, newKeyData.persistentIdC, newKeyData.persistentIdD);
 			tracked.additionalKeys.Insert(newKeyData);
-			SaveTrackedVehicles();
+			MarkChanged(request.vehicleId);
 		}
 		
 		Print("[SST] Key request SUCCESS: " + keyClass + " given to " + targetPlayer.GetIdentity().GetName());
 	}
 	
-	// Parse a vehicle ID string that may contain negative numbers
-	// Format: "A-B-C-D" where any value can be negative (e.g., "123-456-789--123" where last is -123)
-	protected bool ParseVehicleId(string vehicleId, out int a, out int b, out int c, out int d)
+	// Key id -> vehicle in O(1) (SST_VehicleRegistry). The API's vehicleId is the same
+	// "A-B-C-D" string GetVehicleId() builds, negative parts included, so it is compared as is.
+	protected ExpansionVehicle FindVehicleById(string vehicleId)
 	{
-		a = 0; b = 0; c = 0; d = 0;
-		
-		// Find positions of separators by tracking sign and digits
-		int len = vehicleId.Length();
-		int partIndex = 0;
-		string currentPart = "";
-		array<int> values = new array<int>();
+		ExpansionVehicle vehicle = GetIndexedVehicle(vehicleId);
+		if (vehicle)
+			return vehicle;
 		
-		for (int i = 0; i <= len; i++)
-		{
-			string ch = "";
-			if (i < len)
-				ch = vehicleId.Get(i);
-			
-			// Check if this is a separator (dash followed by digit or end of string)
-			bool isSeparator = false;
-			if (ch == "-" && i > 0)
-			{
-				// It's a separator if the previous char was a digit and next is also a digit
-				string prevCh = vehicleId.Get(i - 1);
-				string nextCh = "";
-				if (i + 1 < len)
-					nextCh = vehicleId.Get(i + 1);
-				
-				// Separator if previous is digit and (next is digit or next is minus for negative)
-				if (prevCh >= "0" && prevCh <= "9")
-				{
-					if ((nextCh >= "0" && nextCh <= "9") || nextCh == "-")
-						isSeparator = true;
-				}
-			}
-			
-			if (isSeparator || i == len)
-			{
-				if (currentPart != "")
-				{
-					values.Insert(currentPart.ToInt());
-					currentPart = "";
-				}
-			}
-			else
-			{
-				currentPart += ch;
-			}
-		}
+		// Paired without passing the hooks (another mod, older save): index every vehicle, at most once per REINDEX_INTERVAL
+		if (GetGame().GetTime() - m_LastReindexAt < REINDEX_INTERVAL)
+			return null;
 		
-		if (values.Count() != 4)
-			return false;
+		m_LastReindexAt = GetGame().GetTime();
+		array<EntityAI> entities = new array<EntityAI>();
+		SST_VehicleRegistry.GetInstance().GetVehicles(entities);
+		foreach (EntityAI entity : entities)
+			IndexVehicle(entity);
 		
-		a = values[0];
-		b = values[1];
-		c = values[2];
-		d = values[3];
-		return true;
+		return GetIndexedVehicle(vehicleId);
 	}
 	
-	protected PlayerBase FindPlayerById(string playerId)
+	// Registry entry for vehicleId, if its key id is still current
+	protected ExpansionVehicle GetIndexedVehicle(string vehicleId)
 	{
-		array<Man> players = new array<Man>();
-		GetGame().GetPlayers(players);
+		EntityAI entity = SST_VehicleRegistry.GetInstance().FindByKeyId(vehicleId);
+		if (!entity)
+			return null;
 		
-		foreach (Man man : players)
-		{
-			PlayerBase pb = PlayerBase.Cast(man);
-			if (pb && pb.GetIdentity() && pb.GetIdentity().GetPlainId() == playerId)
-				return pb;
-		}
+		ExpansionVehicle vehicle = ExpansionVehicle.Get(entity);
+		string currentId = GetVehicleId(vehicle);
+		if (currentId == vehicleId)
+			return vehicle;
 		
+		// Re-paired since it was indexed
+		SST_VehicleRegistry.GetInstance().SetKeyId(entity, currentId);
 		return null;
 	}
 	
-	protected ExpansionVehicle FindVehicleById(string vehicleId)
+	// "A-B-C-D" master key persistent id, "" if the vehicle has no key
+	static string GetVehicleId(ExpansionVehicle vehicle)
 	{
-		// Parse the vehicle ID - handles negative numbers
-		// Format: A-B-C-D where any value can be negative (e.g., "123-456-789--123" means D=-123)
-		int a, b, c, d;
-		if (!ParseVehicleId(vehicleId, a, b, c, d))
-			return null;
+		if (!vehicle || !vehicle.HasKey())
+			return "";
 		
-		// Use DayZPlayerUtils to get entities in a large box covering the map
-		vector minPos = "-100 -100 -100";
-		vector maxPos = "15500 1000 15500";
-		
-		array<EntityAI> entities = new array<EntityAI>();
-		DayZPlayerUtils.SceneGetEntitiesInBox(minPos, maxPos, entities, QueryFlags.DYNAMIC);
-		
-		foreach (EntityAI entity : entities)
-		{
-			if (!entity)
-				continue;
-			
-			ExpansionVehicle vehicle = ExpansionVehicle.Get(entity);
-			if (!vehicle || !vehicle.HasKey())
-				continue;
-			
-			int va, vb, vc, vd;
-			vehicle.GetMasterKeyPersistentID(va, vb, vc, vd);
-			
-			if (va == a && vb == b && vc == c && vd == d)
-				return vehicle;
-		}
-		
-		return null;
+		int a, b, c, d;
+		vehicle.GetMasterKeyPersistentID(a, b, c, d);
+		return string.Format("%1-%2-%3-%4", a, b, c, d);
 	}
 	
-	protected void SaveKeyResults(SST_KeyGenerationQueue queue)
+	// Record a vehicle's key id in SST_VehicleRegistry (after load, on pairing, on position updates)
+	static void IndexVehicle(EntityAI entity)
 	{
-		string errorMsg;
-		// Append results to results file
-		ref SST_KeyGenerationQueue existingResults = new SST_KeyGenerationQueue();
-		if (FileExist(KEY_RESULTS_FILE))
-			JsonFileLoader<SST_KeyGenerationQueue>.LoadFile(KEY_RESULTS_FILE, existingResults, errorMsg);
-		
-		foreach (SST_KeyGenerationRequest request : queue.requests)
-		{
-			existingResults.requests.Insert(request);
-		}
+		if (!entity)
+			return;
 		
-		// Keep only last 100 results
-		while (existingResults.requests.Count() > 100)
-			existingResults.requests.Remove(0);
-			
-		JsonFileLoader<SST_KeyGenerationQueue>.SaveFile(KEY_RESULTS_FILE, existingResults, errorMsg);
+		// CarScript or ExpansionVehicleBase; anything else has no ExpansionVehicle
+		string vehicleId = GetVehicleId(ExpansionVehicle.Get(entity));
+		if (vehicleId != "")
+			SST_VehicleRegistry.GetInstance().SetKeyId(entity, vehicleId);
 	}
 	
 	// ============================================================================
@@ -514,6 +551,44 @@ class SST_VehicleTracker
 	// ============================================================================
 	
 	void ProcessDeleteRequests()
+	{
+		ProcessSpooledDeleteRequests();
+		ProcessLegacyDeleteQueue();
+	}
+	
+	// Claim spooled requests (current API); SST_CommandExecutor runs them within its tick budget
+	protected void ProcessSpooledDeleteRequests()
+	{
+		SST_CommandExecutor.GetInstance().Pull(m_DeleteSpool, this);
+	}
+	
+	protected void ExecuteDeleteFile(string fileName)
+	{
+		ref SST_VehicleDeleteRequest request;
+		string errorMsg;
+		if (!JsonFileLoader<SST_VehicleDeleteRequest>.LoadFile(m_DeleteSpool.GetProcessingPath(fileName), request, errorMsg) || !request)
+		{
+			request = new SST_VehicleDeleteRequest();
+			request.status = "failed";
+			request.result = "Invalid request file";
+			Print("[SST] ERROR: Spool vehicle delete: unreadable request " + fileName + ": " + errorMsg);
+		}
+		else if (m_DeleteSpool.IsRecovered(fileName))
+		{
+			// Claimed before a restart: it may or may not have run, so don't run it again
+			request.status = "failed";
+			request.result = "Interrupted by a server restart";
+		}
+		else
+		{
+			ProcessSingleDeleteRequest(request);
+		}
+		
+		m_DeleteSpool.Complete(fileName, SST_ResultJson<SST_VehicleDeleteRequest>.Write(request));
+	}
+	
+	// vehicle_delete.json from API versions before the spool: drained, then deleted
+	protected void ProcessLegacyDeleteQueue()
 	{
 		if (!FileExist(DELETE_QUEUE_FILE))
 			return;
@@ -524,7 +599,10 @@ class SST_VehicleTracker
 			return;
 			
 		if (queue.requests.Count() == 0)
+		{
+			DeleteFile(DELETE_QUEUE_FILE);
 			return;
+		}
 			
 		// Process each request
 		foreach (SST_VehicleDeleteRequest request : queue.requests)
@@ -533,14 +611,11 @@ class SST_VehicleTracker
 				continue;
 				
 			ProcessSingleDeleteRequest(request);
+			m_DeleteSpool.GetResults().Append(request.requestId, "", SST_ResultJson<SST_VehicleDeleteRequest>.Write(request));
 		}
 		
-		// Save results and clear queue
-		SaveDeleteResults(queue);
-		
-		// Clear the queue
-		ref SST_VehicleDeleteQueue emptyQueue = new SST_VehicleDeleteQueue();
-		JsonFileLoader<SST_VehicleDeleteQueue>.SaveFile(DELETE_QUEUE_FILE, emptyQueue, errorMsg);
+		// Remove the drained queue so idle polls only cost a FileExist
+		DeleteFile(DELETE_QUEUE_FILE);
 	}
 	
 	protected void ProcessSingleDeleteRequest(SST_VehicleDeleteRequest request)
@@ -573,7 +648,7 @@ class SST_VehicleTracker
 		if (wasTracked)
 		{
 			m_TrackedVehicles.Remove(request.vehicleId);
-			SaveTrackedVehicles();
+			MarkRemoved(request.vehicleId);
 			Print("[SST] Removed from tracking: " + request.vehicleId);
 		}
 		
@@ -602,46 +677,303 @@ class SST_VehicleTracker
 		Print("[SST] Delete request " + request.status + ": " + request.result);
 	}
 	
-	protected void SaveDeleteResults(SST_VehicleDeleteQueue queue)
+	// Append purchases to the journal and fold them into the summary. A purchase costs one
+	// appended line and a rewrite of the small summary, whatever the size of the history.
+	// Returns true only if every purchase was written; only then are they counted in the summary.
+	protected bool JournalPurchases(array<ref SST_VehiclePurchaseData> purchases)
 	{
-		string errorMsg;
-		// Append results to results file
-		ref SST_VehicleDeleteQueue existingResults = new SST_VehicleDeleteQueue();
-		if (FileExist(DELETE_RESULTS_FILE))
-			JsonFileLoader<SST_VehicleDeleteQueue>.LoadFile(DELETE_RESULTS_FILE, existingResults, errorMsg);
+		SST_JsonWriter writer = m_PurchaseLog.BeginAppend();
+		if (!writer)
+		{
+			Print("[SST] ERROR: Failed to open vehicle purchase journal " + PURCHASES_FOLDER);
+			return false;
+		}
 		
-		foreach (SST_VehicleDeleteRequest request : queue.requests)
+		foreach (SST_VehiclePurchaseData purchase : purchases)
 		{
-			existingResults.requests.Insert(request);
+			WritePurchase(writer, purchase);
+			writer.NewLine();
 		}
 		
-		// Keep only last 100 results - Page pagination needs to be fixed on the web client before i change this
-		while (existingResults.requests.Count() > 100)
-			existingResults.requests.Remove(0);
-			
-		JsonFileLoader<SST_VehicleDeleteQueue>.SaveFile(DELETE_RESULTS_FILE, existingResults, errorMsg);
+		if (!m_PurchaseLog.EndAppend(writer, purchases.Count()))
+		{
+			Print("[SST] ERROR: Failed to append vehicle purchases to " + PURCHASES_FOLDER);
+			return false;
+		}
+		
+		foreach (SST_VehiclePurchaseData journaled : purchases)
+		{
+			AddToSummary(journaled);
+		}
+		SavePurchaseSummary();
+		return true;
+	}
+	
+	protected void AddToSummary(SST_VehiclePurchaseData purchase)
+	{
+		SST_VehiclePurchaseSummary summary = m_PurchaseSummary;
+		summary.totalPurchases++;
+		summary.totalSpent += purchase.purchasePrice;
+		if (summary.firstPurchaseUnix == 0 || purchase.timestampUnix < summary.firstPurchaseUnix)
+			summary.firstPurchaseUnix = purchase.timestampUnix;
+		if (purchase.timestampUnix >= summary.lastPurchaseUnix)
+		{
+			summary.lastPurchaseUnix = purchase.timestampUnix;
+			summary.lastPurchase = purchase;
+		}
+		
+		SST_VehiclePurchaseClassTotal classTotal;
+		foreach (SST_VehiclePurchaseClassTotal existing : summary.classes)
+		{
+			if (existing.vehicleClassName == purchase.vehicleClassName)
+			{
+				classTotal = existing;
+				break;
+			}
+		}
+		if (!classTotal)
+		{
+			classTotal = new SST_VehiclePurchaseClassTotal();
+			classTotal.vehicleClassName = purchase.vehicleClassName;
+			summary.classes.Insert(classTotal);
+		}
+		classTotal.count++;
+		classTotal.spent += purchase.purchasePrice;
 	}
 	
-	void SavePurchases()
+	protected void LoadPurchaseSummary()
 	{
+		m_PurchaseSummary = new SST_VehiclePurchaseSummary();
+		if (!FileExist(PURCHASES_SUMMARY_FILE))
+			return;
+		
 		string errorMsg;
-		// Create wrapper object
-		ref array<ref SST_VehiclePurchaseData> purchases = m_Purchases;
-		JsonFileLoader<array<ref SST_VehiclePurchaseData>>.SaveFile(PURCHASES_FILE, purchases, errorMsg);
+		if (!JsonFileLoader<SST_VehiclePurchaseSummary>.LoadFile(PURCHASES_SUMMARY_FILE, m_PurchaseSummary, errorMsg))
+		{
+			Print("[SST] WARNING: Could not read " + PURCHASES_SUMMARY_FILE + ", purchase totals restart from zero: " + errorMsg);
+			m_PurchaseSummary = new SST_VehiclePurchaseSummary();
+		}
 	}
 	
-	void SaveTrackedVehicles()
+	protected void SavePurchaseSummary()
 	{
+		m_PurchaseSummary.generatedAt = SST_Clock.Now();
+		
 		string errorMsg;
-		// Convert map to array for JSON
-		ref array<ref SST_TrackedVehicle> vehicles = new array<ref SST_TrackedVehicle>();
+		if (!JsonFileLoader<SST_VehiclePurchaseSummary>.SaveFile(PURCHASES_SUMMARY_FILE, m_PurchaseSummary, errorMsg))
+			Print("[SST] ERROR: Failed to save " + PURCHASES_SUMMARY_FILE + ": " + errorMsg);
+	}
+	
+	// purchases.json from before the journal: appended once, then renamed to purchases.json.migrated.
+	// Left in place, and retried on the next start, unless every record reached the journal.
+	protected void ImportLegacyPurchases()
+	{
+		if (!FileExist(PURCHASES_FILE))
+			return;
+		
+		string errorMsg;
+		array<ref SST_VehiclePurchaseData> purchases = new array<ref SST_VehiclePurchaseData>();
+		if (!JsonFileLoader<array<ref SST_VehiclePurchaseData>>.LoadFile(PURCHASES_FILE, purchases, errorMsg))
+		{
+			Print("[SST] WARNING: Could not import " + PURCHASES_FILE + ": " + errorMsg);
+			return;
+		}
+		
+		if (purchases.Count() > 0 && !JournalPurchases(purchases))
+		{
+			Print("[SST] ERROR: Could not import " + PURCHASES_FILE + " into the purchase journal, keeping it for the next start");
+			return;
+		}
+		
+		// Every record is in the journal now; the file must go either way or the next start imports it again
+		if (!CopyFile(PURCHASES_FILE, PURCHASES_FILE + MIGRATED_SUFFIX))
+			Print("[SST] WARNING: Could not keep " + PURCHASES_FILE + MIGRATED_SUFFIX + ", the imported records are only in the journal");
+		
+		DeleteFile(PURCHASES_FILE);
+		Print("[SST] Imported " + purchases.Count().ToString() + " vehicle purchases into the purchase journal (original kept as purchases.json" + MIGRATED_SUFFIX + ")");
+	}
+	
+	protected void MarkChanged(string vehicleId)
+	{
+		m_ChangedIds.Set(vehicleId, true);
+		m_RemovedIds.Remove(vehicleId);
+		m_DeltaPending = true;
+	}
+	
+	protected void MarkRemoved(string vehicleId)
+	{
+		m_ChangedIds.Remove(vehicleId);
+		m_RemovedIds.Set(vehicleId, true);
+		m_DeltaPending = true;
+	}
+	
+	// Changes since the last full snapshot that only exist in memory or in the delta
+	bool HasUnsavedChanges()
+	{
+		return m_ChangedIds.Count() > 0 || m_RemovedIds.Count() > 0;
+	}
+	
+	// Full snapshot now if anything changed or was seen since the last one (shutdown)
+	void Flush()
+	{
+		if (HasUnsavedChanges() || m_SeenSinceSave)
+			SaveTrackedVehicles();
+	}
+	
+	// Publish everything changed since the last full snapshot; the delta replaces the previous one
+	void PublishTrackedDelta()
+	{
+		SST_SnapshotPublisher publisher = SST_SnapshotPublisher.Get(SNAPSHOT_CHANNEL);
+		
+		// A delta needs a full snapshot to apply to
+		if (!publisher.HasSnapshot(TRACKED_SNAPSHOT))
+		{
+			SaveTrackedVehicles();
+			return;
+		}
 		
+		SST_JsonWriter writer = publisher.Begin(DELTA_SNAPSHOT);
+		if (!writer)
+			return;
+		
+		m_DeltaSequence++;
+		
+		writer.BeginObject();
+		writer.WriteInt("baseGeneration", publisher.GetGeneration(TRACKED_SNAPSHOT));
+		writer.WriteInt("sequence", m_DeltaSequence);
+		
+		writer.Key("changed");
+		writer.BeginArray();
+		for (int i = 0; i < m_ChangedIds.Count(); i++)
+			WriteTrackedVehicle(writer, m_TrackedVehicles.Get(m_ChangedIds.GetKey(i)));
+		writer.EndArray();
+		
+		writer.Key("removed");
+		writer.BeginArray();
+		for (int j = 0; j < m_RemovedIds.Count(); j++)
+			writer.StringValue(m_RemovedIds.GetKey(j));
+		writer.EndArray();
+		writer.EndObject();
+		
+		if (publisher.Publish(DELTA_SNAPSHOT, writer))
+			m_DeltaPending = false;
+		else
+			Print("[SST] ERROR: Failed to publish tracked vehicle delta");
+	}
+	
+	void SaveTrackedVehicles()
+	{
+		// Published as a snapshot generation and copied to TRACKED_FILE, which LoadTrackedVehicles reads on startup
+		SST_SnapshotPublisher publisher = SST_SnapshotPublisher.Get(SNAPSHOT_CHANNEL);
+		SST_JsonWriter writer = publisher.Begin(TRACKED_SNAPSHOT);
+		if (!writer)
+			return;
+		
+		// Map is written as a plain array, same as the file LoadTrackedVehicles reads
+		writer.BeginArray();
 		for (int i = 0; i < m_TrackedVehicles.Count(); i++)
 		{
-			vehicles.Insert(m_TrackedVehicles.GetElement(i));
+			WriteTrackedVehicle(writer, m_TrackedVehicles.GetElement(i));
+		}
+		writer.EndArray();
+		
+		if (!publisher.Publish(TRACKED_SNAPSHOT, writer, TRACKED_FILE))
+		{
+			Print("[SST] ERROR: Failed to save tracked vehicles to " + TRACKED_FILE);
+			return;
+		}
+		
+		// The old delta names the previous generation, so readers stop applying it
+		m_ChangedIds.Clear();
+		m_RemovedIds.Clear();
+		m_DeltaPending = false;
+		m_DeltaSequence = 0;
+		m_FullSaveTimer = 0;
+		m_SeenSinceSave = false;
+	}
+	
+	// SST_JsonWriter serializers; field order mirrors the DTO declarations at the top of this file
+	protected static void WriteKeyData(SST_JsonWriter writer, SST_VehicleKeyData keyData)
+	{
+		if (!keyData)
+		{
+			writer.NullValue();
+			return;
 		}
 		
-		JsonFileLoader<array<ref SST_TrackedVehicle>>.SaveFile(TRACKED_FILE, vehicles, errorMsg);
+		writer.BeginObject();
+		writer.WriteInt("persistentIdA", keyData.persistentIdA);
+		writer.WriteInt("persistentIdB", keyData.persistentIdB);
+		writer.WriteInt("persistentIdC", keyData.persistentIdC);
+		writer.WriteInt("persistentIdD", keyData.persistentIdD);
+		writer.EndObject();
+	}
+	
+	protected static void WritePurchase(SST_JsonWriter writer, SST_VehiclePurchaseData purchase)
+	{
+		if (!purchase)
+		{
+			writer.NullValue();
+			return;
+		}
+		
+		writer.BeginObject();
+		writer.WriteString("timestamp", purchase.timestamp);
+		writer.WriteInt("timestampUnix", purchase.timestampUnix);
+		writer.WriteString("vehicleClassName", purchase.vehicleClassName);
+		writer.WriteString("vehicleDisplayName", purchase.vehicleDisplayName);
+		writer.WriteString("ownerId", purchase.ownerId);
+		writer.WriteString("ownerName", purchase.ownerName);
+		writer.WriteString("keyClassName", purchase.keyClassName);
+		writer.Key("keyData");
+		WriteKeyData(writer, purchase.keyData);
+		writer.WriteInt("purchasePrice", purchase.purchasePrice);
+		writer.WriteString("traderName", purchase.traderName);
+		writer.WriteString("traderZone", purchase.traderZone);
+		writer.WriteVector("purchasePosition", purchase.purchasePosition);
+		writer.EndObject();
+	}
+	
+	protected static void WriteTrackedVehicle(SST_JsonWriter writer, SST_TrackedVehicle vehicle)
+	{
+		if (!vehicle)
+		{
+			writer.NullValue();
+			return;
+		}
+		
+		writer.BeginObject();
+		writer.WriteString("vehicleId", vehicle.vehicleId);
+		writer.WriteString("vehicleClassName", vehicle.vehicleClassName);
+		writer.WriteString("vehicleDisplayName", vehicle.vehicleDisplayName);
+		writer.WriteString("ownerId", vehicle.ownerId);
+		writer.WriteString("ownerName", vehicle.ownerName);
+		writer.WriteString("keyClassName", vehicle.keyClassName);
+		writer.WriteVector("lastPosition", vehicle.lastPosition);
+		writer.WriteString("lastUpdateTime", vehicle.lastUpdateTime);
+		writer.WriteString("lastSeenTime", vehicle.lastSeenTime);
+		writer.WriteBool("isDestroyed", vehicle.isDestroyed);
+		writer.Key("keyData");
+		WriteKeyData(writer, vehicle.keyData);
+		
+		writer.Key("additionalKeys");
+		if (vehicle.additionalKeys)
+		{
+			writer.BeginArray();
+			foreach (SST_VehicleKeyData extraKey : vehicle.additionalKeys)
+				WriteKeyData(writer, extraKey);
+			writer.EndArray();
+		}
+		else
+		{
+			writer.NullValue();
+		}
+		
+		writer.WriteString("purchaseTimestamp", vehicle.purchaseTimestamp);
+		writer.WriteInt("purchasePrice", vehicle.purchasePrice);
+		writer.WriteString("traderName", vehicle.traderName);
+		writer.WriteString("traderZone", vehicle.traderZone);
+		writer.EndObject();
 	}
 	
 	void LoadTrackedVehicles()
@@ -659,6 +991,45 @@ class SST_VehicleTracker
 			}
 			Print("[SST] Loaded " + vehicles.Count() + " tracked vehicles");
 		}
+		
+		LoadTrackedDelta();
+	}
+	
+	// Changes published after the last full snapshot (the server stopped before the next one)
+	protected void LoadTrackedDelta()
+	{
+		SST_SnapshotPublisher publisher = SST_SnapshotPublisher.Get(SNAPSHOT_CHANNEL);
+		string deltaPath = publisher.GetSnapshotPath(DELTA_SNAPSHOT);
+		if (deltaPath == "")
+			return;
+		
+		string errorMsg;
+		SST_TrackedVehicleDelta delta = new SST_TrackedVehicleDelta();
+		if (!JsonFileLoader<SST_TrackedVehicleDelta>.LoadFile(deltaPath, delta, errorMsg))
+		{
+			Print("[SST] WARNING: Could not read tracked vehicle delta: " + errorMsg);
+			return;
+		}
+		
+		if (delta.baseGeneration != publisher.GetGeneration(TRACKED_SNAPSHOT))
+			return;
+		
+		foreach (SST_TrackedVehicle vehicle : delta.changed)
+		{
+			m_TrackedVehicles.Set(vehicle.vehicleId, vehicle);
+			m_ChangedIds.Set(vehicle.vehicleId, true);
+		}
+		foreach (string vehicleId : delta.removed)
+		{
+			m_TrackedVehicles.Remove(vehicleId);
+			m_RemovedIds.Set(vehicleId, true);
+		}
+		m_DeltaSequence = delta.sequence;
+		
+		// They are folded into a full snapshot at the next interval
+		int applied = delta.changed.Count() + delta.removed.Count();
+		if (applied > 0)
+			Print("[SST] Applied " + applied.ToString() + " tracked vehicle changes from the last delta");
 	}
 	
 	// Called periodically to update tracking and process requests
@@ -681,7 +1052,16 @@ class SST_VehicleTracker
 			m_KeyCheckTimer = 0;
 			ProcessKeyRequests();
 			ProcessDeleteRequests();
+			
+			// Changes from this tick and the position update, coalesced into one delta
+			if (m_DeltaPending)
+				PublishTrackedDelta();
 		}
+		
+		// Also for parked vehicles that were only seen, so lastSeenTime is at most FULL_SAVE_INTERVAL old
+		m_FullSaveTimer += deltaTime;
+		if (m_FullSaveTimer >= FULL_SAVE_INTERVAL && (HasUnsavedChanges() || m_SeenSinceSave))
+			SaveTrackedVehicles();
 	}
 	
 	// Static helper to log purchase
@@ -10,9 +10,18 @@ class SST_InventoryExporter
 {
 	protected static ref SST_InventoryExporter s_Instance;
 	protected bool m_Initialized;
+	protected int m_LastFullRefresh;
+	
+	// Per-player export tasks of the current batch still waiting in SST_FrameScheduler
+	protected int m_PendingExports;
+	protected int m_BatchExported;
+	protected bool m_BatchFullRefresh;
 	
 	static const float EXPORT_INTERVAL = 10000.0; // 10 seconds in milliseconds
+	static const int FULL_REFRESH_INTERVAL = 120000; // Re-export everyone every 2 minutes, even if not dirty
 	static const string EXPORT_FOLDER = "$profile:SST/inventories/";
+	static const string SNAPSHOT_CHANNEL = "inventories";
+	static const int OFFLINE_SNAPSHOT_SECONDS = 86400; // Manifest entries of players offline this long are removed (the legacy file stays)
 	
 	static SST_InventoryExporter GetInstance()
 	{
@@ -40,32 +49,29 @@ class SST_InventoryExporter
 		if (!FileExist(EXPORT_FOLDER))
 			MakeDirectory(EXPORT_FOLDER);
 		
-		// Initial export after short delay
+		// Initial export after short delay (first pass is always a full refresh)
+		m_LastFullRefresh = -FULL_REFRESH_INTERVAL;
 		GetGame().GetCallQueue(CALL_CATEGORY_SYSTEM).CallLater(ExportAndScheduleNext, 5000, false);
-		Print("[SST] Inventory Export scheduled - initial delay 5s, then every 10s");
+		Print("[SST] Inventory Export scheduled - initial delay 5s, then every 10s (changed players only, full refresh every 120s)");
 	}
 	
 	void ExportAndScheduleNext()
 	{
-		ExportAllPlayerInventories();
+		// Previous batch still draining through the frame scheduler: don't pile up a second one
+		if (m_PendingExports <= 0)
+		{
+			int now = GetGame().GetTime();
+			bool fullRefresh = (now - m_LastFullRefresh) >= FULL_REFRESH_INTERVAL;
+			if (fullRefresh)
+				m_LastFullRefresh = now;
+			
+			EnqueuePlayerExports(fullRefresh);
+		}
+		
 		// Schedule next export
 		GetGame().GetCallQueue(CALL_CATEGORY_SYSTEM).CallLater(ExportAndScheduleNext, EXPORT_INTERVAL, false);
 	}
 	
-	static string GetUTCTimestamp()
-	{
-		int year, month, day, hour, minute, second;
-		GetYearMonthDayUTC(year, month, day);
-		GetHourMinuteSecondUTC(hour, minute, second);
-		return string.Format("%1-%2-%3T%4:%5:%6Z",
-			year.ToStringLen(4),
-			month.ToStringLen(2),
-			day.ToStringLen(2),
-			hour.ToStringLen(2),
-			minute.ToStringLen(2),
-			second.ToStringLen(2));
-	}
-	
 	// Get the slot name from slot ID
 	static string GetSlotName(int slotId)
 	{
@@ -111,7 +117,8 @@ class SST_InventoryExporter
 	}
 	
 	// Convert EntityAI to SST_InventoryItemData (recursive for attachments/cargo)
-	static ref SST_InventoryItemData ConvertItemToData(EntityAI item, int slotId = -1)
+	// When idIndex is given, every converted item is registered under its itemId
+	static ref SST_InventoryItemData ConvertItemToData(EntityAI item, int slotId = -1, map<string, EntityAI> idIndex = null)
 	{
 		if (!item)
 			return null;
@@ -119,6 +126,7 @@ class SST_InventoryExporter
 		ref SST_InventoryItemData itemData = new SST_InventoryItemData();
 		
 		// Basic item info
+		itemData.itemId = SST_InventoryItemIndex.GetItemId(item);
 		itemData.className = item.GetType();
 		itemData.displayName = item.GetDisplayName();
 		itemData.health = item.GetHealth("", "");
@@ -127,6 +135,9 @@ class SST_InventoryExporter
 		itemData.slot = slotId;
 		itemData.slotName = GetSlotName(slotId);
 		
+		if (idIndex)
+			idIndex.Set(itemData.itemId, item);
+		
 		// Process attachments
 		GameInventory inventory = item.GetInventory();
 		if (inventory)
@@ -137,14 +148,9 @@ class SST_InventoryExporter
 				EntityAI attachment = inventory.GetAttachmentFromIndex(i);
 				if (attachment)
 				{
-					// Get the slot this attachment is in
-					InventoryLocation loc = new InventoryLocation();
-					if (attachment.GetInventory().GetCurrentInventoryLocation(loc))
-					{
-						ref SST_InventoryItemData attachmentData = ConvertItemToData(attachment, loc.GetSlot());
-						if (attachmentData)
-							itemData.attachments.Insert(attachmentData);
-					}
+					ref SST_InventoryItemData attachmentData = ConvertItemToData(attachment, SST_InventoryTraversal.GetAttachmentSlotId(attachment), idIndex);
+					if (attachmentData)
+						itemData.attachments.Insert(attachmentData);
 				}
 			}
 			
@@ -158,7 +164,7 @@ class SST_InventoryExporter
 					EntityAI cargoItem = cargo.GetItem(j);
 					if (cargoItem)
 					{
-						ref SST_InventoryItemData cargoData = ConvertItemToData(cargoItem, -1);
+						ref SST_InventoryItemData cargoData = ConvertItemToData(cargoItem, -1, idIndex);
 						if (cargoData)
 							itemData.cargo.Insert(cargoData);
 					}
@@ -189,77 +195,16 @@ class SST_InventoryExporter
 		if (!playerInventory)
 			return playerData;
 		
-		// Get all items using EnumerateInventory
-		array<EntityAI> allItems = new array<EntityAI>();
-		playerInventory.EnumerateInventory(InventoryTraversalType.PREORDER, allItems);
-		
-		// We need to track what we've already processed to avoid duplicates
-		// EnumerateInventory returns items recursively, but we want top-level items only
-		// Then we'll recursively get their attachments/cargo in ConvertItemToData
-		
-		// Build an array of items that are children of other items
-		ref array<EntityAI> childItems = new array<EntityAI>();
+		// Walk the attachment/cargo tree once from the root; ConvertItemToData recurses below each top-level item
+		array<EntityAI> topLevelItems = new array<EntityAI>();
+		SST_InventoryTraversal.GetTopLevelItems(player, topLevelItems);
 		
-		foreach (EntityAI item : allItems)
-		{
-			if (!item)
-				continue;
-				
-			// Skip the player entity itself
-			if (item == player)
-				continue;
-				
-			GameInventory itemInv = item.GetInventory();
-			if (itemInv)
-			{
-				// Mark all attachments as children
-				int attCount = itemInv.AttachmentCount();
-				for (int a = 0; a < attCount; a++)
-				{
-					EntityAI att = itemInv.GetAttachmentFromIndex(a);
-					if (att)
-						childItems.Insert(att);
-				}
-				
-				// Mark all cargo items as children
-				CargoBase itemCargo = itemInv.GetCargo();
-				if (itemCargo)
-				{
-					int cargoCount = itemCargo.GetItemCount();
-					for (int c = 0; c < cargoCount; c++)
-					{
-						EntityAI cargoItem = itemCargo.GetItem(c);
-						if (cargoItem)
-							childItems.Insert(cargoItem);
-					}
-				}
-			}
-		}
+		// Rebuilt on every export so it matches the ids the dashboard sees
+		map<string, EntityAI> idIndex = SST_InventoryItemIndex.GetInstance().ResetPlayer(playerData.playerId);
 		
-		// Now process only top-level items (items not marked as children)
-		foreach (EntityAI topItem : allItems)
+		foreach (EntityAI topItem : topLevelItems)
 		{
-			if (!topItem)
-				continue;
-				
-			// Skip the player entity
-			if (topItem == player)
-				continue;
-				
-			// Skip items that are children of other items
-			if (childItems.Find(topItem) != -1)
-				continue;
-			
-			// Get the slot ID for this item
-			int slotId = -1;
-			InventoryLocation itemLoc = new InventoryLocation();
-			if (topItem.GetInventory() && topItem.GetInventory().GetCurrentInventoryLocation(itemLoc))
-			{
-				if (itemLoc.GetType() == InventoryLocationType.ATTACHMENT)
-					slotId = itemLoc.GetSlot();
-			}
-			
-			ref SST_InventoryItemData itemData = ConvertItemToData(topItem, slotId);
+			ref SST_InventoryItemData itemData = ConvertItemToData(topItem, SST_InventoryTraversal.GetAttachmentSlotId(topItem), idIndex);
 			if (itemData)
 				playerData.inventory.Insert(itemData);
 		}
@@ -267,7 +212,8 @@ class SST_InventoryExporter
 		return playerData;
 	}
 	
-	void ExportAllPlayerInventories()
+	// Queue one export task per changed player (or every player when fullRefresh is set)
+	protected void EnqueuePlayerExports(bool fullRefresh)
 	{
 		if (!GetGame() || !GetGame().IsServer())
 			return;
@@ -275,40 +221,128 @@ class SST_InventoryExporter
 		array<Man> players = new array<Man>();
 		GetGame().GetPlayers(players);
 		
-		int exportedCount = 0;
-		string timestamp = GetUTCTimestamp();
+		SST_InventoryDirtyTracker dirtyTracker = SST_InventoryDirtyTracker.GetInstance();
+		string timestamp = SST_Clock.Now();
+		
+		m_BatchExported = 0;
+		m_BatchFullRefresh = fullRefresh;
 		
 		foreach (Man man : players)
 		{
-			if (!man)
+			if (!man || !man.GetIdentity())
 				continue;
 			
-			ref SST_PlayerInventoryData playerInvData = ExportPlayerInventory(man);
-			if (playerInvData)
-			{
-				// Create individual file for each player using their Steam64 ID
-				string playerFilePath = EXPORT_FOLDER + playerInvData.playerId + ".json";
-				
-				// Wrap in export data structure with timestamp
-				ref SST_InventoryExportData exportData = new SST_InventoryExportData();
-				exportData.generatedAt = timestamp;
-				exportData.playerCount = 1;
-				exportData.players.Insert(playerInvData);
-				
-				string errorMsg;
-				if (JsonFileLoader<SST_InventoryExportData>.SaveFile(playerFilePath, exportData, errorMsg))
-				{
-					exportedCount++;
-				}
-				else
-				{
-					Print("[SST] ERROR: Failed to write inventory for " + playerInvData.playerName + ": " + errorMsg);
-				}
-			}
+			if (!fullRefresh && !dirtyTracker.IsDirty(man.GetIdentity().GetPlainId()))
+				continue;
+			
+			m_PendingExports++;
+			SST_FrameScheduler.Enqueue(new SST_InventoryExportTask(man, timestamp));
+		}
+		
+		// Nothing queued (e.g. an empty server): no task will finish the batch, so finish it here.
+		// Offline players' snapshots must still expire when nobody is online.
+		if (m_PendingExports == 0)
+			FinishBatch();
+	}
+	
+	// Without this the manifest keeps one entry per Steam64 ID ever seen
+	protected void RemoveOfflineSnapshots()
+	{
+		SST_SnapshotPublisher publisher = SST_SnapshotPublisher.Get(SNAPSHOT_CHANNEL);
+		array<string> stale = new array<string>();
+		publisher.GetNamesPublishedBefore(OFFLINE_SNAPSHOT_SECONDS, stale);
+		
+		// Online players with an unchanged inventory keep their old generation: only drop offline ones
+		foreach (string playerId : stale)
+		{
+			if (!SST_PlayerIndex.FindBySteamId(playerId))
+				publisher.Remove(playerId, false);
+		}
+	}
+	
+	// Run by SST_InventoryExportTask from the frame scheduler
+	void RunExportTask(Man player, string timestamp)
+	{
+		if (ExportPlayerToFile(player, timestamp))
+			m_BatchExported++;
+		
+		m_PendingExports--;
+		if (m_PendingExports > 0)
+			return;
+		
+		m_PendingExports = 0;
+		FinishBatch();
+	}
+	
+	// After the last export task of a batch, or right away if the batch was empty
+	protected void FinishBatch()
+	{
+		if (m_BatchFullRefresh)
+			RemoveOfflineSnapshots();
+		SST_SnapshotPublisher.Get(SNAPSHOT_CHANNEL).Commit();
+		
+		if (m_BatchExported > 0)
+		{
+			string exportKind = "changed";
+			if (m_BatchFullRefresh)
+				exportKind = "full refresh";
+			Print("[SST] Inventory Export complete (" + exportKind + ") - " + m_BatchExported.ToString() + " players");
+		}
+	}
+	
+	// Serialize and write a single player's inventory file; clears the dirty flag on success
+	protected bool ExportPlayerToFile(Man player, string timestamp)
+	{
+		// Player may have disconnected while the task was queued
+		if (!player || !player.GetIdentity())
+			return false;
+		
+		ref SST_PlayerInventoryData playerInvData = ExportPlayerInventory(player);
+		if (!playerInvData)
+			return false;
+		
+		// Create individual file for each player using their Steam64 ID
+		string playerFilePath = EXPORT_FOLDER + playerInvData.playerId + ".json";
+		
+		// Wrap in export data structure with timestamp
+		ref SST_InventoryExportData exportData = new SST_InventoryExportData();
+		exportData.generatedAt = timestamp;
+		exportData.playerCount = 1;
+		exportData.players.Insert(playerInvData);
+		
+		// Published as a new snapshot generation; the manifest is committed once per batch
+		SST_SnapshotPublisher publisher = SST_SnapshotPublisher.Get(SNAPSHOT_CHANNEL);
+		SST_JsonWriter writer = publisher.Begin(playerInvData.playerId);
+		if (!writer)
+			return false;
+		
+		SST_JsonExport.WriteInventoryExport(writer, exportData);
+		if (!publisher.Publish(playerInvData.playerId, writer, playerFilePath, false))
+		{
+			Print("[SST] ERROR: Failed to write inventory for " + playerInvData.playerName);
+			return false;
 		}
 		
-		if (exportedCount > 0)
-			Print("[SST] Inventory Export complete - " + exportedCount.ToString() + " players");
+		SST_InventoryDirtyTracker.GetInstance().ClearDirty(playerInvData.playerId);
+		return true;
+	}
+}
+
+// Frame scheduler task: export one player's inventory file
+class SST_InventoryExportTask : SST_SchedulerTask
+{
+	protected Man m_Player;
+	protected string m_Timestamp;
+	
+	void SST_InventoryExportTask(Man player, string timestamp)
+	{
+		m_Player = player;
+		m_Timestamp = timestamp;
+	}
+	
+	override void Run()
+	{
+		SST_InventoryExporter.GetInstance().RunExportTask(m_Player, m_Timestamp);
 	}
 }
 
@@ -319,6 +353,16 @@ class SST_ServerItemListExporter
 {
 	protected static ref SST_ServerItemListExporter s_Instance;
 	static const string ITEM_LIST_FILE = "$profile:SST/api/server_items.json";
+	static const string META_FILE = "$profile:SST/api/server_items_meta.json";
+	static const string SHARD_FOLDER = "$profile:SST/api/items/";
+	static const string SNAPSHOT_CHANNEL = "api";
+	static const string SHARD_CHANNEL = "items";
+	
+	// Bump when categorization or entry fields change so existing catalogs are rebuilt
+	static const int CATALOG_VERSION = 1;
+	
+	// CfgVehicles class -> "Class|Parent|GrandParent|..." shared across all classes of one export
+	protected ref map<string, string> m_ChainCache;
 	
 	static SST_ServerItemListExporter GetInstance()
 	{
@@ -332,20 +376,6 @@ class SST_ServerItemListExporter
 		GetInstance().ExportItemList();
 	}
 	
-	static string GetUTCTimestamp()
-	{
-		int year, month, day, hour, minute, second;
-		GetYearMonthDayUTC(year, month, day);
-		GetHourMinuteSecondUTC(hour, minute, second);
-		return string.Format("%1-%2-%3T%4:%5:%6Z",
-			year.ToStringLen(4),
-			month.ToStringLen(2),
-			day.ToStringLen(2),
-			hour.ToStringLen(2),
-			minute.ToStringLen(2),
-			second.ToStringLen(2));
-	}
-	
 	// Determine item category based on parent classes
 	protected string GetItemCategory(string className)
 	{
@@ -391,15 +421,30 @@ class SST_ServerItemListExporter
 		return "Other";
 	}
 	
-	// Get the full inheritance chain as a searchable string
+	// Get the full inheritance chain as a searchable string.
+	// Memoized: siblings share their parents' chains, so each config class is looked up once per export.
 	protected string GetInheritanceChain(string className)
 	{
-		string chain = className;
+		if (!m_ChainCache)
+			m_ChainCache = new map<string, string>();
+		
+		string chain;
+		if (m_ChainCache.Find(className, chain))
+			return chain;
+		
+		// Walk up until we reach the root or an ancestor whose chain is already known
+		array<string> uncached = new array<string>();
 		string currentClass = className;
+		string knownTail = "";
 		int maxIterations = 30;
 		
 		while (maxIterations > 0)
 		{
+			if (m_ChainCache.Find(currentClass, knownTail))
+				break;
+			
+			uncached.Insert(currentClass);
+			
 			string parentPath = "CfgVehicles " + currentClass;
 			if (!GetGame().ConfigIsExisting(parentPath))
 				break;
@@ -410,14 +455,75 @@ class SST_ServerItemListExporter
 			if (parentClass == "" || parentClass == currentClass)
 				break;
 			
-			chain = chain + "|" + parentClass;
 			currentClass = parentClass;
 			maxIterations--;
 		}
 		
+		// Build the chains top-down so every class we passed is cached too
+		chain = knownTail;
+		for (int i = uncached.Count() - 1; i >= 0; i--)
+		{
+			if (chain == "")
+				chain = uncached[i];
+			else
+				chain = uncached[i] + "|" + chain;
+			
+			m_ChainCache.Set(uncached[i], chain);
+		}
+		
 		return chain;
 	}
 	
+	// Signature of the loaded mod set: changes whenever a mod is added/removed or updated (its CfgMods
+	// version/hash fields), or the config class counts change. An update that only edits existing
+	// classes keeps every count, so the per-mod fields are what catch it.
+	protected string ComputeModSignature()
+	{
+		TStringArray fields = {"version", "hash"};
+		int modCount = GetGame().ConfigGetChildrenCount("CfgMods");
+		string modNames = "";
+		for (int i = 0; i < modCount; i++)
+		{
+			string modName;
+			GetGame().ConfigGetChildName("CfgMods", i, modName);
+			modNames += modName;
+			
+			foreach (string field : fields)
+			{
+				string path = "CfgMods " + modName + " " + field;
+				string value = "";
+				if (GetGame().ConfigIsExisting(path))
+					GetGame().ConfigGetText(path, value);
+				modNames += "|" + value;
+			}
+			modNames += ";";
+		}
+		
+		int vehicleCount = GetGame().ConfigGetChildrenCount("CfgVehicles");
+		int weaponCount = GetGame().ConfigGetChildrenCount("CfgWeapons");
+		int magazineCount = GetGame().ConfigGetChildrenCount("CfgMagazines");
+		
+		return string.Format("v%1-%2-%3-%4-%5-%6", CATALOG_VERSION, modCount, vehicleCount, weaponCount, magazineCount, modNames.Hash());
+	}
+	
+	// True if the catalog from a previous start was built for the same mod set and is still on disk
+	protected bool IsCatalogCurrent(string signature)
+	{
+		if (!FileExist(META_FILE) || !SST_SnapshotPublisher.Get(SNAPSHOT_CHANNEL).HasSnapshot("server_items"))
+			return false;
+		
+		// Catalogs from before sharding need one rebuild to produce the shards
+		if (!SST_SnapshotPublisher.Get(SHARD_CHANNEL).HasSnapshot("index"))
+			return false;
+		
+		ref SST_ServerItemCatalogMeta meta = new SST_ServerItemCatalogMeta();
+		string errorMsg;
+		if (!JsonFileLoader<SST_ServerItemCatalogMeta>.LoadFile(META_FILE, meta, errorMsg))
+			return false;
+		
+		return meta.signature == signature;
+	}
+	
 	// Helper to add items from a config path to the item list
 	protected void AddItemsFromConfig(string configPath, ref SST_ServerItemList itemList)
 	{
@@ -501,6 +607,74 @@ class SST_ServerItemListExporter
 		}
 	}
 	
+	// Shard name for a category: "Weapons" -> "weapons"
+	static string GetShardName(string category)
+	{
+		string shard = category;
+		shard.ToLower();
+		shard.Replace(" ", "_");
+		return shard;
+	}
+	
+	// Publish one file per category plus api/items/index.json listing them
+	protected bool ExportShards(SST_ServerItemList itemList)
+	{
+		if (!FileExist(SHARD_FOLDER))
+			MakeDirectory(SHARD_FOLDER);
+		
+		map<string, ref SST_ServerItemShard> shards = new map<string, ref SST_ServerItemShard>();
+		foreach (SST_ServerItemEntry entry : itemList.items)
+		{
+			SST_ServerItemShard shard = shards.Get(entry.category);
+			if (!shard)
+			{
+				shard = new SST_ServerItemShard();
+				shard.generatedAt = itemList.generatedAt;
+				shard.category = entry.category;
+				shards.Set(entry.category, shard);
+			}
+			shard.items.Insert(entry);
+		}
+		
+		SST_SnapshotPublisher publisher = SST_SnapshotPublisher.Get(SHARD_CHANNEL);
+		ref SST_ServerItemIndex index = new SST_ServerItemIndex();
+		index.generatedAt = itemList.generatedAt;
+		index.itemCount = itemList.itemCount;
+		
+		for (int i = 0; i < shards.Count(); i++)
+		{
+			SST_ServerItemShard categoryShard = shards.GetElement(i);
+			categoryShard.itemCount = categoryShard.items.Count();
+			
+			string shardName = GetShardName(categoryShard.category);
+			SST_JsonWriter shardWriter = publisher.Begin(shardName);
+			if (!shardWriter)
+				return false;
+			
+			SST_JsonExport.WriteServerItemShard(shardWriter, categoryShard);
+			if (!publisher.Publish(shardName, shardWriter, SHARD_FOLDER + shardName + ".json", false))
+				return false;
+			
+			ref SST_ServerItemIndexEntry indexEntry = new SST_ServerItemIndexEntry();
+			indexEntry.category = categoryShard.category;
+			indexEntry.shard = shardName;
+			indexEntry.itemCount = categoryShard.itemCount;
+			indexEntry.hash = shardWriter.GetContentHash();
+			index.categories.Insert(indexEntry);
+		}
+		
+		// Index last, so it never lists a shard that isn't published yet
+		SST_JsonWriter indexWriter = publisher.Begin("index");
+		if (!indexWriter)
+			return false;
+		
+		SST_JsonExport.WriteServerItemIndex(indexWriter, index);
+		if (!publisher.Publish("index", indexWriter, SHARD_FOLDER + "index.json", false))
+			return false;
+		
+		return publisher.Commit();
+	}
+	
 	protected void ExportItemList()
 	{
 		if (!GetGame() || !GetGame().IsServer())
@@ -514,8 +688,17 @@ class SST_ServerItemListExporter
 		if (!FileExist("$profile:SST/api"))
 			MakeDirectory("$profile:SST/api");
 		
+		// Same mods as last time: the published catalog is still valid
+		string signature = ComputeModSignature();
+		if (IsCatalogCurrent(signature))
+		{
+			Print("[SST] Server item list unchanged (mod signature " + signature + ") - reusing previous export");
+			return;
+		}
+		
 		ref SST_ServerItemList itemList = new SST_ServerItemList();
-		itemList.generatedAt = GetUTCTimestamp();
+		itemList.generatedAt = SST_Clock.Now();
+		m_ChainCache = new map<string, string>();
 		
 		// Add items from CfgVehicles (most items, clothing, containers, etc.)
 		AddItemsFromConfig("CfgVehicles", itemList);
@@ -528,16 +711,30 @@ class SST_ServerItemListExporter
 		
 		itemList.itemCount = itemList.items.Count();
 		
-		// Save to file
-		string errorMsg;
-		if (JsonFileLoader<SST_ServerItemList>.SaveFile(ITEM_LIST_FILE, itemList, errorMsg))
+		// Publish as a snapshot generation (copied to ITEM_LIST_FILE for older readers)
+		SST_SnapshotPublisher publisher = SST_SnapshotPublisher.Get(SNAPSHOT_CHANNEL);
+		SST_JsonWriter writer = publisher.Begin("server_items");
+		if (writer)
+			SST_JsonExport.WriteServerItemList(writer, itemList);
+		
+		if (writer && publisher.Publish("server_items", writer, ITEM_LIST_FILE) && ExportShards(itemList))
 		{
 			Print("[SST] Server item list exported: " + itemList.itemCount.ToString() + " items to " + ITEM_LIST_FILE);
+			
+			ref SST_ServerItemCatalogMeta meta = new SST_ServerItemCatalogMeta();
+			meta.signature = signature;
+			meta.itemCount = itemList.itemCount;
+			meta.generatedAt = itemList.generatedAt;
+			string errorMsg;
+			JsonFileLoader<SST_ServerItemCatalogMeta>.SaveFile(META_FILE, meta, errorMsg);
 		}
 		else
 		{
-			Print("[SST] ERROR: Failed to save server item list: " + errorMsg);
+			Print("[SST] ERROR: Failed to save server item list to " + ITEM_LIST_FILE);
 		}
+		
+		// Only needed while building the catalog
+		m_ChainCache = null;
 	}
 }
 
@@ -570,6 +767,11 @@ modded class MissionServer
 			Print("[SST] MissionServer.OnInit - Starting Player Commands API");
 			SST_PlayerCommands.Start();
 			
+			// Create the event loggers now so they are registered for log preloading
+			SST_InventoryEventLogger.GetInstance();
+			SST_PlayerLifeEventLogger.GetInstance();
+			SST_TradeLogger.GetInstance();
+			
 			#ifdef EXPANSIONMODVEHICLE
 			// Start vehicle tracker
 			Print("[SST] MissionServer.OnInit - Starting Vehicle Tracker");
@@ -582,6 +784,15 @@ modded class MissionServer
 	{
 		super.OnUpdate(timeslice);
 		
+		if (GetGame().IsServer())
+		{
+			// Drain a frame's worth of queued per-player export work
+			SST_FrameScheduler.GetInstance().OnUpdate(timeslice);
+			
+			// Execute a frame's worth of claimed API commands
+			SST_CommandExecutor.GetInstance().OnUpdate(timeslice);
+		}
+		
 		#ifdef EXPANSIONMODVEHICLE
 		if (GetGame().IsServer())
 		{
@@ -590,6 +801,25 @@ modded class MissionServer
 		#endif
 	}
 	
+	override void OnMissionFinish()
+	{
+		// Nothing buffered may be lost on a clean shutdown
+		if (GetGame().IsServer())
+		{
+			// Claimed commands that never ran go back to the spool instead of being reported as interrupted
+			SST_CommandExecutor.GetInstance().ReleaseBacklog();
+			
+			SST_InventoryEventFilter.GetInstance().FlushAll();
+			SST_LogSink.GetInstance().FlushAll();
+			
+			#ifdef EXPANSIONMODVEHICLE
+			SST_VehicleTracker.GetInstance().Flush();
+			#endif
+		}
+		
+		super.OnMissionFinish();
+	}
+	
 	// Called when player connects/reconnects to server
 	override void InvokeOnConnect(PlayerBase player, PlayerIdentity identity)
 	{
@@ -597,8 +827,18 @@ modded class MissionServer
 		
 		if (GetGame().IsServer() && player)
 		{
+			// Also called after a respawn: point the index at the new entity
+			SST_PlayerIndex.GetInstance().Add(player);
+			
+			// Read the player's event logs over the next frames, not in the first event hook
+			if (identity)
+				SST_LogResidency.GetInstance().PlayerConnected(identity.GetPlainId());
+			
 			SST_PlayerLifeEventLogger.LogConnect(player);
 			SST_OnlinePlayerTracker.GetInstance().PlayerConnected(player);
+			
+			// Make sure a fresh inventory file is written on the next export tick
+			SST_InventoryDirtyTracker.MarkPlayer(player);
 		}
 	}
 	
@@ -610,6 +850,18 @@ modded class MissionServer
 		{
 			SST_PlayerLifeEventLogger.LogDisconnect(player);
 			SST_OnlinePlayerTracker.GetInstance().PlayerDisconnected(player);
+			
+			if (player.GetIdentity())
+			{
+				// Write the player's buffered event logs (including the disconnect event above)
+				SST_InventoryEventFilter.GetInstance().FlushPlayer(player.GetIdentity().GetPlainId());
+				SST_LogSink.GetInstance().FlushKey(player.GetIdentity().GetPlainId());
+				SST_LogResidency.GetInstance().PlayerDisconnected(player.GetIdentity().GetPlainId());
+				SST_InventoryDirtyTracker.GetInstance().ClearDirty(player.GetIdentity().GetPlainId());
+				SST_InventoryItemIndex.GetInstance().RemovePlayer(player.GetIdentity().GetPlainId());
+			}
+			
+			SST_PlayerIndex.GetInstance().Remove(player);
 		}
 		
 		super.InvokeOnDisconnect(player);
@@ -619,14 +871,53 @@ modded class MissionServer
 // ============================================================================
 // Online Player Tracker - Tracks online players and their locations
 // ============================================================================
+// Per-player sampling schedule of SST_OnlinePlayerTracker (GetGame().GetTime() milliseconds)
+class SST_PlayerSampleState
+{
+	int nextSampleAt;          // Player is not sampled again before this
+	int lastChangeAt;          // Last sample that was written to the roster
+}
+
 class SST_OnlinePlayerTracker
 {
 	protected static ref SST_OnlinePlayerTracker s_Instance;
 	protected bool m_Initialized;
+	
+	// Hot roster: only players currently online, exported when a sample changed it
 	protected ref map<string, ref SST_OnlinePlayerData> m_OnlinePlayers;
 	
-	static const float UPDATE_INTERVAL = 5000.0; // 5 seconds
+	// Steam64 -> sampling schedule, online players only
+	protected ref map<string, ref SST_PlayerSampleState> m_SampleStates;
+	
+	// Roster changed since the last online_players export
+	protected bool m_RosterDirty;
+	protected int m_LastExportAt;
+	
+	// Disconnected players (last known state), bounded and written rarely
+	protected ref map<string, ref SST_OnlinePlayerData> m_Registry;
+	protected ref array<string> m_RegistryOrder; // Steam64 IDs, oldest disconnect first
+	protected bool m_RegistryDirty;
+	
+	// True while per-player update tasks of the current pass are still queued
+	protected bool m_UpdatePending;
+	
+	static const float TICK_INTERVAL = 1000.0; // Scheduling loop; only players that are due get sampled
+	static const int UPDATE_INTERVAL = 5000; // Sample interval on foot
+	static const int FAST_UPDATE_INTERVAL = 2000; // Sample interval in a vehicle or above FAST_MOVER_SPEED
+	static const float FAST_MOVER_SPEED = 8.0; // m/s
+	static const int HEARTBEAT_INTERVAL = 60000; // Write a player (and the export) at least this often, even when idle
+	
+	// A sample only updates the roster when something moved past these thresholds
+	static const float MIN_MOVE_DISTANCE = 2.0; // metres
+	static const float MIN_HEALTH_DELTA = 1.0; // health points (0-100)
+	static const float MIN_BLOOD_DELTA = 50.0; // blood (0-5000)
+	static const float MIN_STAT_DELTA = 2.0; // water/energy percent
+	
+	static const float REGISTRY_WRITE_INTERVAL = 60000.0; // 1 minute, only if something changed
+	static const int REGISTRY_MAX_PLAYERS = 500; // Oldest disconnects are evicted beyond this
 	static const string ONLINE_PLAYERS_FILE = "$profile:SST/api/online_players.json";
+	static const string REGISTRY_FILE = "$profile:SST/api/player_registry.json";
+	static const string SNAPSHOT_CHANNEL = "api";
 	
 	static SST_OnlinePlayerTracker GetInstance()
 	{
@@ -647,6 +938,9 @@ class SST_OnlinePlayerTracker
 			
 		m_Initialized = true;
 		m_OnlinePlayers = new map<string, ref SST_OnlinePlayerData>();
+		m_SampleStates = new map<string, ref SST_PlayerSampleState>();
+		m_Registry = new map<string, ref SST_OnlinePlayerData>();
+		m_RegistryOrder = new array<string>();
 		
 		Print("[SST] OnlinePlayerTracker initializing...");
 		
@@ -656,30 +950,29 @@ class SST_OnlinePlayerTracker
 		if (!FileExist("$profile:SST/api"))
 			MakeDirectory("$profile:SST/api");
 		
+		LoadRegistry();
+		
 		// Start update loop
 		GetGame().GetCallQueue(CALL_CATEGORY_SYSTEM).CallLater(UpdateAndScheduleNext, 2000, false);
-		Print("[SST] Online Player Tracker started - updating every 5 seconds");
+		GetGame().GetCallQueue(CALL_CATEGORY_SYSTEM).CallLater(SaveRegistryAndScheduleNext, REGISTRY_WRITE_INTERVAL, false);
+		Print("[SST] Online Player Tracker started - sampling every " + (UPDATE_INTERVAL / 1000).ToString() + "s (" + (FAST_UPDATE_INTERVAL / 1000).ToString() + "s in vehicles)");
 	}
 	
-	void UpdateAndScheduleNext()
+	void SaveRegistryAndScheduleNext()
 	{
-		UpdateAllPlayerData();
-		ExportOnlinePlayers();
-		GetGame().GetCallQueue(CALL_CATEGORY_SYSTEM).CallLater(UpdateAndScheduleNext, UPDATE_INTERVAL, false);
+		if (m_RegistryDirty)
+			SaveRegistry();
+		
+		GetGame().GetCallQueue(CALL_CATEGORY_SYSTEM).CallLater(SaveRegistryAndScheduleNext, REGISTRY_WRITE_INTERVAL, false);
 	}
 	
-	static string GetUTCTimestamp()
+	void UpdateAndScheduleNext()
 	{
-		int year, month, day, hour, minute, second;
-		GetYearMonthDayUTC(year, month, day);
-		GetHourMinuteSecondUTC(hour, minute, second);
-		return string.Format("%1-%2-%3T%4:%5:%6Z",
-			year.ToStringLen(4),
-			month.ToStringLen(2),
-			day.ToStringLen(2),
-			hour.ToStringLen(2),
-			minute.ToStringLen(2),
-			second.ToStringLen(2));
+		// Skip this pass if the previous one hasn't finished draining
+		if (!m_UpdatePending)
+			EnqueuePlayerUpdates();
+		
+		GetGame().GetCallQueue(CALL_CATEGORY_SYSTEM).CallLater(UpdateAndScheduleNext, TICK_INTERVAL, false);
 	}
 	
 	void PlayerConnected(PlayerBase player)
@@ -692,7 +985,7 @@ class SST_OnlinePlayerTracker
 			return;
 		
 		string playerId = identity.GetPlainId();
-		string timestamp = GetUTCTimestamp();
+		string timestamp = SST_Clock.Now();
 		
 		ref SST_OnlinePlayerData playerData;
 		
@@ -703,8 +996,13 @@ class SST_OnlinePlayerTracker
 		}
 		else
 		{
-			playerData = new SST_OnlinePlayerData();
-			playerData.playerId = playerId;
+			// Back from the registry, or first time seen
+			playerData = RemoveFromRegistry(playerId);
+			if (!playerData)
+			{
+				playerData = new SST_OnlinePlayerData();
+				playerData.playerId = playerId;
+			}
 			m_OnlinePlayers.Insert(playerId, playerData);
 		}
 		
@@ -715,7 +1013,9 @@ class SST_OnlinePlayerTracker
 		playerData.lastUpdate = timestamp;
 		
 		// Initial position and status update
-		UpdatePlayerData(player, playerData);
+		UpdatePlayerData(player, playerData, true);
+		ScheduleNextSample(player, playerId, true);
+		m_RosterDirty = true;
 		
 		Print("[SST] Player connected: " + playerData.playerName + " (" + playerId + ")");
 	}
@@ -735,28 +1035,69 @@ class SST_OnlinePlayerTracker
 		{
 			ref SST_OnlinePlayerData playerData = m_OnlinePlayers.Get(playerId);
 			playerData.isOnline = false;
-			playerData.lastUpdate = GetUTCTimestamp();
+			playerData.lastUpdate = SST_Clock.Now();
+			
+			// Move from the hot roster to the registry
+			m_OnlinePlayers.Remove(playerId);
+			m_SampleStates.Remove(playerId);
+			AddToRegistry(playerData);
+			m_RosterDirty = true;
 			
 			Print("[SST] Player disconnected: " + playerData.playerName + " (" + playerId + ")");
 		}
 	}
 	
-	protected void UpdatePlayerData(PlayerBase player, SST_OnlinePlayerData playerData)
+	protected void AddToRegistry(SST_OnlinePlayerData playerData)
+	{
+		string playerId = playerData.playerId;
+		
+		int existing = m_RegistryOrder.Find(playerId);
+		if (existing != -1)
+			m_RegistryOrder.Remove(existing);
+		
+		m_Registry.Set(playerId, playerData);
+		m_RegistryOrder.Insert(playerId);
+		
+		while (m_RegistryOrder.Count() > REGISTRY_MAX_PLAYERS)
+		{
+			m_Registry.Remove(m_RegistryOrder[0]);
+			m_RegistryOrder.RemoveOrdered(0);
+		}
+		
+		m_RegistryDirty = true;
+	}
+	
+	protected SST_OnlinePlayerData RemoveFromRegistry(string playerId)
+	{
+		ref SST_OnlinePlayerData playerData = m_Registry.Get(playerId);
+		if (!playerData)
+			return null;
+		
+		m_Registry.Remove(playerId);
+		int index = m_RegistryOrder.Find(playerId);
+		if (index != -1)
+			m_RegistryOrder.RemoveOrdered(index);
+		
+		m_RegistryDirty = true;
+		return playerData;
+	}
+	
+	// Sample the player; the roster entry is only rewritten if the player moved or their
+	// vitals changed past the MIN_* thresholds (or force is set). Returns true if it was.
+	protected bool UpdatePlayerData(PlayerBase player, SST_OnlinePlayerData playerData, bool force = false)
 	{
 		if (!player || !playerData)
-			return;
+			return false;
 		
 		// Get position
 		vector pos = player.GetPosition();
-		playerData.posX = pos[0];
-		playerData.posY = pos[1];
-		playerData.posZ = pos[2];
 		
 		// Get health and status
-		playerData.health = player.GetHealth("GlobalHealth", "Health");
-		playerData.blood = player.GetHealth("GlobalHealth", "Blood");
-		playerData.isAlive = player.IsAlive();
-		playerData.isUnconscious = player.IsUnconscious();
+		float health = player.GetHealth("GlobalHealth", "Health");
+		float blood = player.GetHealth("GlobalHealth", "Blood");
+		bool isAlive = player.IsAlive();
+		bool isUnconscious = player.IsUnconscious();
+		bool inVehicle = player.IsInVehicle();
 		
 		// Get water and energy levels using modifiers
 		float waterVal = 0;
@@ -768,82 +1109,255 @@ class SST_OnlinePlayerTracker
 			energyVal = player.GetStatEnergy().Get();
 		
 		// Convert to percentage (max water = 5000, max energy = 20000)
-		playerData.water = (waterVal / 5000.0) * 100.0;
-		playerData.energy = (energyVal / 20000.0) * 100.0;
+		float water = (waterVal / 5000.0) * 100.0;
+		float energy = (energyVal / 20000.0) * 100.0;
+		
+		if (!force)
+		{
+			vector lastPos = Vector(playerData.posX, playerData.posY, playerData.posZ);
+			bool changed = vector.Distance(pos, lastPos) >= MIN_MOVE_DISTANCE;
+			changed = changed || isAlive != playerData.isAlive || isUnconscious != playerData.isUnconscious || inVehicle != playerData.inVehicle;
+			changed = changed || Math.AbsFloat(health - playerData.health) >= MIN_HEALTH_DELTA;
+			changed = changed || Math.AbsFloat(blood - playerData.blood) >= MIN_BLOOD_DELTA;
+			changed = changed || Math.AbsFloat(water - playerData.water) >= MIN_STAT_DELTA;
+			changed = changed || Math.AbsFloat(energy - playerData.energy) >= MIN_STAT_DELTA;
+			if (!changed)
+				return false;
+		}
 		
-		playerData.lastUpdate = GetUTCTimestamp();
+		playerData.posX = pos[0];
+		playerData.posY = pos[1];
+		playerData.posZ = pos[2];
+		playerData.health = health;
+		playerData.blood = blood;
+		playerData.water = water;
+		playerData.energy = energy;
+		playerData.isAlive = isAlive;
+		playerData.isUnconscious = isUnconscious;
+		playerData.inVehicle = inVehicle;
+		
+		playerData.lastUpdate = SST_Clock.Now();
+		return true;
+	}
+	
+	// Vehicles and other fast movers are sampled every FAST_UPDATE_INTERVAL
+	protected bool IsFastMover(PlayerBase player)
+	{
+		if (player.IsInVehicle())
+			return true;
+		
+		return GetVelocity(player).Length() >= FAST_MOVER_SPEED;
+	}
+	
+	protected void ScheduleNextSample(PlayerBase player, string playerId, bool changed)
+	{
+		int now = GetGame().GetTime();
+		
+		SST_PlayerSampleState state = m_SampleStates.Get(playerId);
+		if (!state)
+		{
+			state = new SST_PlayerSampleState();
+			m_SampleStates.Set(playerId, state);
+		}
+		
+		if (changed)
+			state.lastChangeAt = now;
+		
+		if (IsFastMover(player))
+			state.nextSampleAt = now + FAST_UPDATE_INTERVAL;
+		else
+			state.nextSampleAt = now + UPDATE_INTERVAL;
 	}
 	
-	protected void UpdateAllPlayerData()
+	// Queue one status update task per player that is due for a sample, followed by a single export task
+	protected void EnqueuePlayerUpdates()
 	{
 		if (!GetGame() || !GetGame().IsServer())
 			return;
 		
+		int now = GetGame().GetTime();
+		bool exportDue = m_RosterDirty || now - m_LastExportAt >= HEARTBEAT_INTERVAL;
+		
 		array<Man> players = new array<Man>();
 		GetGame().GetPlayers(players);
 		
-		// Update existing online players
 		foreach (Man man : players)
 		{
 			PlayerBase player = PlayerBase.Cast(man);
-			if (!player)
+			if (!player || !player.GetIdentity())
 				continue;
-				
-			PlayerIdentity identity = player.GetIdentity();
-			if (!identity)
+			
+			SST_PlayerSampleState state = m_SampleStates.Get(player.GetIdentity().GetPlainId());
+			if (state && now < state.nextSampleAt)
 				continue;
 			
-			string playerId = identity.GetPlainId();
+			SST_FrameScheduler.Enqueue(new SST_OnlinePlayerUpdateTask(player));
+			exportDue = true;
+		}
+		
+		if (!exportDue)
+			return;
+		
+		m_UpdatePending = true;
+		SST_FrameScheduler.Enqueue(new SST_OnlinePlayersExportTask());
+	}
+	
+	// Run by SST_OnlinePlayerUpdateTask from the frame scheduler
+	void UpdateOnlinePlayer(PlayerBase player)
+	{
+		// Player may have disconnected while the task was queued
+		if (!player)
+			return;
 			
-			if (m_OnlinePlayers.Contains(playerId))
-			{
-				ref SST_OnlinePlayerData playerData = m_OnlinePlayers.Get(playerId);
-				if (playerData.isOnline)
-				{
-					UpdatePlayerData(player, playerData);
-				}
-			}
-			else
+		PlayerIdentity identity = player.GetIdentity();
+		if (!identity)
+			return;
+		
+		string playerId = identity.GetPlainId();
+		
+		if (m_OnlinePlayers.Contains(playerId))
+		{
+			ref SST_OnlinePlayerData playerData = m_OnlinePlayers.Get(playerId);
+			if (playerData.isOnline)
 			{
-				// Player exists but not in our map (edge case - add them)
-				PlayerConnected(player);
+				// Idle players are still rewritten once per HEARTBEAT_INTERVAL so lastUpdate stays fresh
+				SST_PlayerSampleState state = m_SampleStates.Get(playerId);
+				bool heartbeat = !state || GetGame().GetTime() - state.lastChangeAt >= HEARTBEAT_INTERVAL;
+				
+				bool changed = UpdatePlayerData(player, playerData, heartbeat);
+				ScheduleNextSample(player, playerId, changed);
+				if (changed)
+					m_RosterDirty = true;
 			}
 		}
+		else if (!m_Registry.Contains(playerId))
+		{
+			// Player exists but not in our map (edge case - add them).
+			// Registry players are skipped: they just disconnected and this task was queued before that.
+			PlayerConnected(player);
+		}
+	}
+	
+	// Run by SST_OnlinePlayersExportTask once all update tasks of the pass have run
+	void FinishUpdatePass()
+	{
+		// Nothing moved past the thresholds: keep the current file unless the heartbeat is due
+		if (m_RosterDirty || GetGame().GetTime() - m_LastExportAt >= HEARTBEAT_INTERVAL)
+			ExportOnlinePlayers();
+		
+		m_UpdatePending = false;
 	}
 	
 	protected void ExportOnlinePlayers()
 	{
 		ref SST_OnlinePlayersData exportData = new SST_OnlinePlayersData();
-		exportData.generatedAt = GetUTCTimestamp();
-		
-		int onlineCount = 0;
+		exportData.generatedAt = SST_Clock.Now();
 		
-		// Export all tracked players
+		// Online players only; disconnected players live in the registry file
 		for (int i = 0; i < m_OnlinePlayers.Count(); i++)
 		{
 			ref SST_OnlinePlayerData playerData = m_OnlinePlayers.GetElement(i);
 			if (playerData)
-			{
 				exportData.players.Insert(playerData);
-				if (playerData.isOnline)
-					onlineCount++;
-			}
 		}
 		
-		exportData.onlineCount = onlineCount;
+		exportData.onlineCount = exportData.players.Count();
 		
+		SST_SnapshotPublisher publisher = SST_SnapshotPublisher.Get(SNAPSHOT_CHANNEL);
+		SST_JsonWriter writer = publisher.Begin("online_players");
+		if (!writer)
+			return;
+		
+		SST_JsonExport.WriteOnlinePlayers(writer, exportData);
+		if (!publisher.Publish("online_players", writer, ONLINE_PLAYERS_FILE))
+		{
+			Print("[SST] ERROR: Failed to save online players to " + ONLINE_PLAYERS_FILE);
+			return;
+		}
+		
+		m_RosterDirty = false;
+		m_LastExportAt = GetGame().GetTime();
+	}
+	
+	// Write the registry of disconnected players (oldest disconnect first)
+	void SaveRegistry()
+	{
+		ref SST_PlayerRegistryData registryData = new SST_PlayerRegistryData();
+		registryData.generatedAt = SST_Clock.Now();
+		
+		foreach (string playerId : m_RegistryOrder)
+		{
+			ref SST_OnlinePlayerData playerData = m_Registry.Get(playerId);
+			if (playerData)
+				registryData.players.Insert(playerData);
+		}
+		registryData.playerCount = registryData.players.Count();
+		
+		SST_SnapshotPublisher publisher = SST_SnapshotPublisher.Get(SNAPSHOT_CHANNEL);
+		SST_JsonWriter writer = publisher.Begin("player_registry");
+		if (!writer)
+			return;
+		
+		SST_JsonExport.WritePlayerRegistry(writer, registryData);
+		if (publisher.Publish("player_registry", writer, REGISTRY_FILE))
+			m_RegistryDirty = false;
+		else
+			Print("[SST] ERROR: Failed to save player registry to " + REGISTRY_FILE);
+	}
+	
+	// Restore the registry written before the last restart
+	protected void LoadRegistry()
+	{
+		string registryPath = SST_SnapshotPublisher.Get(SNAPSHOT_CHANNEL).GetSnapshotPath("player_registry");
+		if (registryPath == "")
+			registryPath = REGISTRY_FILE;
+		
+		if (!FileExist(registryPath))
+			return;
+		
+		ref SST_PlayerRegistryData registryData = new SST_PlayerRegistryData();
 		string errorMsg;
-		if (!JsonFileLoader<SST_OnlinePlayersData>.SaveFile(ONLINE_PLAYERS_FILE, exportData, errorMsg))
+		if (!JsonFileLoader<SST_PlayerRegistryData>.LoadFile(registryPath, registryData, errorMsg))
 		{
-			Print("[SST] ERROR: Failed to save online players: " + errorMsg);
+			Print("[SST] WARNING: Could not load player registry: " + errorMsg);
+			return;
 		}
+		
+		foreach (SST_OnlinePlayerData playerData : registryData.players)
+		{
+			if (!playerData || playerData.playerId == "")
+				continue;
+			
+			playerData.isOnline = false;
+			AddToRegistry(playerData);
+		}
+		
+		m_RegistryDirty = false;
+		Print("[SST] Loaded player registry: " + m_Registry.Count().ToString() + " players");
+	}
+}
+
+// Frame scheduler task: refresh one player's position/status
+class SST_OnlinePlayerUpdateTask : SST_SchedulerTask
+{
+	protected PlayerBase m_Player;
+	
+	void SST_OnlinePlayerUpdateTask(PlayerBase player)
+	{
+		m_Player = player;
 	}
 	
-	// Clean up disconnected players after 24 hours (optional maintenance)
-	void CleanupOldDisconnectedPlayers()
+	override void Run()
 	{
-		// This could be called periodically to remove very old disconnected player entries
-		// For now, we keep all players to maintain history
+		SST_OnlinePlayerTracker.GetInstance().UpdateOnlinePlayer(m_Player);
 	}
 }
 
+// Frame scheduler task: write online_players.json at the end of an update pass
+class SST_OnlinePlayersExportTask : SST_SchedulerTask
+{
+	override void Run()
+	{
+		SST_OnlinePlayerTracker.GetInstance().FinishUpdatePass();
+	}
+}
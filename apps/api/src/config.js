@@ -90,7 +90,9 @@ export const paths = {
   events: normalizeEnvPath(process.env.EVENTS_PATH) || `${defaultBasePath}/events`,
   lifeEvents: normalizeEnvPath(process.env.LIFE_EVENTS_PATH) || `${defaultBasePath}/life_events`,
   trades: normalizeEnvPath(process.env.TRADES_PATH) || `${defaultBasePath}/trades`,
+  history: normalizeEnvPath(process.env.HISTORY_PATH) || `${defaultBasePath}/history`,
   api: normalizeEnvPath(process.env.API_PATH) || `${defaultBasePath}/api`,
+  snapshots: normalizeEnvPath(process.env.SNAPSHOTS_PATH) || `${defaultBasePath}/snapshots`,
   onlinePlayers: normalizeEnvPath(process.env.ONLINE_PLAYERS_PATH) || (process.env.API_PATH ? `${normalizeEnvPath(process.env.API_PATH)}/online_players.json` : `${defaultBasePath}/api/online_players.json`),
   
   // Expansion paths
@@ -124,7 +126,9 @@ export function logConfig() {
   console.log(`  - Events: ${paths.events}`);
   console.log(`  - Life Events: ${paths.lifeEvents}`);
   console.log(`  - Trades: ${paths.trades}`);
+  console.log(`  - History: ${paths.history}`);
   console.log(`  - API: ${paths.api}`);
+  console.log(`  - Snapshots: ${paths.snapshots}`);
   console.log(`  - Mission: ${paths.missionFolder}`);
   console.log(`  - Types.xml: ${paths.typesXml || paths.missionFolder + '/db/types.xml'}`);
   if (features.expansionEnabled) {
@@ -30,6 +30,10 @@
  * 
  * PERFORMANCE NOTES:
  * - Uses prepared statements for all queries (security + speed)
+ * - recordPositionsBatch() samples adaptively: a player is skipped until they
+ *   moved POSITION_MIN_DISTANCE metres or their vitals changed, with a row at
+ *   least every POSITION_MAX_IDLE_MS. Players in vehicles may be recorded every
+ *   POSITION_FAST_INTERVAL, everyone else every POSITION_TRACKING_INTERVAL.
  * - Indexes on player_id and timestamp for fast lookups
  * - WAL mode enabled for better concurrent access
  * 
@@ -134,6 +138,72 @@ const getPositionStats = db.prepare(`
   FROM player_positions
 `);
 
+const getLastPlayerPosition = db.prepare(`
+  SELECT pos_x, pos_y, pos_z, health, blood, is_alive, is_unconscious, created_at
+  FROM player_positions
+  WHERE player_id = ?
+  ORDER BY created_at DESC
+  LIMIT 1
+`);
+
+// Adaptive sampling thresholds (0 disables a threshold)
+function envNumber(name, fallback) {
+  const value = parseFloat(process.env[name]);
+  return Number.isFinite(value) ? value : fallback;
+}
+
+export const samplingConfig = {
+  trackingInterval: envNumber('POSITION_TRACKING_INTERVAL', 30000),
+  fastInterval: envNumber('POSITION_FAST_INTERVAL', 10000),
+  minDistance: envNumber('POSITION_MIN_DISTANCE', 5),
+  minHealthDelta: envNumber('POSITION_MIN_HEALTH_DELTA', 2),
+  minBloodDelta: envNumber('POSITION_MIN_BLOOD_DELTA', 100),
+  maxIdleMs: envNumber('POSITION_MAX_IDLE_MS', 300000)
+};
+
+// playerId -> last recorded sample { x, y, z, health, blood, isAlive, isUnconscious, at }
+// Online players only; see positionDb.forgetOfflinePlayers()
+const lastRecorded = new Map();
+
+function getLastRecorded(playerId) {
+  if (!lastRecorded.has(playerId)) {
+    const row = getLastPlayerPosition.get(playerId);
+    lastRecorded.set(playerId, row ? {
+      x: row.pos_x,
+      y: row.pos_y,
+      z: row.pos_z,
+      health: row.health,
+      blood: row.blood,
+      isAlive: row.is_alive === 1,
+      isUnconscious: row.is_unconscious === 1,
+      at: row.created_at * 1000
+    } : null);
+  }
+  return lastRecorded.get(playerId);
+}
+
+function shouldRecord(pos, last, now) {
+  if (!last) return true;
+
+  const elapsed = now - last.at;
+  const minInterval = pos.inVehicle ? samplingConfig.fastInterval : samplingConfig.trackingInterval;
+  // Leave some slack so a timer tick that fires slightly early still records
+  if (elapsed < minInterval * 0.9) return false;
+  if (elapsed >= samplingConfig.maxIdleMs) return true;
+
+  if (Boolean(pos.isAlive) !== last.isAlive || Boolean(pos.isUnconscious) !== last.isUnconscious) return true;
+
+  const dx = pos.posX - last.x;
+  const dy = pos.posY - last.y;
+  const dz = pos.posZ - last.z;
+  if (Math.sqrt(dx * dx + dy * dy + dz * dz) >= samplingConfig.minDistance) return true;
+
+  if (Math.abs((pos.health ?? 0) - (last.health ?? 0)) >= samplingConfig.minHealthDelta) return true;
+  if (Math.abs((pos.blood ?? 0) - (last.blood ?? 0)) >= samplingConfig.minBloodDelta) return true;
+
+  return false;
+}
+
 // Export database functions
 export const positionDb = {
   /**
@@ -145,9 +215,16 @@ export const positionDb = {
   },
 
   /**
-   * Batch record multiple positions (for importing from online_players.json)
+   * Batch record multiple positions (for importing from online_players.json).
+   * Players that did not move or change since their last row are skipped (see
+   * samplingConfig) unless options.force is set. Returns the number of rows written.
    */
-  recordPositionsBatch(positions) {
+  recordPositionsBatch(positions, options = {}) {
+    const now = Date.now();
+    const due = options.force
+      ? positions
+      : positions.filter(pos => shouldRecord(pos, getLastRecorded(pos.playerId), now));
+
     const insertMany = db.transaction((items) => {
       for (const pos of items) {
         insertPosition.run(
@@ -162,9 +239,32 @@ export const positionDb = {
           pos.isUnconscious ? 1 : 0,
           pos.recordedAt || new Date().toISOString()
         );
+        lastRecorded.set(pos.playerId, {
+          x: pos.posX,
+          y: pos.posY,
+          z: pos.posZ,
+          health: pos.health ?? null,
+          blood: pos.blood ?? null,
+          isAlive: Boolean(pos.isAlive),
+          isUnconscious: Boolean(pos.isUnconscious),
+          at: now
+        });
       }
     });
-    return insertMany(positions);
+    insertMany(due);
+    return due.length;
+  },
+
+  /**
+   * Drop the adaptive-sampling state of players that are no longer online.
+   * Called with the full online list on every capture, so the map only ever
+   * holds online players; a reconnecting player is read back from the table.
+   */
+  forgetOfflinePlayers(onlinePlayerIds) {
+    const online = new Set(onlinePlayerIds);
+    for (const playerId of lastRecorded.keys()) {
+      if (!online.has(playerId)) lastRecorded.delete(playerId);
+    }
   },
 
   /**
@@ -12,9 +12,9 @@
  * 
  * WORKFLOW:
  * 1. Dashboard sends POST request with player ID and command data
- * 2. API writes command to player_commands.json
- * 3. DayZ mod polls this file and executes command
- * 4. Mod writes result to player_commands_results.json
+ * 2. API drops the command into the player_commands spool (utils/spool.js)
+ * 3. DayZ mod claims it and executes the command
+ * 4. Mod writes one result file per command
  * 5. Dashboard can poll for results
  * 
  * ENDPOINTS:
@@ -23,25 +23,38 @@
  * - POST /spawn-item     - Spawn item in player inventory
  * - POST /kill           - Kill player
  * - GET  /results        - Get command execution results
+ * - GET  /results/:requestId - Result of one command
+ * - GET  /metrics        - Executor backlog and wait times (all command queues)
  * - DELETE /results/:id  - Clear a result entry
  * 
  * DATA FILES:
- * - player_commands.json         - Queued commands for mod to execute
- * - player_commands_results.json - Execution results from mod
+ * - spool/player_commands/incoming/   - Queued commands, one file each
+ * - spool/player_commands/processing/ - Commands the mod is executing
+ * - results/player_commands/          - Results journal from mod (NDJSON + requestId lookup)
+ * - player_commands_results.json      - Results of commands queued before the spool
+ * - command_metrics.json              - Backlog/latency per queue (SST_CommandExecutor)
  * 
  * HOW TO ADD A NEW COMMAND:
  * 1. Add new POST route with command type
- * 2. Add command to the queue with unique ID
+ * 2. Queue the command with queueCommand()
  * 3. Update mod's command handler to recognize new type
  * 4. Document expected parameters and behavior
  */
 import { Router } from "express";
-import { readFile, writeFile } from "../storage/fs.js";
+import { readFile } from "../storage/fs.js";
 import { paths } from "../config.js";
+import { enqueueSpool, listSpoolPending, readQueueResults, readSpoolResult } from "../utils/spool.js";
 
 const router = Router();
-const commandFile = `${paths.api}/player_commands.json`;
-const resultsFile = `${paths.api}/player_commands_results.json`;
+const COMMAND_QUEUE = "player_commands";
+const legacyResultsFile = `${paths.api}/player_commands_results.json`;
+const metricsFile = `${paths.api}/command_metrics.json`;
+
+// Drop one command into the spool; sets command.requestId
+async function queueCommand(command) {
+  command.requestId = await enqueueSpool(COMMAND_QUEUE, command, "cmd");
+  return command;
+}
 
 // Heal a player
 router.post("/heal", async (req, res) => {
@@ -56,14 +69,11 @@ router.post("/heal", async (req, res) => {
     result: ""
   };
 
-  let data = { requests: [] };
   try {
-    data = JSON.parse(await readFile(commandFile, "utf8"));
-    if (!data.requests) data.requests = [];
-  } catch {}
-
-  data.requests.push(command);
-  await writeFile(commandFile, JSON.stringify(data, null, 2));
+    await queueCommand(command);
+  } catch (err) {
+    return res.status(500).json({ error: `Failed to queue command: ${err.message}` });
+  }
 
   res.json({ status: "QUEUED", command });
 });
@@ -91,38 +101,56 @@ router.post("/teleport", async (req, res) => {
     result: ""
   };
 
-  let data = { requests: [] };
   try {
-    data = JSON.parse(await readFile(commandFile, "utf8"));
-    if (!data.requests) data.requests = [];
-  } catch {}
-
-  data.requests.push(command);
-  await writeFile(commandFile, JSON.stringify(data, null, 2));
+    await queueCommand(command);
+  } catch (err) {
+    return res.status(500).json({ error: `Failed to queue command: ${err.message}` });
+  }
 
   res.json({ status: "QUEUED", command });
 });
 
-// Get command results
-router.get("/results", async (_, res) => {
+// Get command results, newest first
+router.get("/results", async (req, res) => {
   try {
-    const results = JSON.parse(await readFile(resultsFile, "utf8"));
-    res.json(results);
-  } catch {
-    res.json({ requests: [] });
+    const limit = parseInt(req.query.limit) || 50;
+    res.json({ requests: await readQueueResults(COMMAND_QUEUE, legacyResultsFile, { limit }) });
+  } catch (err) {
+    res.status(500).json({ error: err.message });
+  }
+});
+
+// One command by the requestId its POST returned
+router.get("/results/:requestId", async (req, res) => {
+  try {
+    const result = await readSpoolResult(COMMAND_QUEUE, req.params.requestId);
+    if (!result) {
+      return res.status(404).json({ error: "No result for this request yet" });
+    }
+    res.json(result);
+  } catch (err) {
+    res.status(500).json({ error: err.message });
   }
 });
 
-// Get pending commands
+// Get pending commands (waiting or being executed)
 router.get("/pending", async (_, res) => {
   try {
-    const data = JSON.parse(await readFile(commandFile, "utf8"));
-    res.json(data);
+    res.json({ requests: await listSpoolPending(COMMAND_QUEUE) });
   } catch {
     res.json({ requests: [] });
   }
 });
 
+// Executor backlog and command latency, written by the mod every 10s while commands are flowing
+router.get("/metrics", async (_, res) => {
+  try {
+    res.json(JSON.parse(await readFile(metricsFile, "utf8")));
+  } catch {
+    res.status(404).json({ error: "No command metrics yet" });
+  }
+});
+
 // Send a message to a specific player
 router.post("/message", async (req, res) => {
   const { playerId, message, messageType } = req.body;
@@ -148,14 +176,11 @@ router.post("/message", async (req, res) => {
     result: ""
   };
 
-  let data = { requests: [] };
   try {
-    data = JSON.parse(await readFile(commandFile, "utf8"));
-    if (!data.requests) data.requests = [];
-  } catch {}
-
-  data.requests.push(command);
-  await writeFile(commandFile, JSON.stringify(data, null, 2));
+    await queueCommand(command);
+  } catch (err) {
+    return res.status(500).json({ error: `Failed to queue command: ${err.message}` });
+  }
 
   res.json({ status: "QUEUED", command });
 });
@@ -181,14 +206,11 @@ router.post("/broadcast", async (req, res) => {
     result: ""
   };
 
-  let data = { requests: [] };
   try {
-    data = JSON.parse(await readFile(commandFile, "utf8"));
-    if (!data.requests) data.requests = [];
-  } catch {}
-
-  data.requests.push(command);
-  await writeFile(commandFile, JSON.stringify(data, null, 2));
+    await queueCommand(command);
+  } catch (err) {
+    return res.status(500).json({ error: `Failed to queue command: ${err.message}` });
+  }
 
   res.json({ status: "QUEUED", command });
 });
@@ -5,7 +5,9 @@
  * 
  * @file        routes/dashboard.js
  * @description Main dashboard data routes with in-memory caching for fast
- *              responses. Aggregates player data from multiple JSON files.
+ *              responses. Per-player summaries come from the inventories
+ *              manifest and the server-wide event stream; a player's full
+ *              files are only read when that player is opened.
  * 
  * @author      SUDO Gaming
  * @license     Non-Commercial (see LICENSE file)
@@ -14,12 +16,14 @@
  * 
  * ENDPOINTS:
  * - GET  /dashboard          - Get all cached player data
- * - GET  /dashboard/player/:id - Get single player data
+ * - GET  /dashboard/player/:id - Get single player data (read on request)
  * - POST /dashboard/refresh   - Force cache refresh
  * - GET  /dashboard/grants    - Get grant results from cache
  * 
  * CACHING:
- * - Player data is cached in memory for fast responses
+ * - Player summaries (name, item count, event counts) are cached in memory
+ * - Inventories are re-read only when their manifest hash changes; event
+ *   counts are updated from new event stream records
  * - Auto-refreshes every 20 seconds (configurable)
  * - Call /refresh to force immediate update
  * 
@@ -35,12 +39,16 @@ import { Router } from "express";
 import { readFile, readdir } from "../storage/fs.js";
 import { paths } from "../config.js";
 import { consoleUi } from "../utils/consoleUi.js";
+import { readManifest, readSnapshot } from "../utils/snapshots.js";
+import { newestFirst } from "../utils/timestamps.js";
+import { createEventFeed } from "../utils/eventStream.js";
+import { readQueueResults } from "../utils/spool.js";
 
 const router = Router();
 
 // In-memory cache
 let cache = {
-  players: {},        // playerId -> { inventory, events, lifeEvents }
+  players: {},        // playerId -> { playerName, inventoryCount, eventCount, lifeEventCount }
   grantResults: [],
   recentDeaths: [],
   lastUpdate: null
@@ -48,13 +56,47 @@ let cache = {
 
 let refreshInterval = null;
 
+// Inventory part of each player's summary, re-read only when the player's
+// snapshot hash or generation in the inventories manifest changes
+const inventorySummaries = new Map(); // playerId -> { hash, generation, playerName, inventoryCount }
+
+// Inventory and life event counts per player, counted from the event stream as new records arrive
+const eventCounts = new Map();        // playerId -> { eventCount, lifeEventCount }
+
+// Recent deaths from the mod's server-wide event stream (only new records are read per refresh)
+const deathFeed = createEventFeed({
+  accept: r => r.stream === "life" && r.eventType === "DIED",
+  capacity: 20,
+  onRecord: countStreamEvent
+});
+
 // Refresh cache every 20 seconds
 const REFRESH_INTERVAL_MS = 20000;
 
+function countStreamEvent(record) {
+  if (!record.playerId || (record.stream !== "inventory" && record.stream !== "life")) return;
+
+  let counts = eventCounts.get(record.playerId);
+  if (!counts) {
+    counts = { eventCount: 0, lifeEventCount: 0 };
+    eventCounts.set(record.playerId, counts);
+  }
+  if (record.stream === "inventory") counts.eventCount++;
+  else counts.lifeEventCount++;
+}
+
+function summarizeInventory(inventory) {
+  const invData = inventory?.players?.[0];
+  return {
+    playerName: invData?.playerName || null,
+    inventoryCount: invData?.inventory?.length || 0
+  };
+}
+
 async function loadPlayerInventory(playerId) {
   try {
     const file = `${paths.inventories}/${playerId}.json`;
-    return JSON.parse(await readFile(file, "utf8"));
+    return await readSnapshot("inventories", playerId, file);
   } catch {
     return null;
   }
@@ -80,15 +122,49 @@ async function loadPlayerLifeEvents(playerId) {
 
 async function loadGrantResults() {
   try {
-    const data = JSON.parse(
-      await readFile(`${paths.api}/item_grants_results.json`, "utf8")
-    );
-    return data.requests || [];
+    return await readQueueResults("item_grants", `${paths.api}/item_grants_results.json`);
   } catch {
     return [];
   }
 }
 
+// Summaries from the inventories manifest and the stream counts; downloads only changed inventories
+async function buildPlayerSummaries(manifest) {
+  const playerIds = new Set(manifest.entries.map(e => e.name));
+
+  for (const playerId of inventorySummaries.keys()) {
+    if (!playerIds.has(playerId)) inventorySummaries.delete(playerId);
+  }
+
+  await Promise.all(manifest.entries.map(async (entry) => {
+    const known = inventorySummaries.get(entry.name);
+    if (known && known.hash === entry.hash && known.generation === entry.generation) return;
+
+    const inventory = await loadPlayerInventory(entry.name);
+    inventorySummaries.set(entry.name, {
+      hash: entry.hash,
+      generation: entry.generation,
+      ...summarizeInventory(inventory)
+    });
+  }));
+
+  // Players with stream events but no inventory snapshot are listed too
+  for (const playerId of eventCounts.keys()) playerIds.add(playerId);
+
+  const players = {};
+  for (const playerId of playerIds) {
+    const inventory = inventorySummaries.get(playerId);
+    const counts = eventCounts.get(playerId);
+    players[playerId] = {
+      playerName: inventory?.playerName || null,
+      inventoryCount: inventory?.inventoryCount || 0,
+      eventCount: counts?.eventCount || 0,
+      lifeEventCount: counts?.lifeEventCount || 0
+    };
+  }
+  return players;
+}
+
 async function discoverPlayerIds() {
   const playerIds = new Set();
   
@@ -122,42 +198,55 @@ async function discoverPlayerIds() {
   return Array.from(playerIds);
 }
 
+// Older mod versions without the event stream or the inventories manifest: read every player's files
+async function loadLegacyPlayerSummaries() {
+  const playerIds = await discoverPlayerIds();
+
+  const playerDataResults = await Promise.all(playerIds.map(async (playerId) => {
+    const [inventory, events, lifeEvents] = await Promise.all([
+      loadPlayerInventory(playerId),
+      loadPlayerEvents(playerId),
+      loadPlayerLifeEvents(playerId)
+    ]);
+    return { playerId, inventory, events, lifeEvents };
+  }));
+
+  const players = {};
+  const deaths = [];
+  for (const { playerId, inventory, events, lifeEvents } of playerDataResults) {
+    players[playerId] = {
+      ...summarizeInventory(inventory),
+      eventCount: events?.events?.length || 0,
+      lifeEventCount: lifeEvents?.events?.length || 0
+    };
+
+    if (lifeEvents?.events) {
+      deaths.push(...lifeEvents.events.filter(e => e.eventType === "DIED"));
+    }
+  }
+
+  deaths.sort(newestFirst);
+  return { players, recentDeaths: deaths.slice(0, 20) };
+}
+
 async function refreshCache() {
   const startTime = Date.now();
   
   try {
-    const playerIds = await discoverPlayerIds();
-    
-    // Load all player data in parallel
-    const playerDataPromises = playerIds.map(async (playerId) => {
-      const [inventory, events, lifeEvents] = await Promise.all([
-        loadPlayerInventory(playerId),
-        loadPlayerEvents(playerId),
-        loadPlayerLifeEvents(playerId)
-      ]);
-      return { playerId, inventory, events, lifeEvents };
-    });
+    const [streamAvailable, manifest] = await Promise.all([
+      deathFeed.refresh(),
+      readManifest("inventories")
+    ]);
 
-    const playerDataResults = await Promise.all(playerDataPromises);
-    
-    // Build players object and collect deaths
-    const players = {};
-    const allDeaths = [];
-    
-    for (const { playerId, inventory, events, lifeEvents } of playerDataResults) {
-      players[playerId] = { inventory, events, lifeEvents };
-      
-      // Collect deaths for recent deaths list
-      if (lifeEvents?.events) {
-        const deaths = lifeEvents.events.filter(e => e.eventType === "DIED");
-        allDeaths.push(...deaths);
-      }
+    let players;
+    let recentDeaths;
+    if (streamAvailable && manifest) {
+      players = await buildPlayerSummaries(manifest);
+      recentDeaths = deathFeed.items();
+    } else {
+      ({ players, recentDeaths } = await loadLegacyPlayerSummaries());
     }
 
-    // Sort deaths by timestamp descending, keep last 20
-    allDeaths.sort((a, b) => new Date(b.timestamp) - new Date(a.timestamp));
-    const recentDeaths = allDeaths.slice(0, 20);
-
     // Load grant results
     const grantResults = await loadGrantResults();
 
@@ -199,15 +288,23 @@ router.get("/", (req, res) => {
   res.json(cache);
 });
 
-// GET /dashboard/player/:playerId - returns single player from cache
-router.get("/player/:playerId", (req, res) => {
-  const player = cache.players[req.params.playerId];
-  if (!player) {
+// GET /dashboard/player/:playerId - returns one cached player's inventory and event files
+router.get("/player/:playerId", async (req, res) => {
+  const { playerId } = req.params;
+  if (!cache.players[playerId]) {
     return res.status(404).json({ error: "Player not found in cache" });
   }
+
+  const [inventory, events, lifeEvents] = await Promise.all([
+    loadPlayerInventory(playerId),
+    loadPlayerEvents(playerId),
+    loadPlayerLifeEvents(playerId)
+  ]);
   res.json({
-    playerId: req.params.playerId,
-    ...player,
+    playerId,
+    inventory,
+    events,
+    lifeEvents,
     cacheAge: cache.lastUpdate
   });
 });
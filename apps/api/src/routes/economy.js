@@ -44,6 +44,7 @@ import { paths } from "../config.js";
 import { joinStoragePath } from "../utils/storagePath.js";
 import { loadTypesData, analyzeSpawnVsPrice, getSpawnStats } from "../utils/typesParser.js";
 import { getArchiveDb } from "../db/archiveDb.js";
+import { eventTime, newestFirst } from "../utils/timestamps.js";
 
 const router = Router();
 
@@ -127,18 +128,18 @@ function parseDateFilter(period, startDate, endDate) {
 }
 
 /**
- * Check if a trade timestamp falls within the date range
- * @param {string} timestamp - Trade timestamp
+ * Check if a trade falls within the date range
+ * @param {object} trade - Trade record (timestamp / timestampUnix)
  * @param {Date | null} startDate - Filter start date
  * @param {Date | null} endDate - Filter end date
  * @returns {boolean}
  */
-function isWithinDateRange(timestamp, startDate, endDate) {
+function isWithinDateRange(trade, startDate, endDate) {
   if (!startDate && !endDate) return true;
   
-  const tradeDate = new Date(timestamp);
-  if (startDate && tradeDate < startDate) return false;
-  if (endDate && tradeDate > endDate) return false;
+  const tradeTime = eventTime(trade);
+  if (startDate && tradeTime < startDate.getTime()) return false;
+  if (endDate && tradeTime > endDate.getTime()) return false;
   return true;
 }
 
@@ -246,7 +247,7 @@ router.get("/", async (req, res) => {
       
       // Track hourly activity
       try {
-        const hour = new Date(trade.timestamp).getUTCHours();
+        const hour = new Date(eventTime(trade)).getUTCHours();
         hourlyActivity[hour]++;
       } catch {}
       
@@ -267,7 +268,7 @@ router.get("/", async (req, res) => {
         if (data.trades && data.trades.length > 0) {
           // Filter trades by date range
           const filteredTrades = data.trades.filter(trade => 
-            isWithinDateRange(trade.timestamp, filterStart, filterEnd)
+            isWithinDateRange(trade, filterStart, filterEnd)
           );
           
           if (filteredTrades.length === 0) continue;
@@ -351,7 +352,7 @@ router.get("/", async (req, res) => {
             
             // Track hourly activity
             try {
-              const hour = new Date(trade.timestamp).getUTCHours();
+              const hour = new Date(eventTime(trade)).getUTCHours();
               hourlyActivity[hour]++;
             } catch {}
             
@@ -368,7 +369,7 @@ router.get("/", async (req, res) => {
     }
     
     // Sort and limit recent transactions
-    recentTransactions.sort((a, b) => new Date(b.timestamp) - new Date(a.timestamp));
+    recentTransactions.sort(newestFirst);
     const latestTransactions = recentTransactions.slice(0, 50);
     
     // Calculate top items by volume (purchases + sales)
@@ -402,7 +403,7 @@ router.get("/", async (req, res) => {
     let oldestTransaction = null;
     let newestTransaction = null;
     for (const tx of recentTransactions) {
-      const txDate = new Date(tx.timestamp);
+      const txDate = new Date(eventTime(tx));
       if (!oldestTransaction || txDate < oldestTransaction) oldestTransaction = txDate;
       if (!newestTransaction || txDate > newestTransaction) newestTransaction = txDate;
     }
@@ -13,28 +13,58 @@
  * @lastUpdated 2026-01-17
  * 
  * ENDPOINTS:
- * - POST /grants         - Queue an item grant for a player
- * - GET  /grants/results - Get results of processed grants
+ * - POST /grants             - Queue an item grant for a player
+ * - GET  /grants/results     - Get results of processed grants
+ * - GET  /grants/results/:requestId - Result of one grant
+ * - POST /grants/kit         - Queue a kit (items + attachments + cargo) for players or "all"
+ * - GET  /grants/kit/results - Get results of processed kit grants
+ * - GET  /grants/kit/results/:requestId - Result of one kit grant
  * 
  * DATA FILES:
- * - API_PATH/item_grants.json        - Queue of pending grants
- * - API_PATH/item_grants_results.json - Processed grant results
+ * - API_PATH/spool/item_grants/incoming/ - One file per pending grant
+ * - API_PATH/results/item_grants/        - Results journal (NDJSON + requestId lookup)
+ * - API_PATH/item_grants_results.json    - Results of grants queued before the spool
+ * - API_PATH/spool/kit_grants/           - Kit grants, one file each
+ * - API_PATH/results/kit_grants/         - Kit grant results journal
  * 
  * WORKFLOW:
  * 1. Dashboard calls POST /grants with playerId and item details
- * 2. Grant is written to item_grants.json with processed=false
- * 3. SST mod reads queue, gives item to player, sets processed=true
+ * 2. Grant is dropped into the item_grants spool (utils/spool.js)
+ * 3. SST mod claims it, gives item to player, writes the result file
  * 4. Dashboard polls /results to show success/failure
  * 
  * =============================================================================
  */
 
 import { Router } from "express";
-import { readFile, writeFile } from "../storage/fs.js";
 import { paths } from "../config.js";
+import { enqueueSpool, readQueueResults, readSpoolResult, readSpoolResults } from "../utils/spool.js";
 
 const router = Router();
-const grantFile = `${paths.api}/item_grants.json`;
+const GRANT_QUEUE = "item_grants";
+const KIT_QUEUE = "kit_grants";
+const legacyResultsFile = `${paths.api}/item_grants_results.json`;
+
+// Same cap as SST_ItemGrantAPI.MAX_KIT_ITEMS (attachments and cargo included)
+const MAX_KIT_ITEMS = 100;
+
+// Normalise one kit item (recursively); throws on a malformed entry
+function toKitItem(item, counter) {
+  if (!item || typeof item.itemClassName !== "string" || item.itemClassName.trim() === "") {
+    throw new Error("every kit item needs an itemClassName");
+  }
+  if (++counter.items > MAX_KIT_ITEMS) {
+    throw new Error(`a kit may hold at most ${MAX_KIT_ITEMS} items`);
+  }
+
+  return {
+    itemClassName: item.itemClassName.trim(),
+    quantity: parseInt(item.quantity) || 1,
+    health: item.health ?? -1,
+    attachments: (item.attachments || []).map(child => toKitItem(child, counter)),
+    cargo: (item.cargo || []).map(child => toKitItem(child, counter)),
+  };
+}
 
 router.post("/", async (req, res) => {
   const grant = {
@@ -46,26 +76,98 @@ router.post("/", async (req, res) => {
     result: ""
   };
 
-  let data = { requests: [] };
   try {
-    data = JSON.parse(await readFile(grantFile, "utf8"));
-    if (!data.requests) data.requests = [];
-  } catch {}
-
-  data.requests.push(grant);
-  await writeFile(grantFile, JSON.stringify(data, null, 2));
+    grant.requestId = await enqueueSpool(GRANT_QUEUE, grant, "grant");
+  } catch (err) {
+    return res.status(500).json({ error: `Failed to queue grant: ${err.message}` });
+  }
 
   res.json({ status: "QUEUED", grant });
 });
 
-router.get("/results", async (_, res) => {
+router.get("/results", async (req, res) => {
+  try {
+    const limit = parseInt(req.query.limit) || 50;
+    const requests = await readQueueResults(GRANT_QUEUE, legacyResultsFile, { limit });
+    if (requests.length === 0) {
+      return res.status(404).json({ error: "No results yet" });
+    }
+    res.json({ requests });
+  } catch (err) {
+    res.status(500).json({ error: err.message });
+  }
+});
+
+// One grant by the requestId POST /grants returned
+router.get("/results/:requestId", async (req, res) => {
+  try {
+    const result = await readSpoolResult(GRANT_QUEUE, req.params.requestId);
+    if (!result) {
+      return res.status(404).json({ error: "No result for this request yet" });
+    }
+    res.json(result);
+  } catch (err) {
+    res.status(500).json({ error: err.message });
+  }
+});
+
+// Queue a kit for several players: one request, one notification per player
+router.post("/kit", async (req, res) => {
+  const { kitName = "", items } = req.body;
+  let { playerIds } = req.body;
+
+  if (playerIds === "all") playerIds = ["all"];
+  if (!Array.isArray(playerIds) || playerIds.length === 0) {
+    return res.status(400).json({ error: 'playerIds must be a non-empty array or "all"' });
+  }
+  if (!Array.isArray(items) || items.length === 0) {
+    return res.status(400).json({ error: "items must be a non-empty array" });
+  }
+
+  let kitItems;
+  try {
+    const counter = { items: 0 };
+    kitItems = items.map(item => toKitItem(item, counter));
+  } catch (err) {
+    return res.status(400).json({ error: err.message });
+  }
+
+  const kit = {
+    kitName: String(kitName),
+    playerIds: [...new Set(playerIds.map(String))],
+    items: kitItems,
+    processed: false,
+    result: ""
+  };
+
+  try {
+    kit.requestId = await enqueueSpool(KIT_QUEUE, kit, "kit");
+  } catch (err) {
+    return res.status(500).json({ error: `Failed to queue kit: ${err.message}` });
+  }
+
+  res.json({ status: "QUEUED", kit });
+});
+
+router.get("/kit/results", async (req, res) => {
+  try {
+    const limit = parseInt(req.query.limit) || 50;
+    res.json({ requests: await readSpoolResults(KIT_QUEUE, { limit }) });
+  } catch (err) {
+    res.status(500).json({ error: err.message });
+  }
+});
+
+// One kit grant by the requestId POST /grants/kit returned
+router.get("/kit/results/:requestId", async (req, res) => {
   try {
-    const results = JSON.parse(
-      await readFile(`${paths.api}/item_grants_results.json`, "utf8")
-    );
-    res.json(results);
-  } catch {
-    res.status(404).json({ error: "No results yet" });
+    const result = await readSpoolResult(KIT_QUEUE, req.params.requestId);
+    if (!result) {
+      return res.status(404).json({ error: "No result for this request yet" });
+    }
+    res.json(result);
+  } catch (err) {
+    res.status(500).json({ error: err.message });
   }
 });
 
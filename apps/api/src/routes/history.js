@@ -0,0 +1,75 @@
+/**
+ * @file history.js
+ * @description Full player event history from the mod's NDJSON segments
+ * 
+ * The per-player JSON logs (/events, /life-events, /trades) only hold the most
+ * recent entries. Every event is also appended to rotating NDJSON segments,
+ * kept until the mod's retention policy removes them. These endpoints tail them
+ * by byte offset.
+ * 
+ * ENDPOINTS:
+ * - GET /:stream/:playerId        - Latest records, or records after a cursor
+ * - GET /:stream/:playerId/index  - Segment list (file, size, lines, firstAt, lastAt)
+ * 
+ * STREAMS: events, life_events, trades
+ * 
+ * QUERY (GET /:stream/:playerId):
+ * - segment, offset - Cursor returned by the previous call; omit for the latest records
+ * - limit           - Max records (default 100, max 1000)
+ * 
+ * RESPONSE:
+ * { records: [...], cursor: { segment, offset }, hasMore, reset }
+ * `reset` is true when the cursor's segment was removed by retention and
+ * reading restarted at the oldest remaining segment.
+ * 
+ * DATA FILES:
+ * Location: {HISTORY_PATH}/{stream}/{playerId}/index.<0|1>.json + *.ndjson
+ */
+import { Router } from "express";
+import { HISTORY_STREAMS, readHistory, readHistoryIndex } from "../utils/ndjson.js";
+
+const router = Router();
+
+const PLAYER_ID_PATTERN = /^[A-Za-z0-9_-]+$/;
+
+function validate(req, res) {
+  const { stream, playerId } = req.params;
+  if (!HISTORY_STREAMS.includes(stream)) {
+    res.status(400).json({ error: `Unknown stream, expected one of: ${HISTORY_STREAMS.join(", ")}` });
+    return false;
+  }
+  if (!PLAYER_ID_PATTERN.test(playerId)) {
+    res.status(400).json({ error: "Invalid playerId" });
+    return false;
+  }
+  return true;
+}
+
+router.get("/:stream/:playerId/index", async (req, res) => {
+  if (!validate(req, res)) return;
+  try {
+    const index = await readHistoryIndex(req.params.stream, req.params.playerId);
+    if (!index) {
+      return res.status(404).json({ error: "No history for this player" });
+    }
+    res.json(index);
+  } catch (error) {
+    res.status(500).json({ error: "Failed to read history index", details: error.message });
+  }
+});
+
+router.get("/:stream/:playerId", async (req, res) => {
+  if (!validate(req, res)) return;
+  try {
+    const limit = Math.min(Math.max(parseInt(req.query.limit) || 100, 1), 1000);
+    const offset = Math.max(parseInt(req.query.offset) || 0, 0);
+    const segment = typeof req.query.segment === "string" ? req.query.segment : undefined;
+
+    const result = await readHistory(req.params.stream, req.params.playerId, { segment, offset, limit });
+    res.json(result);
+  } catch (error) {
+    res.status(500).json({ error: "Failed to read history", details: error.message });
+  }
+});
+
+export default router;
@@ -13,18 +13,21 @@
  * ENDPOINTS:
  * - GET    /:playerId              - Get player's current inventory
  * - DELETE /:playerId/item/:itemId - Queue item for deletion
- * - GET    /delete-results         - Get deletion execution results
+ * - GET    /delete-results/all     - Get deletion execution results
+ * - GET    /delete-results/:requestId - Result of one deletion
  * 
  * DATA FILES:
- * - item_deletes.json          - Queue of items to delete (mod polls this)
- * - item_deletes_results.json  - Results from mod after deletion
+ * - spool/item_deletes/incoming/ - Items to delete, one file per request
+ * - results/item_deletes/        - Results journal from mod (NDJSON + requestId lookup)
+ * - item_deletes_results.json    - Results of requests queued before the spool
  * - {playerId}_inventory.json  - Current player inventory state
  * 
  * DELETION WORKFLOW:
- * 1. Dashboard sends DELETE request with player/item IDs
- * 2. API adds to item_deletes.json queue
- * 3. DayZ mod polls file and deletes item from player
- * 4. Mod writes result to item_deletes_results.json
+ * 1. Dashboard sends DELETE request with player ID and itemId (stable id from
+ *    the inventory export) and/or itemPath (positional, used as fallback)
+ * 2. API drops the request into the item_deletes spool (utils/spool.js)
+ * 3. DayZ mod claims it and deletes item from player
+ * 4. Mod writes one result file per request
  * 5. Dashboard can check results endpoint
  * 
  * HOW TO EXTEND:
@@ -33,17 +36,18 @@
  * 3. Add inventory search across all players
  */
 import { Router } from "express";
-import { readFile, writeFile } from "../storage/fs.js";
 import { paths } from "../config.js";
+import { readSnapshot } from "../utils/snapshots.js";
+import { enqueueSpool, readQueueResults, readSpoolResult } from "../utils/spool.js";
 
 const router = Router();
-const deleteQueueFile = `${paths.api}/item_deletes.json`;
-const deleteResultsFile = `${paths.api}/item_deletes_results.json`;
+const DELETE_QUEUE = "item_deletes";
+const legacyResultsFile = `${paths.api}/item_deletes_results.json`;
 
 router.get("/:playerId", async (req, res) => {
   try {
     const file = `${paths.inventories}/${req.params.playerId}.json`;
-    const json = JSON.parse(await readFile(file, "utf8"));
+    const json = await readSnapshot("inventories", req.params.playerId, file);
     res.json(json);
   } catch {
     res.status(404).json({ error: "Inventory not found" });
@@ -53,14 +57,14 @@ router.get("/:playerId", async (req, res) => {
 // Delete item from player inventory
 router.delete("/:playerId/item", async (req, res) => {
   try {
-    const { itemClassName, itemPath, deleteCount = 0 } = req.body;
+    const { itemClassName, itemPath = "", itemId = "", deleteCount = 0 } = req.body;
     
     if (!itemClassName) {
       return res.status(400).json({ error: "itemClassName is required" });
     }
     
-    if (!itemPath) {
-      return res.status(400).json({ error: "itemPath is required" });
+    if (!itemPath && !itemId) {
+      return res.status(400).json({ error: "itemId or itemPath is required" });
     }
     
     const request = {
@@ -68,6 +72,7 @@ router.delete("/:playerId/item", async (req, res) => {
       playerId: req.params.playerId,
       itemClassName,
       itemPath,
+      itemId,
       deleteCount: parseInt(deleteCount) || 0,
       requestedAt: new Date().toISOString(),
       processed: false,
@@ -75,15 +80,7 @@ router.delete("/:playerId/item", async (req, res) => {
       result: ""
     };
     
-    // Load existing queue or create new
-    let queue = { requests: [] };
-    try {
-      queue = JSON.parse(await readFile(deleteQueueFile, "utf8"));
-      if (!queue.requests) queue.requests = [];
-    } catch {}
-    
-    queue.requests.push(request);
-    await writeFile(deleteQueueFile, JSON.stringify(queue, null, 2));
+    await enqueueSpool(DELETE_QUEUE, request);
     
     res.json({
       status: "queued",
@@ -99,10 +96,23 @@ router.delete("/:playerId/item", async (req, res) => {
 // Get delete results
 router.get("/delete-results/all", async (req, res) => {
   try {
-    const results = JSON.parse(await readFile(deleteResultsFile, "utf8"));
-    res.json(results);
-  } catch {
-    res.json({ requests: [] });
+    const limit = parseInt(req.query.limit) || 50;
+    res.json({ requests: await readQueueResults(DELETE_QUEUE, legacyResultsFile, { limit }) });
+  } catch (err) {
+    res.status(500).json({ error: err.message });
+  }
+});
+
+// One delete by its requestId (after /delete-results/all)
+router.get("/delete-results/:requestId", async (req, res) => {
+  try {
+    const result = await readSpoolResult(DELETE_QUEUE, req.params.requestId);
+    if (!result) {
+      return res.status(404).json({ error: "No result for this request yet" });
+    }
+    res.json(result);
+  } catch (err) {
+    res.status(500).json({ error: err.message });
   }
 });
 
@@ -21,11 +21,16 @@
  * - POST /items/counts/refresh - Refresh inventory count cache
  * 
  * DATA FILES:
- * - API_PATH/server_items.json - Generated by SST mod with all item data
+ * - API_PATH/server_items.json  - Generated by SST mod with all item data
+ * - API_PATH/items/index.json   - Category index (category, shard, itemCount, hash)
+ * - API_PATH/items/<shard>.json - One file per category
  * 
  * CACHING:
- * - Items loaded once on first request
- * - Stays in memory until server restart
+ * - Category views, search and lookups load only the shards they need
+ * - Shards are read through utils/snapshots.js and re-downloaded only when
+ *   their hash in the snapshot manifest changes
+ * - GET /items (full list) and older mod versions without shards use
+ *   server_items.json, loaded once and kept until /items/refresh
  * - Typically 15,000-20,000 items
  * 
  * HOW TO EXTEND:
@@ -36,9 +41,11 @@
  */
 
 import { Router } from "express";
-import { readFile, readdir } from "../storage/fs.js";
+import { readdir } from "../storage/fs.js";
 import { paths } from "../config.js";
 import { consoleUi } from "../utils/consoleUi.js";
+import { readSnapshot } from "../utils/snapshots.js";
+import { joinStoragePath } from "../utils/storagePath.js";
 
 const router = Router();
 
@@ -53,7 +60,7 @@ let inventoryCountsLastLoaded = null;
 async function loadItems() {
   try {
     const file = `${paths.api}/server_items.json`;
-    const data = JSON.parse(await readFile(file, "utf8"));
+    const data = await readSnapshot("api", "server_items", file);
     itemsCache = data;
     lastLoaded = new Date().toISOString();
     consoleUi.update({ itemsLoaded: data.itemCount });
@@ -68,8 +75,51 @@ async function loadItems() {
   }
 }
 
-// Load on startup
-loadItems();
+// Category index written by the mod; null with older mod versions (no shards)
+async function loadIndex() {
+  try {
+    const index = await readSnapshot("items", "index", joinStoragePath(paths.api, "items", "index.json"));
+    return Array.isArray(index?.categories) ? index : null;
+  } catch {
+    return null;
+  }
+}
+
+async function loadShard(entry) {
+  const data = await readSnapshot("items", entry.shard, joinStoragePath(paths.api, "items", `${entry.shard}.json`));
+  return data?.items || [];
+}
+
+// Items of one category (or all categories), loading only the shards needed.
+// Returns null if no item data is available at all.
+async function getItems(category) {
+  const index = await loadIndex();
+
+  if (!index) {
+    if (!itemsCache) {
+      await loadItems();
+    }
+    if (!itemsCache) return null;
+    if (!category) return itemsCache.items;
+    const cat = category.toLowerCase();
+    return itemsCache.items.filter(item => item.category.toLowerCase() === cat);
+  }
+
+  const wanted = category
+    ? index.categories.filter(c => c.category.toLowerCase() === category.toLowerCase())
+    : index.categories;
+  const shards = await Promise.all(wanted.map(loadShard));
+  return shards.flat();
+}
+
+// Report the catalog size on startup; the full list is only loaded when there are no shards
+loadIndex().then(index => {
+  if (index) {
+    consoleUi.update({ itemsLoaded: index.itemCount });
+  } else {
+    loadItems();
+  }
+});
 
 // GET /items - all items
 router.get("/", async (req, res) => {
@@ -84,15 +134,12 @@ router.get("/", async (req, res) => {
 
 // GET /items/search?q=Apple&category=Food - search items
 router.get("/search", async (req, res) => {
-  if (!itemsCache) {
-    await loadItems();
-  }
-  if (!itemsCache) {
+  // Category filter picks the shard; everything else filters within it
+  let results = await getItems(req.query.category);
+  if (!results) {
     return res.status(404).json({ error: "Items not found" });
   }
 
-  let results = itemsCache.items;
-
   // Filter by search query (className or displayName)
   if (req.query.q) {
     const q = req.query.q.toLowerCase();
@@ -102,14 +149,6 @@ router.get("/search", async (req, res) => {
     );
   }
 
-  // Filter by category
-  if (req.query.category) {
-    const cat = req.query.category.toLowerCase();
-    results = results.filter(item =>
-      item.category.toLowerCase() === cat
-    );
-  }
-
   // Filter by parent class
   if (req.query.parent) {
     const parent = req.query.parent.toLowerCase();
@@ -131,6 +170,13 @@ router.get("/search", async (req, res) => {
 
 // GET /items/categories - list all categories
 router.get("/categories", async (req, res) => {
+  // The index alone answers this, no shard needs to be loaded
+  const index = await loadIndex();
+  if (index) {
+    const categories = index.categories.map(c => c.category).sort();
+    return res.json({ count: categories.length, categories });
+  }
+
   if (!itemsCache) {
     await loadItems();
   }
@@ -144,14 +190,12 @@ router.get("/categories", async (req, res) => {
 
 // GET /items/:className - single item by class name
 router.get("/:className", async (req, res) => {
-  if (!itemsCache) {
-    await loadItems();
-  }
-  if (!itemsCache) {
+  const items = await getItems();
+  if (!items) {
     return res.status(404).json({ error: "Items not found" });
   }
 
-  const item = itemsCache.items.find(
+  const item = items.find(
     i => i.className.toLowerCase() === req.params.className.toLowerCase()
   );
 
@@ -173,35 +217,32 @@ router.post("/refresh", async (req, res) => {
 });
 
 // Helper to recursively count items in inventory (including cargo/attachments)
-// Uses itemsCache to check if items are stackable - only count quantity for stackable items
-function countItemsInInventory(items, counts) {
+// stackable is a Set of lower-case class names - only count quantity for stackable items
+function countItemsInInventory(items, counts, stackable) {
   if (!items || !Array.isArray(items)) return;
   
   for (const item of items) {
     const className = item.className?.toLowerCase();
     if (className) {
-      // Check if this item is stackable by looking it up in itemsCache
+      // Check if this item is stackable (canBeStacked in the catalog)
       // Stackable items (like ammo, rags) have canBeStacked=1, use quantity as count
       // Non-stackable items use quantity for freshness/condition, count as 1
       let countToAdd = 1;
       
-      if (itemsCache?.items) {
-        const itemDef = itemsCache.items.find(i => i.className.toLowerCase() === className);
-        if (itemDef && itemDef.canBeStacked === 1 && item.quantity) {
-          // Stackable item - use quantity as count
-          countToAdd = item.quantity;
-        }
+      if (stackable.has(className) && item.quantity) {
+        // Stackable item - use quantity as count
+        countToAdd = item.quantity;
       }
       
       counts[className] = (counts[className] || 0) + countToAdd;
     }
     // Check nested cargo
     if (item.cargo) {
-      countItemsInInventory(item.cargo, counts);
+      countItemsInInventory(item.cargo, counts, stackable);
     }
     // Check attachments
     if (item.attachments) {
-      countItemsInInventory(item.attachments, counts);
+      countItemsInInventory(item.attachments, counts, stackable);
     }
   }
 }
@@ -209,10 +250,12 @@ function countItemsInInventory(items, counts) {
 // Load inventory counts from all player inventories
 async function loadInventoryCounts() {
   try {
-    // Ensure items are loaded so we can check stackability
-    if (!itemsCache) {
-      await loadItems();
-    }
+    // Stackable class names, for quantity-based counting
+    const stackable = new Set(
+      ((await getItems()) || [])
+        .filter(i => i.canBeStacked === 1 || i.canBeStacked === true)
+        .map(i => i.className.toLowerCase())
+    );
     
     const files = await readdir(paths.inventories);
     const jsonFiles = files.filter(f => f.endsWith(".json"));
@@ -222,17 +265,17 @@ async function loadInventoryCounts() {
     
     for (const file of jsonFiles) {
       try {
-        const content = await readFile(`${paths.inventories}/${file}`, "utf8");
-        const data = JSON.parse(content);
+        const playerId = file.replace(/\.json$/, "");
+        const data = await readSnapshot("inventories", playerId, `${paths.inventories}/${file}`);
         
         // Handle both single player and multi-player inventory formats
         if (data.players) {
           for (const player of data.players) {
-            countItemsInInventory(player.inventory, counts);
+            countItemsInInventory(player.inventory, counts, stackable);
             playerCount++;
           }
         } else if (data.inventory) {
-          countItemsInInventory(data.inventory, counts);
+          countItemsInInventory(data.inventory, counts, stackable);
           playerCount++;
         }
       } catch (err) {
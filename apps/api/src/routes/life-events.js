@@ -17,6 +17,8 @@
  * 
  * DATA FILES:
  * Location: {LIFE_EVENTS_PATH}/{playerId}_life.json
+ * The server-wide lists (/ and /deaths/recent) tail the mod's event stream
+ * ({HISTORY_PATH}/stream) and only scan the per-player files while it does not exist.
  * 
  * LIFE EVENT STRUCTURE:
  * {
@@ -43,9 +45,38 @@
 import { Router } from "express";
 import { readFile, readdir } from "../storage/fs.js";
 import { paths } from "../config.js";
+import { newestFirst } from "../utils/timestamps.js";
+import { createEventFeed } from "../utils/eventStream.js";
 
 const router = Router();
 
+// Newest life events from the server-wide stream
+const lifeFeed = createEventFeed({ accept: r => r.stream === "life", capacity: 5000 });
+
+// All players' life events, newest first
+async function loadAllLifeEvents() {
+  if (await lifeFeed.refresh()) {
+    return lifeFeed.items();
+  }
+
+  // Stream not written yet (older mod build): merge the per-player files
+  const files = await readdir(paths.lifeEvents);
+  const lifeFiles = files.filter(f => f.endsWith("_life.json"));
+  
+  const allEvents = [];
+  
+  for (const file of lifeFiles) {
+    try {
+      const data = JSON.parse(await readFile(`${paths.lifeEvents}/${file}`, "utf8"));
+      if (data.events) {
+        allEvents.push(...data.events);
+      }
+    } catch {}
+  }
+
+  return allEvents.sort(newestFirst);
+}
+
 // GET /life-events/:playerId - get life events for a player
 router.get("/:playerId", async (req, res) => {
   try {
@@ -60,22 +91,8 @@ router.get("/:playerId", async (req, res) => {
 // GET /life-events - get all players' life events
 router.get("/", async (req, res) => {
   try {
-    const files = await readdir(paths.lifeEvents);
-    const lifeFiles = files.filter(f => f.endsWith("_life.json"));
-    
-    const allEvents = [];
-    
-    for (const file of lifeFiles) {
-      try {
-        const data = JSON.parse(await readFile(`${paths.lifeEvents}/${file}`, "utf8"));
-        if (data.events) {
-          allEvents.push(...data.events);
-        }
-      } catch {}
-    }
-
-    // Sort by timestamp descending (newest first)
-    allEvents.sort((a, b) => new Date(b.timestamp) - new Date(a.timestamp));
+    // Newest first
+    const allEvents = await loadAllLifeEvents();
 
     // Apply filters
     let results = allEvents;
@@ -107,22 +124,8 @@ router.get("/", async (req, res) => {
 // GET /life-events/deaths/recent - get recent deaths
 router.get("/deaths/recent", async (req, res) => {
   try {
-    const files = await readdir(paths.lifeEvents);
-    const lifeFiles = files.filter(f => f.endsWith("_life.json"));
-    
-    const deaths = [];
-    
-    for (const file of lifeFiles) {
-      try {
-        const data = JSON.parse(await readFile(`${paths.lifeEvents}/${file}`, "utf8"));
-        if (data.events) {
-          deaths.push(...data.events.filter(e => e.eventType === "DIED"));
-        }
-      } catch {}
-    }
-
-    // Sort by timestamp descending
-    deaths.sort((a, b) => new Date(b.timestamp) - new Date(a.timestamp));
+    // Newest first
+    const deaths = (await loadAllLifeEvents()).filter(e => e.eventType === "DIED");
 
     const limit = parseInt(req.query.limit) || 20;
     
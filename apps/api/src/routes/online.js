@@ -16,8 +16,14 @@
  * - GET /:id       - Get specific player details
  * 
  * DATA SOURCE:
- * Reads from: {SST_PATH}/SST/player_tracker.json
+ * Reads the "online_players" snapshot via utils/snapshots.js
+ * (falls back to {SST_PATH}/api/online_players.json)
  * Updated by: DayZ mod on player connect/disconnect/update
+ *
+ * online_players only holds players that are currently online. Disconnected
+ * players (last known state, bounded to the most recent few hundred) are read
+ * from the "player_registry" snapshot, which the mod writes about once a minute.
+ * GET / and GET /:playerId merge both; /active and /locations/all do not.
  * 
  * PLAYER DATA STRUCTURE:
  * {
@@ -41,7 +47,7 @@
  */
 import express from 'express';
 import { paths } from '../config.js';
-import { readFile } from "../storage/fs.js";
+import { readSnapshot } from "../utils/snapshots.js";
 
 const router = express.Router();
 
@@ -64,15 +70,15 @@ function transformPlayer(p) {
     water: p.water || 0,
     energy: p.energy || 0,
     isAlive: p.isAlive === 1 || p.isAlive === true,
-    isUnconscious: p.isUnconscious === 1 || p.isUnconscious === true
+    isUnconscious: p.isUnconscious === 1 || p.isUnconscious === true,
+    inVehicle: p.inVehicle === 1 || p.inVehicle === true
   };
 }
 
 // Helper function to read online players file
 async function getOnlinePlayers() {
   try {
-    const data = await readFile(paths.onlinePlayers, "utf-8");
-    return JSON.parse(data);
+    return await readSnapshot("api", "online_players", paths.onlinePlayers);
   } catch (error) {
     if (error.code === 'ENOENT') {
       return { generatedAt: null, onlineCount: 0, players: [] };
@@ -81,14 +87,42 @@ async function getOnlinePlayers() {
   }
 }
 
+// Helper function to read the registry of disconnected players
+async function getPlayerRegistry() {
+  try {
+    return await readSnapshot("api", "player_registry", `${paths.api}/player_registry.json`);
+  } catch (error) {
+    if (error.code === 'ENOENT') {
+      return { generatedAt: null, playerCount: 0, players: [] };
+    }
+    throw error;
+  }
+}
+
+// Online players first, then registry players that are not online (most recent disconnect first)
+async function getAllPlayers() {
+  const [online, registry] = await Promise.all([getOnlinePlayers(), getPlayerRegistry()]);
+  const onlinePlayers = online.players || [];
+  const onlineIds = new Set(onlinePlayers.map(p => p.playerId));
+  const offlinePlayers = (registry.players || [])
+    .filter(p => !onlineIds.has(p.playerId))
+    .reverse();
+
+  return {
+    generatedAt: online.generatedAt,
+    onlineCount: online.onlineCount ?? onlinePlayers.length,
+    players: onlinePlayers.concat(offlinePlayers)
+  };
+}
+
 // GET /online - Get all players (online and offline)
 router.get('/', async (req, res) => {
   try {
-    const data = await getOnlinePlayers();
+    const data = await getAllPlayers();
     res.json({
       generatedAt: data.generatedAt,
       onlineCount: data.onlineCount,
-      players: (data.players || []).map(transformPlayer)
+      players: data.players.map(transformPlayer)
     });
   } catch (error) {
     res.status(500).json({ error: 'Failed to read online players', details: error.message });
@@ -116,9 +150,9 @@ router.get('/active', async (req, res) => {
 router.get('/:playerId', async (req, res) => {
   try {
     const { playerId } = req.params;
-    const data = await getOnlinePlayers();
+    const data = await getAllPlayers();
     
-    const player = (data.players || []).find(p => p.playerId === playerId);
+    const player = data.players.find(p => p.playerId === playerId);
     
     if (!player) {
       return res.status(404).json({ error: 'Player not found in tracking data' });
@@ -39,7 +39,7 @@
  * 4. Archive old data to prevent database bloat (see archiveDb.js)
  */
 import express from 'express';
-import { readFile } from "../storage/fs.js";
+import { readSnapshot } from "../utils/snapshots.js";
 import { positionDb } from '../db/database.js';
 import { paths } from '../config.js';
 
@@ -136,8 +136,7 @@ router.post('/record', async (req, res) => {
 router.post('/snapshot', async (req, res) => {
   try {
     // Read current online players
-    const data = await readFile(paths.onlinePlayers, "utf-8");
-    const onlineData = JSON.parse(data);
+    const onlineData = await readSnapshot("api", "online_players", paths.onlinePlayers);
     
     if (!onlineData.players || onlineData.players.length === 0) {
       return res.json({ success: true, message: 'No players online to snapshot', count: 0 });
@@ -156,11 +155,13 @@ router.post('/snapshot', async (req, res) => {
         blood: p.blood,
         isAlive: p.isAlive === 1 || p.isAlive === true,
         isUnconscious: p.isUnconscious === 1 || p.isUnconscious === true,
+        inVehicle: p.inVehicle === 1 || p.inVehicle === true,
         recordedAt: onlineData.generatedAt || new Date().toISOString()
       }));
     
+    // Manual snapshots record every online player, bypassing adaptive sampling
     if (positions.length > 0) {
-      positionDb.recordPositionsBatch(positions);
+      positionDb.recordPositionsBatch(positions, { force: true });
     }
     
     res.json({ 
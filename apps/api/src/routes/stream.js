@@ -0,0 +1,55 @@
+/**
+ * @file stream.js
+ * @description Server-wide activity feed from the mod's sequence-numbered event stream
+ * 
+ * Every inventory, life and trade event is appended to one stream with a
+ * global sequence number. Clients poll with the last `seq` they saw and only
+ * get what is new, instead of the API merging every player's log files.
+ * 
+ * ENDPOINTS:
+ * - GET / - Latest records, or records after a sequence number
+ * 
+ * QUERY:
+ * - since  - Last seq the caller has; omit for the latest records
+ * - limit  - Max records (default 100, max 1000)
+ * - type   - Only return one event type: inventory, life or trade.
+ *            lastSeq still advances over records of other types.
+ * 
+ * RESPONSE:
+ * { records: [{ seq, stream, ...event }], lastSeq, hasMore, reset }
+ * `reset` is true when records after `since` were already removed by retention.
+ * 
+ * DATA FILES:
+ * Location: {HISTORY_PATH}/stream/index.<0|1>.json + *.ndjson
+ */
+import { Router } from "express";
+import { EVENT_STREAM_TYPES, readEventStream } from "../utils/eventStream.js";
+
+const router = Router();
+
+router.get("/", async (req, res) => {
+  try {
+    const limit = Math.min(Math.max(parseInt(req.query.limit) || 100, 1), 1000);
+    const since = req.query.since !== undefined ? Math.max(parseInt(req.query.since) || 0, 0) : undefined;
+    const type = typeof req.query.type === "string" ? req.query.type.toLowerCase() : undefined;
+    if (type && !EVENT_STREAM_TYPES.includes(type)) {
+      return res.status(400).json({ error: `Unknown type, expected one of: ${EVENT_STREAM_TYPES.join(", ")}` });
+    }
+
+    const result = await readEventStream({ since, limit });
+    if (!result.available) {
+      return res.status(404).json({ error: "Event stream not written yet" });
+    }
+
+    res.json({
+      records: type ? result.records.filter(r => r.stream === type) : result.records,
+      lastSeq: result.lastSeq,
+      hasMore: result.hasMore,
+      reset: result.reset
+    });
+  } catch (error) {
+    res.status(500).json({ error: "Failed to read event stream", details: error.message });
+  }
+});
+
+export default router;
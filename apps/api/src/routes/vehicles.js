@@ -17,15 +17,24 @@
  * - GET  /vehicles/:vehicleId   - Get specific vehicle details
  * - DELETE /vehicles/:vehicleId - Queue vehicle for deletion
  * - GET  /vehicles/positions/all - Get all vehicle positions for map
- * - GET  /vehicles/purchases/all - Get vehicle purchase history
+ * - GET  /vehicles/purchases/all - Page through vehicle purchase history, newest first
+ * - GET  /vehicles/purchases/summary - Purchase totals (all time and per class)
  * - POST /vehicles/generate-key  - Generate replacement key for vehicle
  * - GET  /vehicles/key-results/all - Get key generation results
+ * - GET  /vehicles/key-results/:requestId    - Result of one key request
+ * - GET  /vehicles/delete-results/all        - Get vehicle deletion results
+ * - GET  /vehicles/delete-results/:requestId - Result of one deletion
  * 
  * DATA FILES:
- * - SST_PATH/vehicles/tracked.json   - Currently tracked vehicles
- * - SST_PATH/vehicles/purchases.json - Purchase history
- * - API_PATH/key_grants.json         - Key generation queue
- * - API_PATH/vehicle_delete.json     - Vehicle deletion queue
+ * - SST_PATH/vehicles/tracked.json   - Currently tracked vehicles (last full snapshot)
+ * - SST_PATH/snapshots/vehicles/     - "tracked" full snapshot + "tracked_delta" changes since it
+ * - SST_PATH/vehicles/purchases/      - Purchase journal (NDJSON segments)
+ * - SST_PATH/vehicles/purchases_summary.json - Purchase totals
+ * - SST_PATH/vehicles/purchases.json - Purchase history before the journal
+ * - API_PATH/spool/key_grants/       - Key generation requests
+ * - API_PATH/spool/vehicle_delete/   - Vehicle deletion requests
+ * - API_PATH/results/key_grants/     - Key generation results journal
+ * - API_PATH/results/vehicle_delete/ - Vehicle deletion results journal
  * 
  * HOW TO EXTEND:
  * 1. Add new route with router.get/post/delete()
@@ -36,11 +45,17 @@
  */
 
 import express from "express";
-import { mkdir, readFile, stat, writeFile } from "../storage/fs.js";
+import { mkdir, readFile } from "../storage/fs.js";
 import { paths } from "../config.js";
 import { joinStoragePath } from "../utils/storagePath.js";
+import { readManifest, readSnapshot } from "../utils/snapshots.js";
+import { newestFirst } from "../utils/timestamps.js";
+import { enqueueSpool, readQueueResults, readSpoolResult } from "../utils/spool.js";
+import { readNdjsonIndex, readNdjsonSegment } from "../utils/ndjson.js";
 
 const router = express.Router();
+const KEY_QUEUE = "key_grants";
+const DELETE_QUEUE = "vehicle_delete";
 
 // Helper to safely read and parse JSON files
 const safeReadJson = async (filePath, defaultValue = []) => {
@@ -56,13 +71,60 @@ const safeReadJson = async (filePath, defaultValue = []) => {
   }
 };
 
-const exists = async (filePath) => {
+// tracked.json is published by the mod as the "tracked" snapshot of the vehicles channel.
+// Between full snapshots the mod publishes "tracked_delta": every vehicle changed or removed
+// since the full generation named in baseGeneration. The merged view is kept per pair of generations.
+let mergedTracked = null;
+
+const applyTrackedDelta = async (vehicles, manifest) => {
+  const full = manifest?.entries.find(e => e.name === "tracked");
+  const deltaEntry = manifest?.entries.find(e => e.name === "tracked_delta");
+  if (!full || !deltaEntry?.file) {
+    return vehicles;
+  }
+
+  const key = `${full.generation}/${deltaEntry.generation}`;
+  if (mergedTracked?.key === key && mergedTracked.base === vehicles) {
+    return mergedTracked.vehicles;
+  }
+
+  let delta;
   try {
-    await stat(filePath);
-    return true;
+    delta = await readSnapshot("vehicles", "tracked_delta", "");
+  } catch {
+    return vehicles;
+  }
+  // A delta for an older full snapshot is already contained in it
+  if (delta?.baseGeneration !== full.generation) {
+    return vehicles;
+  }
+
+  const byId = new Map(vehicles.map(v => [v.vehicleId, v]));
+  for (const vehicle of delta.changed || []) {
+    if (vehicle?.vehicleId) byId.set(vehicle.vehicleId, vehicle);
+  }
+  for (const vehicleId of delta.removed || []) {
+    byId.delete(vehicleId);
+  }
+
+  const merged = [...byId.values()];
+  mergedTracked = { key, base: vehicles, vehicles: merged };
+  return merged;
+};
+
+const readTrackedVehicles = async () => {
+  const trackedFile = joinStoragePath(paths.sst, "vehicles", "tracked.json");
+  try {
+    const vehicles = await readSnapshot("vehicles", "tracked", trackedFile);
+    if (!Array.isArray(vehicles)) {
+      return [];
+    }
+    return await applyTrackedDelta(vehicles, await readManifest("vehicles"));
   } catch (err) {
-    if (err?.code === "ENOENT") return false;
-    throw err;
+    if (err?.code !== "ENOENT") {
+      console.error(`[Vehicles] Error reading tracked vehicles:`, err.message);
+    }
+    return [];
   }
 };
 
@@ -74,8 +136,7 @@ const ensureDirectories = async () => {
 // GET /vehicles - List all tracked vehicles
 router.get("/", async (req, res) => {
   try {
-    const trackedFile = joinStoragePath(paths.sst, "vehicles", "tracked.json");
-    const vehicles = await safeReadJson(trackedFile, []);
+    const vehicles = await readTrackedVehicles();
     
     // Ensure vehicles is an array
     const vehicleList = Array.isArray(vehicles) ? vehicles : [];
@@ -123,54 +184,123 @@ router.get("/", async (req, res) => {
 router.get("/delete-results/all", async (req, res) => {
   try {
     const resultsFile = joinStoragePath(paths.api, "vehicle_delete_results.json");
-    const data = await safeReadJson(resultsFile, { requests: [] });
+    const limit = parseInt(req.query.limit) || 50;
+    const results = await readQueueResults(DELETE_QUEUE, resultsFile, { limit });
     
     res.json({
-      results: data.requests || [],
-      count: (data.requests || []).length
+      results,
+      count: results.length
     });
   } catch (err) {
     res.status(500).json({ error: err.message });
   }
 });
 
-// GET /vehicles/purchases/all - List all vehicle purchases
+// GET /vehicles/delete-results/:requestId - One request (after /delete-results/all)
+router.get("/delete-results/:requestId", async (req, res) => {
+  try {
+    const result = await readSpoolResult(DELETE_QUEUE, req.params.requestId);
+    if (!result) {
+      return res.status(404).json({ error: "No result for this request yet" });
+    }
+    res.json(result);
+  } catch (err) {
+    res.status(500).json({ error: err.message });
+  }
+});
+
+// Closed purchase journal segments never change: their parsed records are kept, by file name
+const purchaseSegmentCache = new Map();
+
+const purchasesFolder = () => joinStoragePath(paths.sst, "vehicles", "purchases");
+
+const readPurchaseSegment = async (folder, segment, isLast) => {
+  if (isLast) {
+    return readNdjsonSegment(folder, segment, true);
+  }
+  let records = purchaseSegmentCache.get(segment.file);
+  if (!records) {
+    records = await readNdjsonSegment(folder, segment, false);
+    purchaseSegmentCache.set(segment.file, records);
+  }
+  return records;
+};
+
+// Walk the journal newest first from a "<segment>:<index>" cursor, collecting up to
+// `limit` matching purchases. nextCursor is null once nothing older matches.
+const readPurchasePage = async (segments, matches, limit, cursor) => {
+  const folder = purchasesFolder();
+
+  // Drop segments retention has deleted
+  const live = new Set(segments.map(s => s.file));
+  for (const file of purchaseSegmentCache.keys()) {
+    if (!live.has(file)) purchaseSegmentCache.delete(file);
+  }
+
+  let position = segments.length - 1;
+  let end = Infinity;
+  if (cursor) {
+    const [file, index] = String(cursor).split(":");
+    // An expired cursor segment means everything older has expired too
+    position = segments.findIndex(s => s.file === file);
+    end = parseInt(index) || 0;
+  }
+
+  const purchases = [];
+  for (; position >= 0; position--, end = Infinity) {
+    const segment = segments[position];
+    const records = await readPurchaseSegment(folder, segment, position === segments.length - 1);
+
+    for (let i = Math.min(end, records.length) - 1; i >= 0; i--) {
+      if (!matches(records[i])) continue;
+      if (purchases.length === limit) {
+        return { purchases, nextCursor: `${segment.file}:${i + 1}` };
+      }
+      purchases.push(records[i]);
+    }
+  }
+  return { purchases, nextCursor: null };
+};
+
+const readPurchaseSummary = () =>
+  safeReadJson(joinStoragePath(paths.sst, "vehicles", "purchases_summary.json"), null);
+
+// GET /vehicles/purchases/all - Vehicle purchases, newest first, one page at a time
 router.get("/purchases/all", async (req, res) => {
   try {
     await ensureDirectories();
     
-    const purchasesFile = joinStoragePath(paths.sst, "vehicles", "purchases.json");
-    const purchases = await safeReadJson(purchasesFile, []);
-    
-    // Ensure purchases is an array
-    const purchaseList = Array.isArray(purchases) ? purchases : [];
-    
     // Optional filtering
-    const { ownerId, className, limit } = req.query;
-    
-    let filtered = purchaseList;
-    
-    if (ownerId) {
-      filtered = filtered.filter(p => p.ownerId === ownerId);
-    }
-    
-    if (className) {
-      filtered = filtered.filter(p => 
-        p.vehicleClassName?.toLowerCase().includes(className.toLowerCase())
-      );
+    const { ownerId, className, cursor } = req.query;
+    const limit = Math.min(Math.max(parseInt(req.query.limit) || 100, 1), 1000);
+    const classFilter = className?.toLowerCase();
+    const matches = p =>
+      (!ownerId || p.ownerId === ownerId) &&
+      (!classFilter || p.vehicleClassName?.toLowerCase().includes(classFilter));
+    
+    const index = await readNdjsonIndex(purchasesFolder());
+    if (!index) {
+      // Mod not updated yet: the whole history is still one purchases.json array
+      const legacy = await safeReadJson(joinStoragePath(paths.sst, "vehicles", "purchases.json"), []);
+      const purchaseList = Array.isArray(legacy) ? legacy : [];
+      const filtered = purchaseList.filter(matches).sort(newestFirst).slice(0, limit);
+      return res.json({
+        purchases: filtered,
+        count: filtered.length,
+        totalPurchases: purchaseList.length,
+        nextCursor: null
+      });
     }
     
-    // Sort by timestamp descending (newest first)
-    filtered.sort((a, b) => new Date(b.timestamp) - new Date(a.timestamp));
-    
-    if (limit) {
-      filtered = filtered.slice(0, parseInt(limit));
-    }
+    const segments = index.segments || [];
+    const { purchases, nextCursor } = await readPurchasePage(segments, matches, limit, cursor);
+    const summary = await readPurchaseSummary();
     
     res.json({
-      purchases: filtered,
-      count: filtered.length,
-      totalPurchases: purchaseList.length
+      purchases,
+      count: purchases.length,
+      totalPurchases: summary?.totalPurchases ?? segments.reduce((sum, s) => sum + (s.lines || 0), 0),
+      nextCursor
     });
   } catch (err) {
     console.error(`[Vehicles] Error in GET /vehicles/purchases/all:`, err);
@@ -178,28 +308,55 @@ router.get("/purchases/all", async (req, res) => {
   }
 });
 
+// GET /vehicles/purchases/summary - Purchase totals kept by the mod
+router.get("/purchases/summary", async (req, res) => {
+  try {
+    const summary = await readPurchaseSummary();
+    if (!summary) {
+      return res.status(404).json({ error: "No vehicle purchase summary yet" });
+    }
+    res.json(summary);
+  } catch (err) {
+    console.error(`[Vehicles] Error in GET /vehicles/purchases/summary:`, err);
+    res.status(500).json({ error: err.message });
+  }
+});
+
 // GET /vehicles/key-results/all - Get key generation results
 router.get("/key-results/all", async (req, res) => {
   try {
     const resultsFile = joinStoragePath(paths.api, "key_grants_results.json");
-    const data = await safeReadJson(resultsFile, { requests: [] });
+    const limit = parseInt(req.query.limit) || 50;
+    const results = await readQueueResults(KEY_QUEUE, resultsFile, { limit });
     
     res.json({
-      results: data.requests || [],
-      count: (data.requests || []).length
+      results,
+      count: results.length
     });
   } catch (err) {
     res.status(500).json({ error: err.message });
   }
 });
 
+// GET /vehicles/key-results/:requestId - One request (after /key-results/all)
+router.get("/key-results/:requestId", async (req, res) => {
+  try {
+    const result = await readSpoolResult(KEY_QUEUE, req.params.requestId);
+    if (!result) {
+      return res.status(404).json({ error: "No result for this request yet" });
+    }
+    res.json(result);
+  } catch (err) {
+    res.status(500).json({ error: err.message });
+  }
+});
+
 // GET /vehicles/by-owner/:ownerId - Get all vehicles owned by a player
 router.get("/by-owner/:ownerId", async (req, res) => {
   try {
     const { ownerId } = req.params;
     
-    const trackedFile = joinStoragePath(paths.sst, "vehicles", "tracked.json");
-    const vehicles = await safeReadJson(trackedFile, []);
+    const vehicles = await readTrackedVehicles();
     
     const owned = vehicles.filter(v => v.ownerId === ownerId);
     
@@ -216,8 +373,7 @@ router.get("/by-owner/:ownerId", async (req, res) => {
 // GET /vehicles/positions/all - Get all vehicle positions for map display
 router.get("/positions/all", async (req, res) => {
   try {
-    const trackedFile = joinStoragePath(paths.sst, "vehicles", "tracked.json");
-    const vehicles = await safeReadJson(trackedFile, []);
+    const vehicles = await readTrackedVehicles();
     
     // Extract just position data for map display
     const positions = vehicles
@@ -228,6 +384,8 @@ router.get("/positions/all", async (req, res) => {
         displayName: v.vehicleDisplayName,
         position: v.lastPosition,
         lastUpdate: v.lastUpdateTime,
+        // Trackers before lastSeenTime updated lastUpdateTime on every pass
+        lastSeen: v.lastSeenTime || v.lastUpdateTime,
         ownerName: v.ownerName,
         ownerId: v.ownerId
       }));
@@ -251,8 +409,7 @@ router.get("/:vehicleId", async (req, res) => {
   try {
     const { vehicleId } = req.params;
     
-    const trackedFile = joinStoragePath(paths.sst, "vehicles", "tracked.json");
-    const vehicles = await safeReadJson(trackedFile, []);
+    const vehicles = await readTrackedVehicles();
     
     if (vehicles.length === 0) {
       return res.status(404).json({ error: "No vehicles tracked yet" });
@@ -286,14 +443,8 @@ router.delete("/:vehicleId", async (req, res) => {
     }
     
     // Check if vehicle exists in tracked list
-    const trackedFile = joinStoragePath(paths.sst, "vehicles", "tracked.json");
-    let vehicleInfo = null;
-    
-    if (await exists(trackedFile)) {
-      const content = await readFile(trackedFile, "utf8");
-      const vehicles = JSON.parse(content);
-      vehicleInfo = vehicles.find(v => v.vehicleId === vehicleId);
-    }
+    const vehicles = await readTrackedVehicles();
+    const vehicleInfo = vehicles.find(v => v.vehicleId === vehicleId) || null;
     
     if (!vehicleInfo) {
       return res.status(404).json({ error: "Vehicle not found in tracking list" });
@@ -310,21 +461,7 @@ router.delete("/:vehicleId", async (req, res) => {
       requestedAt: new Date().toISOString()
     };
     
-    // Load existing queue or create new one
-    const queueFile = joinStoragePath(paths.api, "vehicle_delete.json");
-    let queue = { requests: [] };
-    
-    if (await exists(queueFile)) {
-      try {
-        const content = await readFile(queueFile, "utf8");
-        queue = JSON.parse(content);
-      } catch {}
-    }
-    
-    queue.requests.push(request);
-    
-    // Save queue
-    await writeFile(queueFile, JSON.stringify(queue, null, 2), "utf8");
+    await enqueueSpool(DELETE_QUEUE, request);
     
     console.log(`[Vehicles] Vehicle deletion queued: ${request.requestId} for ${vehicleId}`);
     
@@ -365,8 +502,7 @@ router.post("/generate-key", async (req, res) => {
     }
     
     // Check if vehicle exists in tracked list
-    const trackedFile = joinStoragePath(paths.sst, "vehicles", "tracked.json");
-    const vehicles = await safeReadJson(trackedFile, []);
+    const vehicles = await readTrackedVehicles();
     const vehicle = vehicles.find(v => v.vehicleId === vehicleId);
     
     if (!vehicle) {
@@ -384,15 +520,7 @@ router.post("/generate-key", async (req, res) => {
       result: null
     };
     
-    // Load existing queue or create new one
-    const queueFile = joinStoragePath(paths.api, "key_grants.json");
-    const queue = await safeReadJson(queueFile, { requests: [] });
-    if (!queue.requests) queue.requests = [];
-    
-    queue.requests.push(request);
-    
-    // Save queue
-    await writeFile(queueFile, JSON.stringify(queue, null, 2), "utf8");
+    await enqueueSpool(KEY_QUEUE, request);
     
     console.log(`[Vehicles] Key generation queued: ${request.requestId} for vehicle ${vehicleId}`);
     
@@ -38,10 +38,10 @@ import cookieParser from "cookie-parser";
 import { existsSync } from "fs";
 import { join, dirname } from "path";
 import { fileURLToPath } from "url";
-import { readFile, stat, getStorageBackend } from "./storage/fs.js";
+import { stat, getStorageBackend } from "./storage/fs.js";
 
 import { requireApiKey, getApiKey, getApiKeyMeta } from "./middleware/auth.js";
-import { positionDb } from "./db/database.js";
+import { positionDb, samplingConfig } from "./db/database.js";
 import { initArchiveDb, scheduleArchive } from "./db/archiveDb.js";
 import { paths, features, logConfig } from "./config.js";
 import { initAuthDb } from "./auth/authDb.js";
@@ -51,6 +51,7 @@ import authRoutes from "./auth/authRoutes.js";
 import userRoutes from "./auth/userRoutes.js";
 import setupRoutes from "./routes/setup.js";
 import { consoleUi } from "./utils/consoleUi.js";
+import { readManifest, readSnapshot } from "./utils/snapshots.js";
 import inventoryRoutes from "./routes/inventory.js";
 import eventRoutes from "./routes/events.js";
 import lifeEventRoutes from "./routes/life-events.js";
@@ -66,6 +67,8 @@ import logsRoutes from "./routes/logs.js";
 import positionsRoutes from "./routes/positions.js";
 import archiveRoutes from "./routes/archive.js";
 import vehiclesRoutes from "./routes/vehicles.js";
+import historyRoutes from "./routes/history.js";
+import streamRoutes from "./routes/stream.js";
 
 const app = express();
 const PORT = process.env.PORT || 3001;
@@ -213,6 +216,8 @@ app.use("/logs", requireAuth, requireApiKey, logsRoutes);
 app.use("/positions", requireAuth, requireApiKey, positionsRoutes);
 app.use("/archive", requireAuth, requireApiKey, archiveRoutes);
 app.use("/vehicles", requireAuth, requireApiKey, vehiclesRoutes);
+app.use("/history", requireAuth, requireApiKey, historyRoutes);
+app.use("/stream", requireAuth, requireApiKey, streamRoutes);
 
 // SPA fallback: serve index.html for any non-API routes (client-side routing)
 if (existsSync(webDistPath)) {
@@ -228,17 +233,29 @@ if (existsSync(webDistPath)) {
 // Position tracking interval (capture player positions every 30 seconds)
 const POSITION_TRACKING_INTERVAL = parseInt(process.env.POSITION_TRACKING_INTERVAL) || 30000;
 
+// Generation + hash of the online_players snapshot positions were last captured from
+let lastCapturedSnapshot = null;
+let lastCaptureAt = 0;
+
+// Capture positions from each new online_players snapshot the mod publishes. The timer
+// only polls the (cached) manifest; an unchanged snapshot is skipped until maxIdleMs
+// has passed, so idle players still get their periodic row.
 async function capturePlayerPositions() {
   try {
-    const data = await readFile(paths.onlinePlayers, "utf-8");
-    const onlineData = JSON.parse(data);
-    
-    if (!onlineData.players || onlineData.players.length === 0) {
+    const manifest = await readManifest("api");
+    const entry = manifest?.entries.find(e => e.name === "online_players");
+    const snapshotVersion = entry ? `${entry.generation}:${entry.hash}` : null;
+    const now = Date.now();
+    if (snapshotVersion && snapshotVersion === lastCapturedSnapshot && now - lastCaptureAt < samplingConfig.maxIdleMs) {
       return;
     }
+
+    const onlineData = await readSnapshot("api", "online_players", paths.onlinePlayers);
+    lastCapturedSnapshot = snapshotVersion;
+    lastCaptureAt = now;
     
     // Filter to only online players
-    const positions = onlineData.players
+    const positions = (onlineData.players || [])
       .filter(p => p.isOnline === 1 || p.isOnline === true)
       .map(p => ({
         playerId: p.playerId,
@@ -250,12 +267,18 @@ async function capturePlayerPositions() {
         blood: p.blood,
         isAlive: p.isAlive === 1 || p.isAlive === true,
         isUnconscious: p.isUnconscious === 1 || p.isUnconscious === true,
+        inVehicle: p.inVehicle === 1 || p.inVehicle === true,
         recordedAt: onlineData.generatedAt || new Date().toISOString()
       }));
     
+    // Also when nobody is online, so players who left do not stay in the sampling state
+    positionDb.forgetOfflinePlayers(positions.map(p => p.playerId));
+    
     if (positions.length > 0) {
-      positionDb.recordPositionsBatch(positions);
-      console.log(`[Position Tracker] Recorded ${positions.length} player positions`);
+      const recorded = positionDb.recordPositionsBatch(positions);
+      if (recorded > 0) {
+        console.log(`[Position Tracker] Recorded ${recorded} of ${positions.length} player positions`);
+      }
     }
   } catch (error) {
     if (error.code !== 'ENOENT') {
@@ -264,8 +287,10 @@ async function capturePlayerPositions() {
   }
 }
 
-// Start position tracking
-setInterval(capturePlayerPositions, POSITION_TRACKING_INTERVAL);
+// Start position tracking. The timer runs at the faster of the two intervals and
+// only reads the snapshot when the mod published a new one; recordPositionsBatch()
+// decides per player whether a row is due.
+setInterval(capturePlayerPositions, Math.min(POSITION_TRACKING_INTERVAL, samplingConfig.fastInterval || POSITION_TRACKING_INTERVAL));
 
 // Initialize auth database and start server
 async function startServer() {
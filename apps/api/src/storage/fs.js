@@ -8,6 +8,11 @@ export async function readFile(filePath, encoding) {
   return storage.readFile(filePath, encoding);
 }
 
+// Bytes [start, start + length) of a file as a Buffer; to the end if length is omitted
+export async function readFileRange(filePath, start, length) {
+  return storage.readFileRange(filePath, start, length);
+}
+
 export async function writeFile(filePath, data, encoding) {
   return storage.writeFile(filePath, data, encoding);
 }
@@ -28,6 +33,10 @@ export async function unlink(filePath) {
   return storage.unlink(filePath);
 }
 
+export async function rename(oldPath, newPath) {
+  return storage.rename(oldPath, newPath);
+}
+
 export function getStorageBackend() {
   return storage.backend;
 }
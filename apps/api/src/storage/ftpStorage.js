@@ -89,6 +89,47 @@ export function createFtpStorage({ backend, config }) {
       }
     },
 
+    async readFileRange(filePath, start, length) {
+      const remotePath = resolveRemotePath(remoteRoot, filePath);
+      const chunks = [];
+      if (length !== undefined && length <= 0) return Buffer.alloc(0);
+
+      try {
+        return await withClient(async (client) => {
+          let received = 0;
+          let aborted = false;
+          const writable = new Writable({
+            write(chunk, _enc, cb) {
+              chunks.push(Buffer.from(chunk));
+              received += chunk.length;
+              // Enough bytes: stop the transfer instead of pulling the rest of the file
+              if (length !== undefined && received >= length && !aborted) {
+                aborted = true;
+                client.close();
+              }
+              cb();
+            }
+          });
+
+          // REST: the server starts the transfer at the byte offset
+          try {
+            await client.downloadTo(writable, remotePath, start);
+          } catch (error) {
+            if (!aborted) throw error;
+          }
+          const buffer = Buffer.concat(chunks);
+          return length === undefined ? buffer : buffer.subarray(0, length);
+        });
+      } catch (error) {
+        if (isNotFoundFtpError(error)) {
+          const err = new Error(`ENOENT: no such file or directory, open '${remotePath}'`);
+          err.code = "ENOENT";
+          throw err;
+        }
+        throw error;
+      }
+    },
+
     async writeFile(filePath, data, encoding) {
       const remotePath = resolveRemotePath(remoteRoot, filePath);
       const remoteDir = path.posix.dirname(toPosixPath(remotePath));
@@ -181,6 +222,25 @@ export function createFtpStorage({ backend, config }) {
         }
         throw error;
       }
+    },
+
+    // Same-directory renames are atomic on the server, which the command spool relies on
+    async rename(oldPath, newPath) {
+      const remoteOld = resolveRemotePath(remoteRoot, oldPath);
+      const remoteNew = resolveRemotePath(remoteRoot, newPath);
+
+      try {
+        return await withClient(async (client) => {
+          await client.rename(remoteOld, remoteNew);
+        });
+      } catch (error) {
+        if (isNotFoundFtpError(error)) {
+          const err = new Error(`ENOENT: no such file or directory, rename '${remoteOld}'`);
+          err.code = "ENOENT";
+          throw err;
+        }
+        throw error;
+      }
     }
   };
 }
@@ -9,6 +9,20 @@ export function createLocalStorage() {
       return fsp.readFile(filePath, encoding);
     },
 
+    async readFileRange(filePath, start, length) {
+      const handle = await fsp.open(filePath, "r");
+      try {
+        if (length === undefined) {
+          length = Math.max(0, (await handle.stat()).size - start);
+        }
+        const buffer = Buffer.alloc(length);
+        const { bytesRead } = await handle.read(buffer, 0, length, start);
+        return buffer.subarray(0, bytesRead);
+      } finally {
+        await handle.close();
+      }
+    },
+
     async writeFile(filePath, data, encoding) {
       return fsp.writeFile(filePath, data, encoding);
     },
@@ -27,5 +41,8 @@ export function createLocalStorage() {
     async unlink(filePath) {
       return fsp.unlink(filePath);
     },
+    async rename(oldPath, newPath) {
+      return fsp.rename(oldPath, newPath);
+    },
   };
 }
@@ -70,6 +70,29 @@ export function createSftpStorage({ backend, config }) {
       }
     },
 
+    async readFileRange(filePath, start, length) {
+      const remotePath = resolveRemotePath(remoteRoot, filePath);
+      const readStreamOptions = { start };
+      if (length !== undefined) {
+        if (length <= 0) return Buffer.alloc(0);
+        readStreamOptions.end = start + length - 1;
+      }
+
+      try {
+        const buffer = await withClient(connectOptions, (client) =>
+          client.get(remotePath, undefined, { readStreamOptions })
+        );
+        return Buffer.from(buffer);
+      } catch (error) {
+        if (isNotFoundSftpError(error)) {
+          const err = new Error(`ENOENT: no such file or directory, open '${remotePath}'`);
+          err.code = "ENOENT";
+          throw err;
+        }
+        throw error;
+      }
+    },
+
     async writeFile(filePath, data, encoding) {
       const remotePath = resolveRemotePath(remoteRoot, filePath);
       const remoteDir = path.posix.dirname(toPosixPath(remotePath));
@@ -142,6 +165,25 @@ export function createSftpStorage({ backend, config }) {
         }
         throw error;
       }
+    },
+
+    // Same-directory renames are atomic on the server, which the command spool relies on
+    async rename(oldPath, newPath) {
+      const remoteOld = resolveRemotePath(remoteRoot, oldPath);
+      const remoteNew = resolveRemotePath(remoteRoot, newPath);
+
+      try {
+        return await withClient(connectOptions, async (client) => {
+          await client.rename(remoteOld, remoteNew);
+        });
+      } catch (error) {
+        if (isNotFoundSftpError(error)) {
+          const err = new Error(`ENOENT: no such file or directory, rename '${remoteOld}'`);
+          err.code = "ENOENT";
+          throw err;
+        }
+        throw error;
+      }
     }
   };
 }
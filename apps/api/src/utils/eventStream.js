@@ -0,0 +1,167 @@
+/**
+ * @file eventStream.js
+ * @description Reader for the mod's server-wide, sequence-numbered event stream
+ *
+ * Every inventory, life and trade event the mod records is also appended to
+ * one NDJSON log:
+ *
+ *   {SST_PATH}/history/stream/index.<0|1>.json
+ *   {SST_PATH}/history/stream/00000001.ndjson
+ *
+ *   {"seq":1042,"stream":"life","event":{...}}
+ *
+ * `seq` grows by one per record across all event types. The segment index
+ * carries firstSeq/lastSeq, so "everything after seq N" starts in a known
+ * segment instead of a scan over every player's files. Records are returned
+ * flattened: { seq, stream, ...event }.
+ *
+ * EXPORTS:
+ * - EVENT_STREAM_TYPES            - "inventory", "life", "trade"
+ * - readEventStream(options)      - Records after a sequence number, or the latest records
+ * - createEventFeed(options)      - In-memory tail of the stream for route caches
+ */
+import { paths } from "../config.js";
+import { joinStoragePath } from "./storagePath.js";
+import { readNdjson, readNdjsonIndex } from "./ndjson.js";
+
+export const EVENT_STREAM_TYPES = ["inventory", "life", "trade"];
+
+// Byte cursors of recently returned sequence numbers, so a poller's next read
+// starts where the previous one ended instead of at the segment start
+const CURSOR_CACHE_SIZE = 256;
+const cursorsBySeq = new Map();
+
+function streamFolder() {
+  return joinStoragePath(paths.history, "stream");
+}
+
+function rememberCursor(seq, cursor) {
+  if (!cursor?.segment) return;
+  cursorsBySeq.delete(seq);
+  cursorsBySeq.set(seq, cursor);
+  if (cursorsBySeq.size > CURSOR_CACHE_SIZE) {
+    cursorsBySeq.delete(cursorsBySeq.keys().next().value);
+  }
+}
+
+function flatten(record) {
+  return { seq: record.seq, stream: record.stream, ...(record.event || {}) };
+}
+
+/**
+ * Read stream records.
+ *
+ * With `since` returns up to `limit` records with seq > since, oldest first.
+ * Without it returns the latest `limit` records.
+ *
+ * `reset` is true when records after `since` were already removed by retention
+ * (the caller missed some). `available` is false until the mod has written the
+ * stream at least once.
+ *
+ * @param {{ since?: number, limit?: number }} options
+ * @returns {Promise<{ records: object[], lastSeq: number, hasMore: boolean, reset: boolean, available: boolean }>}
+ */
+export async function readEventStream({ since, limit = 100 } = {}) {
+  const folder = streamFolder();
+  const index = await readNdjsonIndex(folder);
+  const segments = index?.segments || [];
+  const available = index !== null;
+
+  if (since === undefined || since === null) {
+    const latest = await readNdjson(folder, segments, { limit });
+    const records = latest.records.map(flatten);
+    const lastSeq = records.length > 0 ? records[records.length - 1].seq : 0;
+    rememberCursor(lastSeq, latest.cursor);
+    return { records, lastSeq, hasMore: false, reset: false, available };
+  }
+
+  if (segments.length === 0) {
+    return { records: [], lastSeq: since, hasMore: false, reset: false, available };
+  }
+
+  // Records between `since` and the oldest remaining segment are gone
+  const oldestSeq = segments[0].firstSeq || 0;
+  const reset = oldestSeq > since + 1;
+
+  let cursor = cursorsBySeq.get(since);
+  if (!cursor || !segments.some(s => s.file === cursor.segment)) {
+    // First segment that can hold seq > since; the last one's lastSeq may lag behind its file
+    const start = segments.find(s => (s.lastSeq || 0) > since) || segments[segments.length - 1];
+    cursor = { segment: start.file, offset: 0 };
+  }
+
+  const records = [];
+  let hasMore = true;
+  while (records.length < limit && hasMore) {
+    const page = await readNdjson(folder, segments, { ...cursor, limit: limit - records.length });
+    for (const record of page.records) {
+      // Records up to `since` are only read when starting at a segment boundary
+      if (record.seq > since) records.push(flatten(record));
+    }
+    hasMore = page.hasMore;
+    if (page.records.length === 0) break;
+    cursor = page.cursor;
+  }
+
+  const lastSeq = records.length > 0 ? records[records.length - 1].seq : since;
+  rememberCursor(lastSeq, cursor);
+  return { records, lastSeq, hasMore, reset, available };
+}
+
+/**
+ * Keep the newest `capacity` stream records that pass `accept`, updated
+ * incrementally on each refresh(). The first refresh replays the whole
+ * retained stream. `onRecord`, if given, sees every new record once, whether
+ * accepted or not (for running aggregates that need no stored records).
+ *
+ * @param {{ accept?: (record: object) => boolean, capacity?: number, onRecord?: (record: object) => void }} options
+ */
+export function createEventFeed({ accept = () => true, capacity = 1000, onRecord } = {}) {
+  let lastSeq = 0;
+  let items = [];
+  let available = false;
+  let inFlight = null;
+
+  async function pull() {
+    let result;
+    do {
+      result = await readEventStream({ since: lastSeq, limit: 1000 });
+      available = result.available;
+      for (const record of result.records) {
+        if (onRecord) onRecord(record);
+        if (accept(record)) items.push(record);
+      }
+      lastSeq = result.lastSeq;
+      if (items.length > capacity) {
+        items = items.slice(-capacity);
+      }
+    } while (result.hasMore && result.records.length > 0);
+
+    return available;
+  }
+
+  return {
+    // Read new records; resolves to false while the mod has not written the stream
+    refresh() {
+      if (!inFlight) {
+        inFlight = pull().finally(() => {
+          inFlight = null;
+        });
+      }
+      return inFlight;
+    },
+
+    get available() {
+      return available;
+    },
+
+    get lastSeq() {
+      return lastSeq;
+    },
+
+    // Newest first
+    items() {
+      return items.slice().reverse();
+    },
+  };
+}
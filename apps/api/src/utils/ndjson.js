@@ -0,0 +1,217 @@
+/**
+ * @file ndjson.js
+ * @description Reader for the mod's append-only NDJSON event history
+ *
+ * The mod appends every event (inventory, life, trade) to rotating segments:
+ *
+ *   {SST_PATH}/history/<stream>/<playerId>/index.0.json
+ *   {SST_PATH}/history/<stream>/<playerId>/index.1.json
+ *   {SST_PATH}/history/<stream>/<playerId>/00000001.ndjson
+ *
+ * The index lists the segments in order with their byte size and line count.
+ * Saves alternate between the two slots with a revision; the newest slot that
+ * parses wins (index.json from older mod versions is the fallback).
+ * Readers keep a cursor { segment, offset } and only fetch the bytes after it
+ * (readFileRange), so polling a long history costs one small ranged read.
+ *
+ * Only complete lines are returned. A line the mod is still writing is picked
+ * up by the next call.
+ *
+ * EXPORTS:
+ * - HISTORY_STREAMS                         - Stream folder names
+ * - readHistoryIndex(stream, playerId)      - Parsed segment index or null
+ * - readHistory(stream, playerId, options)  - Records after a cursor, or the latest records
+ * - readNdjsonIndex(folder)                 - Same for any NDJSON log folder
+ * - readNdjson(folder, segments, options)   - Same for any NDJSON log folder
+ * - readNdjsonSegment(folder, segment, isLast) - Every record of one segment, oldest first
+ */
+import { readFile, readFileRange } from "../storage/fs.js";
+import { paths } from "../config.js";
+import { joinStoragePath } from "./storagePath.js";
+
+export const HISTORY_STREAMS = ["events", "life_events", "trades"];
+
+// Upper bound for one ranged read, whatever the segment size
+const MAX_READ_BYTES = 512 * 1024;
+
+function historyFolder(stream, playerId) {
+  return joinStoragePath(paths.history, stream, playerId);
+}
+
+const INDEX_FILES = ["index.0.json", "index.1.json"];
+const LEGACY_INDEX_FILE = "index.json";
+
+async function readIndexFile(folder, fileName) {
+  try {
+    const index = JSON.parse(await readFile(joinStoragePath(folder, fileName), "utf8"));
+    return Array.isArray(index.segments) ? index : null;
+  } catch (error) {
+    // Missing, or the slot the mod is writing right now
+    if (error.code === "ENOENT" || error instanceof SyntaxError) return null;
+    throw error;
+  }
+}
+
+// Newest index slot that parses; older mod versions rewrite a single index.json
+export async function readNdjsonIndex(folder) {
+  const slots = await Promise.all(INDEX_FILES.map((fileName) => readIndexFile(folder, fileName)));
+  const newest = slots
+    .filter(Boolean)
+    .reduce((best, index) => (!best || (index.revision || 0) > (best.revision || 0) ? index : best), null);
+
+  return newest || readIndexFile(folder, LEGACY_INDEX_FILE);
+}
+
+export function readHistoryIndex(stream, playerId) {
+  return readNdjsonIndex(historyFolder(stream, playerId));
+}
+
+// Parse the complete lines of a chunk. Each entry has the record and the byte
+// offset just past its line, relative to the chunk.
+function parseLines(buffer) {
+  const entries = [];
+  let lineStart = 0;
+  let lineEnd;
+  while ((lineEnd = buffer.indexOf(0x0a, lineStart)) !== -1) {
+    const line = buffer.subarray(lineStart, lineEnd).toString("utf8");
+    lineStart = lineEnd + 1;
+    if (!line.trim()) continue;
+    try {
+      entries.push({ record: JSON.parse(line), end: lineStart });
+    } catch {
+      // Skip a damaged line rather than stalling the cursor on it
+    }
+  }
+  return { entries, consumed: lineStart };
+}
+
+async function readChunk(folder, file, start, length) {
+  try {
+    return await readFileRange(joinStoragePath(folder, file), start, length);
+  } catch (error) {
+    if (error.code !== "ENOENT") throw error;
+    return Buffer.alloc(0);
+  }
+}
+
+/**
+ * Read history records.
+ *
+ * With a cursor ({ segment, offset }) returns up to `limit` records written after
+ * it, oldest first, and the cursor to continue from. Without one returns the
+ * latest `limit` records and a cursor at the current end.
+ *
+ * @param {string} stream - One of HISTORY_STREAMS
+ * @param {string} playerId - Steam64 ID
+ * @param {{ segment?: string, offset?: number, limit?: number }} options
+ * @returns {Promise<{ records: object[], cursor: { segment: string|null, offset: number }, hasMore: boolean, reset: boolean }>}
+ */
+export async function readHistory(stream, playerId, options = {}) {
+  const index = await readHistoryIndex(stream, playerId);
+  return readNdjson(historyFolder(stream, playerId), index?.segments || [], options);
+}
+
+/**
+ * readHistory for any NDJSON log folder, given its index segments.
+ *
+ * @param {string} folder - Log folder (storage path)
+ * @param {object[]} segments - index segments
+ * @param {{ segment?: string, offset?: number, limit?: number }} options
+ */
+export async function readNdjson(folder, segments, { segment, offset = 0, limit = 100 } = {}) {
+  if (segments.length === 0) {
+    return { records: [], cursor: { segment: null, offset: 0 }, hasMore: false, reset: false };
+  }
+
+  if (!segment) {
+    return readLatest(folder, segments, limit);
+  }
+
+  // The cursor's segment may have been removed by retention: restart at the oldest one
+  let position = segments.findIndex(s => s.file === segment);
+  const reset = position === -1;
+  if (reset) {
+    position = 0;
+    offset = 0;
+  }
+
+  const records = [];
+  let cursor = { segment: segments[position].file, offset };
+
+  while (records.length < limit) {
+    const current = segments[position];
+    const isLast = position === segments.length - 1;
+
+    // Closed segments are complete at their indexed size; the last one may have grown since
+    const remaining = isLast ? MAX_READ_BYTES : Math.min(Math.max(0, current.size - cursor.offset), MAX_READ_BYTES);
+    const chunk = remaining > 0 ? await readChunk(folder, current.file, cursor.offset, remaining) : Buffer.alloc(0);
+    const { entries, consumed } = parseLines(chunk);
+
+    const take = entries.slice(0, limit - records.length);
+    for (const entry of take) records.push(entry.record);
+
+    if (take.length < entries.length) {
+      cursor = { segment: current.file, offset: cursor.offset + take[take.length - 1].end };
+      return { records, cursor, hasMore: true, reset };
+    }
+
+    cursor = { segment: current.file, offset: cursor.offset + consumed };
+
+    // Segment not finished yet (capped read) - keep reading it; nothing new in the last one - done
+    if (consumed > 0 && (isLast || cursor.offset < current.size)) continue;
+    if (isLast) break;
+
+    position++;
+    cursor = { segment: segments[position].file, offset: 0 };
+  }
+
+  const last = segments[segments.length - 1];
+  const hasMore = cursor.segment !== last.file || cursor.offset < last.size;
+  return { records, cursor, hasMore, reset };
+}
+
+/**
+ * Every complete record of one segment, oldest first. Closed segments are read
+ * up to their indexed size; the last one (isLast) to its current end.
+ *
+ * @param {string} folder - Log folder (storage path)
+ * @param {object} segment - One index segment
+ * @param {boolean} isLast - Whether it is the segment being appended to
+ */
+export async function readNdjsonSegment(folder, segment, isLast) {
+  const chunk = await readChunk(folder, segment.file, 0, isLast ? undefined : segment.size);
+  return parseLines(chunk).entries.map(e => e.record);
+}
+
+// Latest `limit` records, newest segments first, with a cursor at the end of the last segment
+async function readLatest(folder, segments, limit) {
+  const collected = [];
+  let cursor = null;
+
+  for (let i = segments.length - 1; i >= 0 && collected.length < limit; i--) {
+    const current = segments[i];
+    const isLast = i === segments.length - 1;
+
+    // The last segment may have grown past its indexed size, so it is read to the end
+    const start = isLast ? 0 : Math.max(0, current.size - MAX_READ_BYTES);
+    const chunk = await readChunk(folder, current.file, start, isLast ? undefined : current.size - start);
+
+    // Keep only the tail of a large segment; drop the partial line the cut leaves at the front
+    let skipped = 0;
+    if (chunk.length > MAX_READ_BYTES) {
+      skipped = chunk.length - MAX_READ_BYTES;
+    }
+    if (start + skipped > 0) {
+      const firstBreak = chunk.indexOf(0x0a, skipped);
+      skipped = firstBreak === -1 ? chunk.length : firstBreak + 1;
+    }
+
+    const { entries, consumed } = parseLines(chunk.subarray(skipped));
+    if (isLast) {
+      cursor = { segment: current.file, offset: start + skipped + consumed };
+    }
+    collected.unshift(...entries.map(e => e.record));
+  }
+
+  return { records: collected.slice(-limit), cursor, hasMore: false, reset: false };
+}
@@ -0,0 +1,124 @@
+/**
+ * @file snapshots.js
+ * @description Reader for the mod's manifest-published snapshot generations
+ *
+ * The mod writes each snapshot into a new generation file and then updates a
+ * small manifest per channel:
+ *
+ *   {SST_PATH}/snapshots/<channel>/manifest.0.json
+ *   {SST_PATH}/snapshots/<channel>/manifest.1.json
+ *   {SST_PATH}/snapshots/<channel>/<name>.<generation>.json
+ *
+ * Manifest commits alternate between the two slots, each carrying a revision.
+ * The newest slot that parses wins, so a slot being written is never needed.
+ * Replaced generations stay on disk for a minute after they leave the manifest.
+ *
+ * Reading the manifest first means we never parse a half-written file, and we
+ * only download a snapshot again when its hash changed.
+ *
+ * CHANNELS (as written by the mod):
+ * - api         - online_players, server_items
+ * - items       - index, one shard per item category
+ * - inventories - one entry per Steam64 ID
+ * - vehicles    - tracked, tracked_delta (changes since the tracked generation it names)
+ *
+ * FALLBACK:
+ * If there is no manifest or entry (older mod version), the legacy path is read
+ * directly, exactly as before.
+ *
+ * EXPORTS:
+ * - readSnapshot(channel, name, legacyPath) - Parsed JSON of the current generation
+ * - readManifest(channel)                   - Parsed manifest or null
+ */
+import { readFile } from "../storage/fs.js";
+import { paths } from "../config.js";
+import { joinStoragePath } from "./storagePath.js";
+
+// Parsed snapshots keyed by "<channel>/<name>", evicted oldest-first
+const MAX_CACHED_SNAPSHOTS = parseInt(process.env.SNAPSHOT_CACHE_SIZE) || 500;
+const snapshotCache = new Map();
+
+// Manifests are re-read at most this often, so reading several snapshots of a
+// channel in one request costs a single manifest download
+const MANIFEST_TTL_MS = parseInt(process.env.SNAPSHOT_MANIFEST_TTL_MS) || 2000;
+const manifestCache = new Map();
+
+const MANIFEST_FILES = ["manifest.0.json", "manifest.1.json"];
+const LEGACY_MANIFEST_FILE = "manifest.json";
+
+async function readManifestFile(channel, fileName) {
+  try {
+    const raw = await readFile(joinStoragePath(paths.snapshots, channel, fileName), "utf8");
+    const manifest = JSON.parse(raw);
+    return Array.isArray(manifest.entries) ? manifest : null;
+  } catch {
+    // Missing, or the slot the mod is writing right now
+    return null;
+  }
+}
+
+async function loadManifest(channel) {
+  const slots = await Promise.all(MANIFEST_FILES.map((fileName) => readManifestFile(channel, fileName)));
+  const newest = slots
+    .filter(Boolean)
+    .reduce((best, manifest) => (!best || (manifest.revision || 0) > (best.revision || 0) ? manifest : best), null);
+
+  // Older mod versions rewrite a single manifest.json; no manifest at all falls back to the legacy path
+  return newest || readManifestFile(channel, LEGACY_MANIFEST_FILE);
+}
+
+export async function readManifest(channel) {
+  const cached = manifestCache.get(channel);
+  if (cached && Date.now() - cached.loadedAt < MANIFEST_TTL_MS) {
+    return cached.promise;
+  }
+
+  const promise = loadManifest(channel);
+  manifestCache.set(channel, { loadedAt: Date.now(), promise });
+  return promise;
+}
+
+function remember(key, entry, data) {
+  snapshotCache.delete(key);
+  snapshotCache.set(key, { hash: entry.hash, generation: entry.generation, data });
+  while (snapshotCache.size > MAX_CACHED_SNAPSHOTS) {
+    snapshotCache.delete(snapshotCache.keys().next().value);
+  }
+}
+
+async function readJson(filePath) {
+  return JSON.parse(await readFile(filePath, "utf8"));
+}
+
+/**
+ * Read the current generation of a snapshot.
+ * Throws like readFile() (e.g. ENOENT) when neither the snapshot nor the legacy file exists.
+ */
+export async function readSnapshot(channel, name, legacyPath) {
+  const manifest = await readManifest(channel);
+  const entry = manifest?.entries.find((e) => e.name === name);
+
+  if (entry?.file) {
+    const key = `${channel}/${name}`;
+    const cached = snapshotCache.get(key);
+    if (cached && cached.hash === entry.hash && cached.generation === entry.generation) {
+      return cached.data;
+    }
+
+    const dir = joinStoragePath(paths.snapshots, channel);
+    try {
+      const data = await readJson(joinStoragePath(dir, entry.file));
+      remember(key, entry, data);
+      return data;
+    } catch {
+      // Generation rotated away between manifest and file read: the previous one is still kept
+      if (entry.previousFile) {
+        try {
+          return await readJson(joinStoragePath(dir, entry.previousFile));
+        } catch {}
+      }
+    }
+  }
+
+  return readJson(legacyPath);
+}
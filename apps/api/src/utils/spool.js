@@ -0,0 +1,226 @@
+/**
+ * @file spool.js
+ * @description Command spool shared with the mod's SST_CommandSpool
+ *
+ * Each queue is a folder with one file per request instead of a JSON array
+ * that both sides rewrite:
+ *
+ *   {API_PATH}/spool/<queue>/incoming/<ms>-<requestId>.json    <- written here
+ *   {API_PATH}/spool/<queue>/processing/<name>.json            <- claimed by the mod
+ *
+ * A request is written as "<name>.json.tmp" and renamed, so the mod never
+ * reads a half-uploaded file. Nothing here reads or rewrites another request,
+ * so concurrent POSTs cannot overwrite each other.
+ *
+ * Results are appended by the mod to an NDJSON journal per queue
+ * (SST_ResultsJournal), with lookup buckets keyed by a hash of the requestId:
+ *
+ *   {API_PATH}/results/<queue>/index.<0|1>.json + 00000001.ndjson
+ *     {"file":"<name>.json","requestId":"...","completedAt":1718000000,"result":{...}}
+ *   {API_PATH}/results/<queue>/ids/<bucket>.ndjson
+ *     {"requestId":"...","segment":"00000001.ndjson","offset":1234,"length":310}
+ *
+ * The mod copies the request DTO into the result and fills in
+ * processed/status/result. Fields its DTO does not know (requestId on commands
+ * and grants, requestedAt) are not written back; results get `requestId` and
+ * `queuedAt` from the spool file name instead.
+ *
+ * EXPORTS:
+ * - enqueueSpool(queue, request)        - Queue one request, returns its requestId
+ * - readSpoolResults(queue, options)    - Latest results, newest first
+ * - readSpoolResult(queue, requestId)   - Result of one request, or null
+ * - readQueueResults(queue, legacyFile)  - Journal results followed by the pre-spool results file
+ * - listSpoolPending(queue)             - Requests not finished yet
+ */
+import { mkdir, readFile, readFileRange, readdir, rename, writeFile } from "../storage/fs.js";
+import { paths } from "../config.js";
+import { joinStoragePath } from "./storagePath.js";
+import { readNdjson, readNdjsonIndex } from "./ndjson.js";
+
+// Must match SST_ResultsJournal.ID_BUCKETS
+const ID_BUCKETS = 64;
+
+const preparedQueues = new Set();
+
+// Millisecond stamp of the last queued file, kept strictly increasing so names sort in arrival order
+let lastStamp = 0;
+
+function queueFolder(queue, stage) {
+  return joinStoragePath(paths.api, "spool", queue, stage);
+}
+
+function journalFolder(queue) {
+  return joinStoragePath(paths.api, "results", queue);
+}
+
+// Same reduction as spool file names and SST_ResultsJournal.SafeId
+function safeRequestId(requestId) {
+  return String(requestId).replace(/[^A-Za-z0-9_-]/g, "_");
+}
+
+// SST_ResultsJournal.BucketOf: h = h * 31 + char on 32-bit ints
+function bucketOf(safeId) {
+  let hash = 0;
+  for (let i = 0; i < safeId.length; i++) {
+    hash = (Math.imul(hash, 31) + safeId.charCodeAt(i)) | 0;
+  }
+  return (hash & 0x7fffffff) % ID_BUCKETS;
+}
+
+function newRequestId(prefix) {
+  return `${prefix}_${Date.now()}_${Math.random().toString(36).substr(2, 9)}`;
+}
+
+// "<ms>-<requestId>.json" -> { requestId, queuedAt }
+function parseSpoolName(name) {
+  const match = /^(\d+)-(.+)\.json$/.exec(name);
+  if (!match) return { requestId: name.replace(/\.json$/, ""), queuedAt: null };
+  return { requestId: match[2], queuedAt: new Date(Number(match[1])).toISOString() };
+}
+
+async function listJson(folder) {
+  try {
+    const names = await readdir(folder);
+    return names.filter(name => name.endsWith(".json"));
+  } catch (err) {
+    if (err.code === "ENOENT") return [];
+    throw err;
+  }
+}
+
+async function readSpoolFile(folder, name) {
+  const data = JSON.parse(await readFile(joinStoragePath(folder, name), "utf8"));
+  const { requestId, queuedAt } = parseSpoolName(name);
+  return { ...data, requestId: data.requestId || requestId, queuedAt };
+}
+
+/**
+ * Queue one request for the mod.
+ *
+ * @param {string} queue - Spool name, e.g. "player_commands"
+ * @param {object} request - Request DTO; `requestId` is generated if missing
+ * @param {string} [prefix] - Prefix for generated request ids
+ * @returns {Promise<string>} requestId
+ */
+export async function enqueueSpool(queue, request, prefix = queue) {
+  const incoming = queueFolder(queue, "incoming");
+  if (!preparedQueues.has(queue)) {
+    await mkdir(incoming, { recursive: true });
+    preparedQueues.add(queue);
+  }
+
+  const requestId = request.requestId || newRequestId(prefix);
+  lastStamp = Math.max(Date.now(), lastStamp + 1);
+  const name = `${lastStamp}-${safeRequestId(requestId)}.json`;
+  const target = joinStoragePath(incoming, name);
+
+  await writeFile(`${target}.tmp`, JSON.stringify({ ...request, requestId }, null, 2), "utf8");
+  await rename(`${target}.tmp`, target);
+  return requestId;
+}
+
+// Journal record -> the annotated request, as the API returned it from result files
+function flattenResult(record) {
+  const { queuedAt } = record.file ? parseSpoolName(record.file) : { queuedAt: null };
+  return {
+    ...(record.result || {}),
+    requestId: record.result?.requestId || record.requestId || null,
+    queuedAt,
+    completedAt: record.completedAt ? new Date(record.completedAt * 1000).toISOString() : null,
+  };
+}
+
+/**
+ * Latest results of a queue, newest first.
+ *
+ * @param {string} queue
+ * @param {{ limit?: number }} options
+ * @returns {Promise<object[]>}
+ */
+export async function readSpoolResults(queue, { limit = 50 } = {}) {
+  const folder = journalFolder(queue);
+  const index = await readNdjsonIndex(folder);
+  const { records } = await readNdjson(folder, index?.segments || [], { limit });
+  return records.reverse().map(flattenResult);
+}
+
+/**
+ * Result of one request: one read of its lookup bucket and one ranged read of
+ * the journal, whatever the size of the history.
+ *
+ * @param {string} queue
+ * @param {string} requestId - As returned by enqueueSpool (or the DTO's own requestId)
+ * @returns {Promise<object|null>} null while the request is not finished, or after retention dropped it
+ */
+export async function readSpoolResult(queue, requestId) {
+  const folder = journalFolder(queue);
+  const safeId = safeRequestId(requestId);
+  const bucket = String(bucketOf(safeId)).padStart(2, "0");
+
+  let lines;
+  try {
+    lines = (await readFile(joinStoragePath(folder, "ids", `${bucket}.ndjson`), "utf8")).split("\n");
+  } catch (err) {
+    if (err.code === "ENOENT") return null;
+    throw err;
+  }
+
+  // The newest entry wins if a requestId was reused
+  for (let i = lines.length - 1; i >= 0; i--) {
+    let entry;
+    try {
+      entry = JSON.parse(lines[i]);
+    } catch {
+      continue; // Blank or partly written line
+    }
+    if (entry.requestId !== safeId) continue;
+
+    try {
+      const chunk = await readFileRange(joinStoragePath(folder, entry.segment), entry.offset, entry.length);
+      const record = JSON.parse(chunk.toString("utf8"));
+      if (record.requestId === safeId) return flattenResult(record);
+    } catch {
+      // Segment removed by retention, or the offset no longer matches: try an older entry
+    }
+  }
+  return null;
+}
+
+/**
+ * Requests the mod has not finished: waiting in incoming/ or claimed.
+ *
+ * @param {string} queue
+ * @returns {Promise<object[]>} oldest first, each with `spoolState` "incoming" or "processing"
+ */
+export async function listSpoolPending(queue) {
+  const pending = [];
+  for (const stage of ["processing", "incoming"]) {
+    const folder = queueFolder(queue, stage);
+    for (const name of (await listJson(folder)).sort()) {
+      try {
+        pending.push({ ...(await readSpoolFile(folder, name)), spoolState: stage });
+      } catch {
+        // Claimed or finished between the listing and the read
+      }
+    }
+  }
+  return pending;
+}
+
+/**
+ * Spool results followed by those in the results file the mod wrote before
+ * the spool (still written for requests left in the old queue file).
+ *
+ * @param {string} queue
+ * @param {string} legacyResultsFile - e.g. {API_PATH}/item_grants_results.json
+ * @param {{ limit?: number }} options
+ * @returns {Promise<object[]>}
+ */
+export async function readQueueResults(queue, legacyResultsFile, { limit = 50 } = {}) {
+  const results = await readSpoolResults(queue, { limit });
+  try {
+    const legacy = JSON.parse(await readFile(legacyResultsFile, "utf8"));
+    results.push(...(legacy.requests || []));
+  } catch {}
+  return results;
+}
@@ -0,0 +1,36 @@
+/**
+ * @file timestamps.js
+ * @description Numeric event times for records written by the mod
+ *
+ * Mod records carry an ISO string ("timestamp") and, since SST_Clock, the same
+ * time as epoch seconds ("timestampUnix"). Sorting and filtering large event
+ * lists on the number avoids a Date parse per comparison. Records from older
+ * mod versions (and archived rows) only have the string, which is parsed once.
+ *
+ * EXPORTS:
+ * - eventTime(record, field)  - Epoch milliseconds of record[field] (0 if unknown)
+ * - newestFirst(a, b)         - Array.sort comparator on eventTime, descending
+ */
+
+/**
+ * Epoch milliseconds of a record's timestamp field
+ * @param {object} record - Event record (trade, life event, purchase, ...)
+ * @param {string} field - Name of the ISO string field; the numeric one is `${field}Unix`
+ * @returns {number}
+ */
+export function eventTime(record, field = "timestamp") {
+  if (!record) return 0;
+
+  const unix = record[`${field}Unix`];
+  if (typeof unix === "number" && unix > 0) return unix * 1000;
+
+  const parsed = Date.parse(record[field]);
+  return Number.isNaN(parsed) ? 0 : parsed;
+}
+
+/**
+ * Sort comparator: newest record first
+ */
+export function newestFirst(a, b) {
+  return eventTime(b) - eventTime(a);
+}
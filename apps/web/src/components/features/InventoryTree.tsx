@@ -157,7 +157,7 @@ interface InventoryItemRowProps {
   depth?: number;
   itemPath?: string;
   onGrant?: (className: string) => void;
-  onDelete?: (className: string, itemPath: string, displayName: string) => void;
+  onDelete?: (className: string, itemPath: string, displayName: string, itemId?: string) => void;
 }
 
 export const InventoryItemRow: React.FC<InventoryItemRowProps> = ({ 
@@ -312,7 +312,7 @@ export const InventoryItemRow: React.FC<InventoryItemRowProps> = ({
             size="sm"
             onClick={(e) => {
               e.stopPropagation();
-              onDelete(item.className, itemPath, item.displayName || item.className);
+              onDelete(item.className, itemPath, item.displayName || item.className, item.itemId);
             }}
             className="text-xs px-2 py-1 text-red-500 hover:text-red-700 hover:bg-red-50"
           >
@@ -364,7 +364,7 @@ export const InventoryItemRow: React.FC<InventoryItemRowProps> = ({
 interface InventoryTreeProps {
   items: InventoryItem[];
   onGrant?: (className: string) => void;
-  onDelete?: (className: string, itemPath: string, displayName: string) => void;
+  onDelete?: (className: string, itemPath: string, displayName: string, itemId?: string) => void;
 }
 
 export const InventoryTree: React.FC<InventoryTreeProps> = ({ items, onGrant, onDelete }) => {
@@ -319,13 +319,11 @@ export const PlayerDashboard: React.FC<PlayerDashboardProps> = ({ isConnected })
                 </tr>
               </thead>
               <tbody>
-                {dashboard.players && Object.entries(dashboard.players).map(([playerId, playerData]) => {
-                  // Get inventory count from the nested structure
-                  const invData = playerData.inventory?.players?.[0];
-                  const invCount = invData?.inventory?.length || 0;
-                  const playerName = invData?.playerName || playerId.substring(0, 12) + '...';
-                  const eventCount = playerData.events?.events?.length || 0;
-                  const lifeEventCount = playerData.lifeEvents?.events?.length || 0;
+                {dashboard.players && Object.entries(dashboard.players).map(([playerId, summary]) => {
+                  const invCount = summary.inventoryCount;
+                  const playerName = summary.playerName || playerId.substring(0, 12) + '...';
+                  const eventCount = summary.eventCount;
+                  const lifeEventCount = summary.lifeEventCount;
                   
                   return (
                     <tr 
@@ -204,7 +204,7 @@ export const PlayerManager: React.FC<PlayerManagerProps> = ({ isConnected }) =>
 
   // Item delete state
   const [showDeleteConfirm, setShowDeleteConfirm] = useState(false);
-  const [deleteTarget, setDeleteTarget] = useState<{ className: string; itemPath: string; displayName: string } | null>(null);
+  const [deleteTarget, setDeleteTarget] = useState<{ className: string; itemPath: string; displayName: string; itemId?: string } | null>(null);
   const [deleting, setDeleting] = useState(false);
   const [deleteMessage, setDeleteMessage] = useState<{ type: 'success' | 'error'; text: string } | null>(null);
 
@@ -323,8 +323,8 @@ export const PlayerManager: React.FC<PlayerManagerProps> = ({ isConnected }) =>
   };
 
   // Open delete confirmation
-  const openDeleteConfirm = (className: string, itemPath: string, displayName: string) => {
-    setDeleteTarget({ className, itemPath, displayName });
+  const openDeleteConfirm = (className: string, itemPath: string, displayName: string, itemId?: string) => {
+    setDeleteTarget({ className, itemPath, displayName, itemId });
     setDeleteMessage(null);
     setShowDeleteConfirm(true);
   };
@@ -340,6 +340,7 @@ export const PlayerManager: React.FC<PlayerManagerProps> = ({ isConnected }) =>
       const response = await deleteItemFromPlayer(selectedPlayerId, {
         itemClassName: deleteTarget.className,
         itemPath: deleteTarget.itemPath,
+        itemId: deleteTarget.itemId,
       });
 
       setDeleteMessage({
@@ -472,12 +473,11 @@ export const PlayerManager: React.FC<PlayerManagerProps> = ({ isConnected }) =>
   const getPlayerList = (): PlayerSummary[] => {
     if (!dashboard?.players) return [];
     
-    return Object.entries(dashboard.players).map(([playerId, playerData]) => {
-      const invData = playerData.inventory?.players?.[0];
-      const invCount = invData?.inventory?.length || 0;
-      const playerName = invData?.playerName || 'Unknown Survivor';
-      const eventCount = playerData.events?.events?.length || 0;
-      const lifeEventCount = playerData.lifeEvents?.events?.length || 0;
+    return Object.entries(dashboard.players).map(([playerId, summary]) => {
+      const invCount = summary.inventoryCount;
+      const playerName = summary.playerName || 'Unknown Survivor';
+      const eventCount = summary.eventCount;
+      const lifeEventCount = summary.lifeEventCount;
       
       // Find online data for this player
       const onlineData = onlinePlayers.find(p => p.playerId === playerId);
@@ -659,8 +659,8 @@ export const PlayerManager: React.FC<PlayerManagerProps> = ({ isConnected }) =>
                     setItemClassName(className);
                     setActiveTab('grant');
                   }}
-                  onDelete={(className, itemPath, displayName) => {
-                    openDeleteConfirm(className, itemPath, displayName);
+                  onDelete={(className, itemPath, displayName, itemId) => {
+                    openDeleteConfirm(className, itemPath, displayName, itemId);
                   }}
                 />
               ) : (
@@ -714,7 +714,10 @@ export const PlayerManager: React.FC<PlayerManagerProps> = ({ isConnected }) =>
                       >
                         {eventIcon}
                         <span className="text-sm font-medium text-surface-800 truncate flex-1">
-                          {event.itemClassName}
+                          {event.eventType === 'SUPPRESSED' ? 'Rate limited' : event.itemClassName}
+                          {(event.count ?? 1) > 1 && (
+                            <span className="ml-1 text-xs text-surface-500">×{event.count}</span>
+                          )}
                         </span>
                         <span className="text-xs text-surface-500">
                           {formatEventQuantity(event.itemClassName || '', event.itemQuantity || 1)}
@@ -613,7 +613,13 @@ export const VehicleDashboard: React.FC<VehicleDashboardProps> = ({ isConnected
                     {selectedVehicle.lastUpdateTime && (
                       <div className="text-xs text-surface-500 mt-1">
                         <Clock size={10} className="inline mr-1" />
-                        Updated: {formatTime(selectedVehicle.lastUpdateTime)}
+                        Moved: {formatTime(selectedVehicle.lastUpdateTime)}
+                      </div>
+                    )}
+                    {selectedVehicle.lastSeenTime && (
+                      <div className="text-xs text-surface-500 mt-1">
+                        <Clock size={10} className="inline mr-1" />
+                        Last seen: {formatTime(selectedVehicle.lastSeenTime)}
                       </div>
                     )}
                   </div>
@@ -49,6 +49,9 @@ import type {
   GrantRequest,
   GrantResponse,
   GrantResult,
+  KitGrantRequest,
+  KitGrantResponse,
+  KitGrantResult,
   ItemDeleteRequest,
   ItemDeleteResponse,
   ItemDeleteResultsResponse,
@@ -297,6 +300,16 @@ class SstApi {
     return response.data;
   }
 
+  async createKitGrant(kit: KitGrantRequest): Promise<KitGrantResponse> {
+    const response = await this.client.post<KitGrantResponse>('/grants/kit', kit);
+    return response.data;
+  }
+
+  async getKitGrantResults(limit = 50): Promise<{ requests: KitGrantResult[] }> {
+    const response = await this.client.get<{ requests: KitGrantResult[] }>('/grants/kit/results', { params: { limit } });
+    return response.data;
+  }
+
   // Item Delete endpoints
   async deleteItemFromPlayer(playerId: string, request: Omit<ItemDeleteRequest, 'playerId'>): Promise<ItemDeleteResponse> {
     const response = await this.client.delete<ItemDeleteResponse>(`/inventory/${playerId}/item`, {
@@ -539,7 +552,7 @@ class SstApi {
     return response.data;
   }
 
-  async getVehiclePurchases(params?: { ownerId?: string; className?: string; limit?: number }): Promise<VehiclePurchasesResponse> {
+  async getVehiclePurchases(params?: { ownerId?: string; className?: string; limit?: number; cursor?: string }): Promise<VehiclePurchasesResponse> {
     const response = await this.client.get<VehiclePurchasesResponse>('/vehicles/purchases/all', { params });
     return response.data;
   }
@@ -601,6 +614,8 @@ export const getItem = (className: string) => api.getItem(className);
 export const getInventoryCounts = () => api.getInventoryCounts();
 export const refreshInventoryCounts = () => api.refreshInventoryCounts();
 export const createGrant = (grant: GrantRequest) => api.createGrant(grant);
+export const createKitGrant = (kit: KitGrantRequest) => api.createKitGrant(kit);
+export const getKitGrantResults = (limit?: number) => api.getKitGrantResults(limit);
 export const getGrantResults = () => api.getGrantResults();
 export const getOnlinePlayers = () => api.getOnlinePlayers();
 export const getActiveOnlinePlayers = () => api.getActiveOnlinePlayers();
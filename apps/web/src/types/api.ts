@@ -47,6 +47,7 @@ export interface ServerConfig {
 }
 
 export interface InventoryItem {
+  itemId?: string;
   className: string;
   displayName?: string;
   quantity: number;
@@ -79,6 +80,7 @@ export interface PlayerEvent {
   itemHealth?: number;
   itemQuantity?: number;
   position?: number[];
+  count?: number;
 }
 
 export interface PlayerEventsLog {
@@ -233,8 +235,16 @@ export interface PlayerData {
   lifeEvents: LifeEventsLog | null;
 }
 
+// One row of the dashboard player list; full data comes from GET /dashboard/player/:id
+export interface DashboardPlayerSummary {
+  playerName: string | null;
+  inventoryCount: number;
+  eventCount: number;
+  lifeEventCount: number;
+}
+
 export interface DashboardResponse {
-  players: Record<string, PlayerData>;
+  players: Record<string, DashboardPlayerSummary>;
   grantResults: GrantResult[];
   recentDeaths: LifeEvent[];
   lastUpdate: string;
@@ -284,11 +294,52 @@ export interface GrantResponse {
   grant: GrantRequest;
 }
 
+// Kit grants: several items (with nested attachments/cargo) for several players
+export interface KitItem {
+  itemClassName: string;
+  quantity?: number;
+  health?: number;
+  attachments?: KitItem[];
+  cargo?: KitItem[];
+}
+
+export interface KitGrantRequest {
+  kitName?: string;
+  playerIds: string[] | 'all';
+  items: KitItem[];
+}
+
+export interface KitGrantPlayerResult {
+  playerId: string;
+  playerName: string;
+  result: 'SUCCESS' | 'PARTIAL' | 'FAILED' | 'PLAYER_NOT_FOUND';
+  granted: number;
+  dropped: number;
+  failed: string[];
+}
+
+export interface KitGrantResult {
+  requestId: string;
+  kitName: string;
+  playerIds: string[];
+  processed: boolean;
+  result: string;
+  invalidClasses: string[];
+  players: KitGrantPlayerResult[];
+  queuedAt: string | null;
+}
+
+export interface KitGrantResponse {
+  status: string;
+  kit: KitGrantRequest & { requestId: string };
+}
+
 // Item Delete Types
 export interface ItemDeleteRequest {
   playerId: string;
   itemClassName: string;
-  itemPath: string;
+  itemPath?: string;
+  itemId?: string;
   deleteCount?: number;
 }
 
@@ -300,6 +351,7 @@ export interface ItemDeleteResponse {
     playerId: string;
     itemClassName: string;
     itemPath: string;
+    itemId?: string;
     deleteCount: number;
     requestedAt: string;
     processed: boolean;
@@ -313,6 +365,7 @@ export interface ItemDeleteResult {
   playerId: string;
   itemClassName: string;
   itemPath: string;
+  itemId?: string;
   deleteCount: number;
   requestedAt: string;
   processed: boolean;
@@ -363,6 +416,7 @@ export interface OnlinePlayerData {
   energy: number;
   isAlive: boolean;
   isUnconscious: boolean;
+  inVehicle?: boolean;
 }
 
 export interface OnlinePlayersResponse {
@@ -734,7 +788,8 @@ export interface TrackedVehicle {
   traderZone?: string;
   purchasePrice?: number;
   lastPosition?: number[];
-  lastUpdateTime?: string;
+  lastUpdateTime?: string;     // Last move past the tracker's threshold or ruined state change
+  lastSeenTime?: string;       // Last time the tracker found the vehicle loaded (up to 5 minutes old)
   isDestroyed: boolean | number;
   keyData?: VehicleKeyData;           // Original key
   additionalKeys?: VehicleKeyData[];  // Additional keys generated
@@ -777,6 +832,7 @@ export interface VehiclePurchasesResponse {
   purchases: VehiclePurchase[];
   count: number;
   totalPurchases?: number;
+  nextCursor?: string | null;  // Pass back as `cursor` for the next (older) page
 }
 
 export interface VehiclePositionsResponse {